@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "BaseDeviceInterface.hpp"
+#include "FakeEspMatter.hpp"
+#include <esp_log.h>
+#include <esp_matter.h>
+
+/**
+ * @brief Shared helpers for the host benchmarks.
+ */
+namespace bench {
+
+/**
+ * @brief Per-operation figures of one benchmark case.
+ */
+struct Result
+{
+    double nsPerOp;
+    double lookupsPerOp;
+    double locksPerOp;
+    double reportsPerOp;
+    double nvsWritesPerOp;
+};
+
+/**
+ * @brief Attribute callback equivalent to app_attribute_cb in main.cpp.
+ */
+inline esp_err_t attributeCallback(esp_matter::attribute::callback_type_t type, uint16_t endpointId, uint32_t clusterId,
+                                   uint32_t attributeId, esp_matter_attr_val_t * val, void * privData)
+{
+    if (type == esp_matter::attribute::POST_UPDATE && privData != nullptr)
+    {
+        BaseDeviceInterface * device = static_cast<BaseDeviceInterface *>(privData);
+        device->getStats().markCommand(DeviceStats::now());
+        device->updateAccessory(endpointId, clusterId, attributeId, val);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Creates the node and the aggregator endpoint, like app_main does.
+ *
+ * @return The aggregator endpoint devices are bridged under.
+ */
+inline esp_matter::endpoint_t * createBridge()
+{
+    esp_matter_fake::reset();
+    esp_matter::node::config_t nodeConfig;
+    esp_matter::node_t * node = esp_matter::node::create(&nodeConfig, attributeCallback, nullptr);
+    esp_matter::endpoint::aggregator::config_t aggregatorConfig;
+    return esp_matter::endpoint::aggregator::create(node, &aggregatorConfig, esp_matter::ENDPOINT_FLAG_NONE, nullptr);
+}
+
+/**
+ * @brief Returns the iteration count from argv[1], or the given default.
+ */
+inline uint32_t iterationsFromArgs(int argc, char ** argv, uint32_t defaultIterations)
+{
+    if (argc > 1)
+    {
+        long value = strtol(argv[1], nullptr, 10);
+        if (value > 0)
+        {
+            return static_cast<uint32_t>(value);
+        }
+    }
+    return defaultIterations;
+}
+
+/**
+ * @brief Times `iterations` calls of `op` and returns per-operation figures.
+ *
+ * `prepare` runs before every call and is timed separately, so its cost is subtracted from the result.
+ */
+inline Result run(uint32_t iterations, const std::function<void(uint32_t)> & prepare, const std::function<void(uint32_t)> & op)
+{
+    using Clock = std::chrono::steady_clock;
+
+    /* Warm up caches and branch predictors */
+    for (uint32_t i = 0; i < iterations / 10 + 1; i++)
+    {
+        prepare(i);
+        op(i);
+    }
+
+    Clock::time_point start = Clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        prepare(i);
+    }
+    double prepareNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    esp_matter_fake::resetCounters();
+    start = Clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        prepare(i);
+        op(i);
+    }
+    double totalNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    const esp_matter_fake::Counters & counters = esp_matter_fake::counters();
+    Result result;
+    result.nsPerOp        = (totalNs - prepareNs) / iterations;
+    result.lookupsPerOp   = static_cast<double>(counters.lookups()) / iterations;
+    result.locksPerOp     = static_cast<double>(counters.lockAcquisitions) / iterations;
+    result.reportsPerOp   = static_cast<double>(counters.reports) / iterations;
+    result.nvsWritesPerOp = static_cast<double>(counters.nvsWrites) / iterations;
+    return result;
+}
+
+inline void printHeader()
+{
+    printf("%-18s %-18s %10s %12s %10s %12s %10s\n", "device", "operation", "ns/op", "lookups/op", "locks/op", "reports/op",
+           "nvs/op");
+}
+
+inline void printResult(const char * device, const char * operation, const Result & result)
+{
+    printf("%-18s %-18s %10.1f %12.2f %10.2f %12.2f %10.2f\n", device, operation, result.nsPerOp, result.lookupsPerOp,
+           result.locksPerOp, result.reportsPerOp, result.nvsWritesPerOp);
+}
+
+} // namespace bench
@@ -0,0 +1,226 @@
+/**
+ * @brief Host equivalent of the boot profile: construction cost of every device class and of N-device bridges.
+ *
+ * The first table builds one device of each class on a fresh bridge and reports what its constructor costs:
+ * time, non-volatile attributes esp_matter loads from NVS and data model lookups. The second replays the
+ * data model part of app_main (node, aggregator, esp_matter::start, N devices) with the BootProfiler marks
+ * of main.cpp and reports the median time of each phase. The profile of the last 30-device boot is printed
+ * the way `matter device boot` prints it on target.
+ *
+ * Host times leave out flash reads and the Matter stack start, so compare them between changes rather than
+ * with a target boot.
+ *
+ * Usage: device_boot_bench [boots]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "BootProfiler.hpp"
+#include "DeviceRegistry.hpp"
+#include "EndpointIdMap.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr size_t DEVICE_COUNT    = 30;
+constexpr uint8_t RELAY_CHANNELS = 8;
+
+using Clock = std::chrono::steady_clock;
+
+/* One device of every class, filling every pool of the default configuration */
+struct Accessories
+{
+    FakeButtonAccessory buttons[4];
+    FakeDoorLockAccessory doorLocks[2];
+    FakeFanAccessory fans[2];
+    FakeLightAccessory lights[8];
+    FakePluginAccessory relayChannels[RELAY_CHANNELS];
+    FakePluginAccessory plugins[8];
+    FakeTVLifterAccessory tvLifter;
+    FakeBlindAccessory windows[4];
+    BaseAccessoryInterface * relayChannelAccessories[RELAY_CHANNELS];
+};
+
+/* Interleaves the classes, so the first N descriptors are a mixed bridge */
+void fillDescriptors(Accessories & accessories, DeviceDescriptor (&descriptors)[DEVICE_COUNT])
+{
+    for (uint8_t channel = 0; channel < RELAY_CHANNELS; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+
+    size_t count = 0;
+    auto add     = [&](DeviceType type, BaseAccessoryInterface * accessory) {
+        descriptors[count] = { static_cast<uint16_t>(count + 1), type, "Device", accessory, nullptr, 0 };
+        count++;
+    };
+
+    for (size_t i = 0; i < 8; i++)
+    {
+        add(DeviceType::LIGHT, &accessories.lights[i]);
+        add(DeviceType::PLUGIN, &accessories.plugins[i]);
+        if (i < 4)
+        {
+            add(DeviceType::BUTTON, &accessories.buttons[i]);
+            add(DeviceType::WINDOW, &accessories.windows[i]);
+        }
+        if (i < 2)
+        {
+            add(DeviceType::DOOR_LOCK, &accessories.doorLocks[i]);
+            add(DeviceType::FAN, &accessories.fans[i]);
+        }
+    }
+    add(DeviceType::TV_LIFTER, &accessories.tvLifter);
+    add(DeviceType::MULTI_PLUGIN, nullptr);
+    descriptors[count - 1].channelAccessories = accessories.relayChannelAccessories;
+    descriptors[count - 1].channelCount       = RELAY_CHANNELS;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+struct ClassCost
+{
+    double nsPerDevice; /**< Median constructor time. */
+    uint64_t nvsReads;  /**< Non-volatile attributes loaded. */
+    uint64_t lookups;   /**< Data model lookups. */
+    uint16_t endpoints; /**< Endpoints the device added. */
+};
+
+ClassCost measureClass(const DeviceDescriptor & descriptor, uint32_t boots)
+{
+    ClassCost cost{};
+    std::vector<double> times;
+    for (uint32_t i = 0; i < boots; i++)
+    {
+        DeviceRegistry registry(bench::createBridge());
+        uint16_t endpointsBefore = esp_matter_fake::endpointCount();
+        esp_matter_fake::resetCounters();
+
+        Clock::time_point start = Clock::now();
+        registry.createDevices(&descriptor, 1);
+        times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+
+        cost.nvsReads  = esp_matter_fake::counters().nvsReads;
+        cost.lookups   = esp_matter_fake::counters().lookups();
+        cost.endpoints = esp_matter_fake::endpointCount() - endpointsBefore;
+    }
+    cost.nsPerDevice = median(times);
+    return cost;
+}
+
+/* Phases between two marks of one profiled boot */
+struct BootPhases
+{
+    double nodeUs;    /**< APP_START to NODE_CREATED. */
+    double startUs;   /**< AGGREGATOR_CREATED to MATTER_STARTED. */
+    double devicesUs; /**< MATTER_STARTED to DEVICES_CREATED. */
+    double totalUs;   /**< APP_START to DEVICES_CREATED. */
+};
+
+/* The data model part of app_main, with its BootProfiler marks */
+BootPhases profiledBoot(const DeviceDescriptor * descriptors, size_t count)
+{
+    BootProfiler::begin();
+    BootProfiler::mark(BootProfiler::APP_START);
+
+    // A reboot keeps the stored endpoint ids, so the devices are resumed as on target
+    esp_matter_fake::reboot();
+    esp_matter::node::config_t nodeConfig;
+    esp_matter::node_t * node = esp_matter::node::create(&nodeConfig, bench::attributeCallback, nullptr);
+    BootProfiler::mark(BootProfiler::NODE_CREATED);
+
+    esp_matter::endpoint::aggregator::config_t aggregatorConfig;
+    esp_matter::endpoint_t * aggregator =
+        esp_matter::endpoint::aggregator::create(node, &aggregatorConfig, esp_matter::ENDPOINT_FLAG_NONE, nullptr);
+    BootProfiler::mark(BootProfiler::AGGREGATOR_CREATED);
+
+    esp_matter::start(nullptr);
+    BootProfiler::mark(BootProfiler::MATTER_STARTED);
+
+    EndpointIdMap::load();
+    DeviceRegistry registry(aggregator);
+    registry.createDevices(descriptors, count);
+    BootProfiler::mark(BootProfiler::DEVICES_CREATED);
+
+    BootProfiler::Record records[CONFIG_D_M_BOOT_PROFILER_RECORDS];
+    size_t recordCount                     = BootProfiler::records(records, CONFIG_D_M_BOOT_PROFILER_RECORDS);
+    uint32_t at[BootProfiler::PHASE_COUNT] = {};
+    for (size_t i = 0; i < recordCount; i++)
+    {
+        at[records[i].phase] = records[i].timeUs;
+    }
+
+    BootPhases phases;
+    phases.nodeUs    = at[BootProfiler::NODE_CREATED] - at[BootProfiler::APP_START];
+    phases.startUs   = at[BootProfiler::MATTER_STARTED] - at[BootProfiler::AGGREGATOR_CREATED];
+    phases.devicesUs = at[BootProfiler::DEVICES_CREATED] - at[BootProfiler::MATTER_STARTED];
+    phases.totalUs   = at[BootProfiler::DEVICES_CREATED] - at[BootProfiler::APP_START];
+    return phases;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t boots = bench::iterationsFromArgs(argc, argv, 200);
+
+    Accessories accessories;
+    DeviceDescriptor descriptors[DEVICE_COUNT];
+    fillDescriptors(accessories, descriptors);
+
+    printf("Device construction host benchmark, %u boots per case\n\n", boots);
+    printf("%-12s %12s %10s %10s %10s\n", "class", "ns/device", "nvs reads", "lookups", "endpoints");
+    static const char * const TYPE_NAMES[] = {
+        "Button", "DoorLock", "Fan", "Light", "MultiPlugin", "Plugin", "TVLifter", "Window",
+    };
+    for (uint8_t type = 0; type <= static_cast<uint8_t>(DeviceType::WINDOW); type++)
+    {
+        const DeviceDescriptor * descriptor =
+            std::find_if(descriptors, descriptors + DEVICE_COUNT,
+                         [type](const DeviceDescriptor & candidate) { return static_cast<uint8_t>(candidate.type) == type; });
+        ClassCost cost = measureClass(*descriptor, boots);
+        printf("%-12s %12.0f %10u %10u %10u\n", TYPE_NAMES[type], cost.nsPerDevice, (unsigned) cost.nvsReads,
+               (unsigned) cost.lookups, (unsigned) cost.endpoints);
+    }
+
+    // Without the profiler the marks record nothing
+    profiledBoot(descriptors, 0);
+    BootProfiler::Record probe;
+    if (BootProfiler::records(&probe, 1) == 0)
+    {
+        printf("\nBoot profiler is disabled, enable CONFIG_D_M_BOOT_PROFILER\n");
+        return 0;
+    }
+
+    printf("\n%-8s %10s %10s %12s %10s %10s\n", "devices", "node us", "devices us", "us/device", "start us", "total us");
+    for (size_t count : { 1, 2, 5, 10, 20, 30 })
+    {
+        std::vector<double> nodeUs;
+        std::vector<double> devicesUs;
+        std::vector<double> startUs;
+        std::vector<double> totalUs;
+        for (uint32_t i = 0; i < boots; i++)
+        {
+            BootPhases phases = profiledBoot(descriptors, count);
+            nodeUs.push_back(phases.nodeUs);
+            devicesUs.push_back(phases.devicesUs);
+            startUs.push_back(phases.startUs);
+            totalUs.push_back(phases.totalUs);
+        }
+        printf("%-8u %10.0f %10.0f %12.2f %10.0f %10.0f\n", (unsigned) count, median(nodeUs), median(devicesUs),
+               median(devicesUs) / count, median(startUs), median(totalUs));
+    }
+
+    printf("\n");
+    BootProfiler::print();
+    printf("\nns/device and nvs reads per class are for one device; us columns are medians of BootProfiler marks\n");
+    return 0;
+}
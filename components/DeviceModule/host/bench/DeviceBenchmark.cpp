@@ -0,0 +1,239 @@
+/**
+ * @brief Micro-benchmark of the per-device hot paths on the host fake.
+ *
+ * Every device class is bridged under one aggregator, as in app_main, and driven through
+ * updateAccessory (a Matter write reaching the device) and reportEndpoint (an accessory
+ * state change reaching Matter). For each case the benchmark prints ns/op together with
+ * the data model lookups, chip-stack lock acquisitions, reports and NVS writes per op.
+ *
+ * Usage: device_module_bench [iterations]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "ButtonDevice.hpp"
+#include "DoorLockDevice.hpp"
+#include "FanDevice.hpp"
+#include "LightDevice.hpp"
+#include "MultiPluginDevice.hpp"
+#include "PluginDevice.hpp"
+#include "TVLifterDevice.hpp"
+#include "WindowDevice.hpp"
+
+using namespace chip::app::Clusters;
+
+namespace {
+
+/* Endpoint ids are handed out sequentially, so the next id is the current endpoint count */
+uint16_t nextEndpointId()
+{
+    return esp_matter_fake::endpointCount();
+}
+
+void noPrepare(uint32_t) {}
+
+/* Matter writes reach devices through the base interface, with the written value, as in app_attribute_cb */
+BaseDeviceInterface & asBase(BaseDeviceInterface & device)
+{
+    return device;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t iterations = bench::iterationsFromArgs(argc, argv, 20000);
+
+    esp_matter::endpoint_t * aggregator = bench::createBridge();
+
+    FakeLightAccessory lightAccessory;
+    uint16_t lightEndpoint = nextEndpointId();
+    LightDevice light(const_cast<char *>("Light"), &lightAccessory, aggregator);
+
+    FakePluginAccessory pluginAccessory;
+    uint16_t pluginEndpoint = nextEndpointId();
+    PluginDevice plugin(const_cast<char *>("Plugin"), &pluginAccessory, aggregator);
+
+    FakeFanAccessory fanAccessory;
+    uint16_t fanEndpoint = nextEndpointId();
+    FanDevice fan("Fan", &fanAccessory, aggregator);
+
+    FakeDoorLockAccessory doorLockAccessory;
+    uint16_t doorLockEndpoint = nextEndpointId();
+    DoorLockDevice doorLock(const_cast<char *>("DoorLock"), &doorLockAccessory, aggregator);
+
+    FakeBlindAccessory blindAccessory;
+    uint16_t windowEndpoint = nextEndpointId();
+    WindowDevice window("Window", &blindAccessory, aggregator);
+
+    FakeButtonAccessory buttonAccessory;
+    ButtonDevice button(const_cast<char *>("Button"), &buttonAccessory, aggregator);
+
+    FakeTVLifterAccessory tvLifterAccessory;
+    uint16_t tvLifterEndpoint = nextEndpointId();
+    TVLifterDevice tvLifter(const_cast<char *>("TVLifter"), &tvLifterAccessory, aggregator);
+
+    FakePluginAccessory relayAccessories[8];
+    PluginAccessoryInterface * relayChannels[8];
+    for (uint8_t channel = 0; channel < 8; channel++)
+    {
+        relayChannels[channel] = &relayAccessories[channel];
+    }
+    uint16_t relayEndpoint = nextEndpointId();
+    MultiPluginDevice relay("Relay", relayChannels, 8, aggregator);
+
+    esp_matter::start(nullptr);
+
+    printf("DeviceModule host benchmark, %u iterations per case\n\n", iterations);
+    bench::printHeader();
+
+    bench::printResult("LightDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(lightEndpoint, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                               esp_matter_bool(i & 1));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_bool(i & 1);
+                               asBase(light).updateAccessory(lightEndpoint, OnOff::Id, OnOff::Attributes::OnOff::Id, &val);
+                           }));
+    bench::printResult("LightDevice", "updateAccessory(r)",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(lightEndpoint, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                               esp_matter_bool(i & 1));
+                           },
+                           [&](uint32_t) { asBase(light).updateAccessory(OnOff::Attributes::OnOff::Id, lightEndpoint); }));
+    bench::printResult("LightDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t) { lightAccessory.toggle(); }));
+    bench::printResult("LightDevice", "reportEndpoint(=)",
+                       bench::run(iterations, noPrepare, [&](uint32_t) { lightAccessory.report(); }));
+
+    bench::printResult("PluginDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(pluginEndpoint, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                               esp_matter_bool(i & 1));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_bool(i & 1);
+                               asBase(plugin).updateAccessory(pluginEndpoint, OnOff::Id, OnOff::Attributes::OnOff::Id, &val);
+                           }));
+    bench::printResult("PluginDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t) { pluginAccessory.toggle(); }));
+
+    bench::printResult("FanDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(fanEndpoint, FanControl::Id,
+                                                               FanControl::Attributes::PercentSetting::Id,
+                                                               esp_matter_nullable_uint8((i & 1) ? 100 : 0));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_nullable_uint8((i & 1) ? 100 : 0);
+                               asBase(fan).updateAccessory(fanEndpoint, FanControl::Id, FanControl::Attributes::PercentSetting::Id,
+                                                           &val);
+                           }));
+    bench::printResult("FanDevice", "reportEndpoint", bench::run(iterations, noPrepare, [&](uint32_t) { fanAccessory.toggle(); }));
+
+    bench::printResult(
+        "DoorLockDevice", "updateAccessory",
+        bench::run(
+            iterations,
+            [&](uint32_t i) {
+                esp_matter_fake::storeAttribute(
+                    doorLockEndpoint, DoorLock::Id, DoorLock::Attributes::LockState::Id,
+                    esp_matter_nullable_enum8(static_cast<uint8_t>((i & 1) ? DoorLock::DlLockState::kLocked
+                                                                           : DoorLock::DlLockState::kUnlocked)));
+            },
+            [&](uint32_t i) {
+                esp_matter_attr_val_t val = esp_matter_nullable_enum8(
+                    static_cast<uint8_t>((i & 1) ? DoorLock::DlLockState::kLocked : DoorLock::DlLockState::kUnlocked));
+                asBase(doorLock).updateAccessory(doorLockEndpoint, DoorLock::Id, DoorLock::Attributes::LockState::Id, &val);
+            }));
+    bench::printResult("DoorLockDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t) { doorLockAccessory.toggle(); }));
+
+    bench::printResult("WindowDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(windowEndpoint, WindowCovering::Id,
+                                                               WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
+                                                               esp_matter_nullable_uint16((i % 101) * 100));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_nullable_uint16((i % 101) * 100);
+                               asBase(window).updateAccessory(windowEndpoint, WindowCovering::Id,
+                                                              WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
+                                                              &val);
+                           }));
+    bench::printResult("WindowDevice", "reportEndpoint",
+                       bench::run(
+                           iterations, [&](uint32_t i) { blindAccessory.setPositions(i % 100, 100); },
+                           [&](uint32_t) { blindAccessory.report(false); }));
+    bench::printResult("WindowDevice", "reportEndpoint(c)",
+                       bench::run(
+                           iterations, [&](uint32_t i) { blindAccessory.setPositions(i % 100, 100); },
+                           [&](uint32_t) { asBase(window).reportEndpoint(false, WindowDevice::CURRENT_POSITION); }));
+    bench::printResult("WindowDevice", "reportEndpoint(=)",
+                       bench::run(
+                           iterations, [&](uint32_t) { blindAccessory.setPositions(40, 40); },
+                           [&](uint32_t) { blindAccessory.report(false); }));
+    bench::printResult("WindowDevice", "reportEndpoint(s)",
+                       bench::run(
+                           iterations, [&](uint32_t i) { blindAccessory.setPositions(i % 100, 100); },
+                           [&](uint32_t) { blindAccessory.report(true); }));
+
+    bench::printResult("ButtonDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t i) {
+                           buttonAccessory.press((i & 1) ? StatelessButtonAccessoryInterface::PressType::LongPress
+                                                         : StatelessButtonAccessoryInterface::PressType::SinglePress);
+                       }));
+
+    bench::printResult("TVLifterDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(tvLifterEndpoint + i % 3, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                               esp_matter_bool(true));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_bool(true);
+                               asBase(tvLifter).updateAccessory(tvLifterEndpoint + i % 3, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                                &val);
+                           }));
+    bench::printResult("TVLifterDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t) { tvLifterAccessory.report(); }));
+
+    bench::printResult("MultiPluginDevice", "updateAccessory",
+                       bench::run(
+                           iterations,
+                           [&](uint32_t i) {
+                               esp_matter_fake::storeAttribute(relayEndpoint + i % 8, OnOff::Id, OnOff::Attributes::OnOff::Id,
+                                                               esp_matter_bool((i / 8) & 1));
+                           },
+                           [&](uint32_t i) {
+                               esp_matter_attr_val_t val = esp_matter_bool((i / 8) & 1);
+                               asBase(relay).updateAccessory(relayEndpoint + i % 8, OnOff::Id, OnOff::Attributes::OnOff::Id, &val);
+                           }));
+    bench::printResult("MultiPluginDevice", "reportEndpoint",
+                       bench::run(iterations, noPrepare, [&](uint32_t i) { relayAccessories[i % 8].toggle(); }));
+    bench::printResult("MultiPluginDevice", "reportEndpoint(a)",
+                       bench::run(
+                           iterations, [&](uint32_t i) { relayAccessories[i % 8].setPower(!relayAccessories[i % 8].getPower()); },
+                           [&](uint32_t) { asBase(relay).reportEndpoint(false); }));
+
+    printf("\n(=) = report of an unchanged accessory state\n");
+    printf("(r) = update through the read-back overload, without the written value\n");
+    printf("(c) = report with a change mask naming only the current position\n");
+    printf("(a) = report of all channels of a device, one of them changed\n");
+    printf("(s) = onlySave report, as sent by the blind motor task while moving\n");
+    return 0;
+}
@@ -0,0 +1,264 @@
+/**
+ * @brief Endpoint ids of a bridge across firmware updates, with and without the EndpointIdMap.
+ *
+ * Every step reboots the fake bridge with an edited descriptor table, the way a firmware update edits the
+ * table of app_main, and counts the endpoints whose id differs from the previous boot. A moved endpoint is one
+ * controllers re-read the PartsList for, and whose bindings and subscriptions they rebuild. "created first"
+ * creates the devices before esp_matter::start, as app_main did before the map: ids follow the table order.
+ * "map" creates them on the started stack, which resumes the ids stored in the map.
+ *
+ * The last table compares the time of createDevices for the same table on both paths; the map path adds one
+ * NVS read per boot and one blob write when a device gets a new id.
+ *
+ * Usage: device_endpoint_bench [boots]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+#include "FakeNvs.hpp"
+
+#include "DeviceRegistry.hpp"
+#include "EndpointIdMap.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t RELAY_CHANNELS = 4;
+constexpr uint16_t ADDED_ID      = 100;
+constexpr uint16_t REMOVED_ID    = 3;
+
+using Clock = std::chrono::steady_clock;
+
+/* Endpoint ids of each device id, in ascending order */
+using EndpointIds = std::map<uint16_t, std::vector<uint16_t>>;
+
+struct Accessories
+{
+    FakeFanAccessory fan;
+    FakeLightAccessory lights[7];
+    FakePluginAccessory relayChannels[RELAY_CHANNELS];
+    FakePluginAccessory plugins[6];
+    FakeBlindAccessory windows[2];
+    BaseAccessoryInterface * relayChannelAccessories[RELAY_CHANNELS];
+};
+
+/* The table of the first boot, lights last so a light can be added */
+std::vector<DeviceDescriptor> baseTable(Accessories & accessories)
+{
+    for (uint8_t channel = 0; channel < RELAY_CHANNELS; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+
+    std::vector<DeviceDescriptor> table;
+    auto add = [&](DeviceType type, BaseAccessoryInterface * accessory) {
+        table.push_back({ static_cast<uint16_t>(table.size() + 1), type, "Device", accessory, nullptr, 0 });
+    };
+
+    for (FakePluginAccessory & accessory : accessories.plugins)
+    {
+        add(DeviceType::PLUGIN, &accessory);
+    }
+    add(DeviceType::MULTI_PLUGIN, nullptr);
+    table.back().channelAccessories = accessories.relayChannelAccessories;
+    table.back().channelCount       = RELAY_CHANNELS;
+    for (FakeBlindAccessory & accessory : accessories.windows)
+    {
+        add(DeviceType::WINDOW, &accessory);
+    }
+    add(DeviceType::FAN, &accessories.fan);
+    for (size_t i = 0; i < 6; i++)
+    {
+        add(DeviceType::LIGHT, &accessories.lights[i]);
+    }
+    return table;
+}
+
+/* Collects the endpoint ids of every device of the running bridge */
+EndpointIds endpointIds(const DeviceRegistry & registry, const std::vector<DeviceDescriptor> & table)
+{
+    std::map<void *, uint16_t> deviceIds;
+    for (const DeviceDescriptor & descriptor : table)
+    {
+        deviceIds[registry.find(descriptor.id)] = descriptor.id;
+    }
+
+    EndpointIds ids;
+    uint16_t found = 0;
+    for (uint16_t endpointId = 0; found < esp_matter_fake::endpointCount(); endpointId++)
+    {
+        if (esp_matter::endpoint::get(esp_matter::node::get(), endpointId) == nullptr)
+        {
+            continue;
+        }
+        found++;
+        auto device = deviceIds.find(esp_matter::endpoint::get_priv_data(endpointId));
+        if (device != deviceIds.end())
+        {
+            ids[device->second].push_back(endpointId);
+        }
+    }
+    return ids;
+}
+
+/* Endpoints of devices of both boots whose id changed */
+size_t movedEndpoints(const EndpointIds & previous, const EndpointIds & current)
+{
+    size_t moved = 0;
+    for (const auto & device : current)
+    {
+        auto before = previous.find(device.first);
+        if (before != previous.end() && before->second != device.second)
+        {
+            for (size_t i = 0; i < device.second.size(); i++)
+            {
+                moved += i >= before->second.size() || before->second[i] != device.second[i];
+            }
+        }
+    }
+    return moved;
+}
+
+struct BootResult
+{
+    EndpointIds ids;     /**< Endpoint ids of every device. */
+    double createUs;     /**< Time of createDevices, with the map load of the map path. */
+    size_t resumed;      /**< Endpoints resumed with their stored id. */
+    size_t assigned;     /**< Endpoints that got a new id. */
+    uint32_t blobWrites; /**< Map blobs written. */
+};
+
+/* One boot of app_main's data model, the devices created before or after esp_matter::start */
+BootResult boot(const std::vector<DeviceDescriptor> & table, bool createFirst)
+{
+    esp_matter_fake::reboot();
+    esp_matter::node::config_t nodeConfig;
+    esp_matter::node_t * node = esp_matter::node::create(&nodeConfig, bench::attributeCallback, nullptr);
+    esp_matter::endpoint::aggregator::config_t aggregatorConfig;
+    esp_matter::endpoint_t * aggregator =
+        esp_matter::endpoint::aggregator::create(node, &aggregatorConfig, esp_matter::ENDPOINT_FLAG_NONE, nullptr);
+
+    BootResult result{};
+    uint32_t writesBefore = EndpointIdMap::writeCount();
+    DeviceRegistry registry(aggregator);
+    if (!createFirst)
+    {
+        esp_matter::start(nullptr);
+    }
+    Clock::time_point start = Clock::now();
+    if (!createFirst)
+    {
+        // What the first mapped endpoint of a boot does on target
+        EndpointIdMap::load();
+    }
+    registry.createDevices(table.data(), table.size());
+    result.createUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    if (createFirst)
+    {
+        esp_matter::start(nullptr);
+    }
+
+    result.ids        = endpointIds(registry, table);
+    result.resumed    = EndpointIdMap::resumedCount();
+    result.assigned   = EndpointIdMap::assignedCount();
+    result.blobWrites = EndpointIdMap::writeCount() - writesBefore;
+    return result;
+}
+
+/* Forgets everything stored, like a flash erase */
+void eraseFlash()
+{
+    esp_matter_fake::reset();
+    nvs_fake::erase();
+    EndpointIdMap::erase();
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t boots = bench::iterationsFromArgs(argc, argv, 200);
+
+    Accessories accessories;
+    std::vector<DeviceDescriptor> table = baseTable(accessories);
+
+    struct Step
+    {
+        const char * name;                   /**< Edit of the table. */
+        std::vector<DeviceDescriptor> table; /**< Table of the boot. */
+    };
+    std::vector<Step> steps;
+    steps.push_back({ "first boot", table });
+    steps.push_back({ "same table", table });
+    steps.push_back({ "reordered", std::vector<DeviceDescriptor>(table.rbegin(), table.rend()) });
+    std::vector<DeviceDescriptor> added = table;
+    added.insert(added.begin(), { ADDED_ID, DeviceType::LIGHT, "Added", &accessories.lights[6], nullptr, 0 });
+    steps.push_back({ "device added first", added });
+    std::vector<DeviceDescriptor> removed = added;
+    removed.erase(std::remove_if(removed.begin(), removed.end(),
+                                 [](const DeviceDescriptor & descriptor) { return descriptor.id == REMOVED_ID; }),
+                  removed.end());
+    steps.push_back({ "device removed", removed });
+    steps.push_back({ "device back", added });
+
+    printf("Endpoint ids across firmware updates, %u devices, %u endpoints\n\n", (unsigned) table.size(),
+           (unsigned) (table.size() - 1 + RELAY_CHANNELS));
+    printf("%-20s %10s %14s %10s %10s %10s\n", "step", "endpoints", "moved first", "moved map", "resumed", "new ids");
+
+    eraseFlash();
+    std::vector<BootResult> createFirstBoots;
+    for (const Step & step : steps)
+    {
+        createFirstBoots.push_back(boot(step.table, true));
+    }
+
+    eraseFlash();
+    std::vector<BootResult> mapBoots;
+    for (const Step & step : steps)
+    {
+        mapBoots.push_back(boot(step.table, false));
+    }
+
+    uint32_t blobWrites = 0;
+    for (size_t i = 0; i < steps.size(); i++)
+    {
+        const BootResult & mapped = mapBoots[i];
+        size_t previous           = i > 0 ? i - 1 : 0;
+        size_t endpoints          = 0;
+        for (const auto & device : mapped.ids)
+        {
+            endpoints += device.second.size();
+        }
+        blobWrites += mapped.blobWrites;
+        printf("%-20s %10u %14u %10u %10u %10u\n", steps[i].name, (unsigned) endpoints,
+               (unsigned) movedEndpoints(createFirstBoots[previous].ids, createFirstBoots[i].ids),
+               (unsigned) movedEndpoints(mapBoots[previous].ids, mapped.ids), (unsigned) mapped.resumed,
+               (unsigned) mapped.assigned);
+    }
+    printf("map blob writes: %u over %u boots\n", (unsigned) blobWrites, (unsigned) steps.size());
+
+    printf("\n%-20s %12s\n", "path", "create us");
+    for (bool createFirst : { true, false })
+    {
+        eraseFlash();
+        std::vector<double> createUs;
+        for (uint32_t i = 0; i < boots; i++)
+        {
+            createUs.push_back(boot(table, createFirst).createUs);
+        }
+        printf("%-20s %12.1f\n", createFirst ? "created first" : "map", median(createUs));
+    }
+
+    printf("\nmoved: endpoints whose id differs from the previous boot, devices of both boots only\n");
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @brief Benchmark of attribute callback latency with and without the ActuationExecutor.
+ *
+ * A relay whose switching blocks for 200 us receives bursts of 32 OnOff writes through the attribute
+ * callback. Inline, every callback (and so the Matter task) waits for the relay; with the executor the
+ * callback only queues the write. The table shows the time spent in the callback, which is what delays
+ * the next message, and the time until the whole burst reached the accessory.
+ *
+ * A slider drag then streams 101 TargetPositionLiftPercent100ths writes, one every 200 us, to a blind
+ * whose motor command blocks for 2 ms. The executor mailboxes keep only the newest pending target, so
+ * the table shows how many of the writes reached the motor and how long the blind took to settle.
+ *
+ * Usage: device_executor_bench [bursts]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "ActuationExecutor.hpp"
+#include "PluginDevice.hpp"
+#include "WindowDevice.hpp"
+
+#include <thread>
+
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr uint32_t BURST_LENGTH = 32;
+
+struct BurstResult
+{
+    double callbackNsMean; /**< Mean time spent in one callback. */
+    double callbackNsMax;  /**< Longest callback. */
+    double burstUsMean;    /**< Mean time until every write of a burst was actuated. */
+};
+
+BurstResult runBursts(uint32_t bursts, BaseDeviceInterface & device, uint16_t endpointId, ActuationExecutor * executor)
+{
+    using Clock = std::chrono::steady_clock;
+
+    double callbackNs    = 0;
+    double callbackNsMax = 0;
+    double burstUs       = 0;
+    for (uint32_t burst = 0; burst < bursts; burst++)
+    {
+        Clock::time_point burstStart = Clock::now();
+        for (uint32_t i = 0; i < BURST_LENGTH; i++)
+        {
+            esp_matter_attr_val_t val = esp_matter_bool(i & 1);
+
+            Clock::time_point start = Clock::now();
+            if (executor == nullptr ||
+                executor->submit(&device, endpointId, OnOff::Id, OnOff::Attributes::OnOff::Id, &val) != ESP_OK)
+            {
+                device.updateAccessory(endpointId, OnOff::Id, OnOff::Attributes::OnOff::Id, &val);
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+            callbackNs += ns;
+            callbackNsMax = ns > callbackNsMax ? ns : callbackNsMax;
+        }
+        if (executor != nullptr)
+        {
+            executor->flush();
+        }
+        burstUs += std::chrono::duration<double, std::micro>(Clock::now() - burstStart).count();
+    }
+
+    return { callbackNs / (bursts * BURST_LENGTH), callbackNsMax, burstUs / bursts };
+}
+
+struct DragResult
+{
+    uint32_t actuations; /**< Writes that reached the motor. */
+    uint8_t finalTarget; /**< Accessory position the blind settled on. */
+    double settleUs;     /**< Time from the first write until the last one was actuated. */
+};
+
+DragResult runDrag(BaseDeviceInterface & device, FakeBlindAccessory & blind, uint16_t endpointId, ActuationExecutor * executor)
+{
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t actuationsBefore = blind.actuations();
+    Clock::time_point start   = Clock::now();
+    const uint32_t attributeId = WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id;
+    for (uint16_t percent = 0; percent <= 100; percent++)
+    {
+        esp_matter_attr_val_t val = esp_matter_nullable_uint16(percent * 100);
+        if (executor == nullptr || executor->submit(&device, endpointId, WindowCovering::Id, attributeId, &val) != ESP_OK)
+        {
+            device.updateAccessory(endpointId, WindowCovering::Id, attributeId, &val);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    if (executor != nullptr)
+    {
+        executor->flush();
+    }
+    double settleUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    return { blind.actuations() - actuationsBefore, blind.getTargetPosition(), settleUs };
+}
+
+void printDragResult(const char * mode, const DragResult & result)
+{
+    printf("%-10s %18u %18u %14.1f\n", mode, result.actuations, result.finalTarget, result.settleUs);
+}
+
+void printBurstResult(const char * mode, const BurstResult & result)
+{
+    printf("%-10s %18.1f %18.1f %14.1f\n", mode, result.callbackNsMean, result.callbackNsMax, result.burstUsMean);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t bursts = bench::iterationsFromArgs(argc, argv, 50);
+
+    esp_matter::endpoint_t * aggregator = bench::createBridge();
+
+    FakePluginAccessory relay;
+    relay.setActuationDelay(std::chrono::microseconds(200));
+    uint16_t relayEndpoint = esp_matter_fake::endpointCount();
+    PluginDevice device(const_cast<char *>("Relay"), &relay, aggregator);
+
+    esp_matter::start(nullptr);
+
+    ActuationExecutor executor;
+    executor.start();
+
+    printf("ActuationExecutor host benchmark, %u bursts of %u writes, 200 us per actuation\n\n", bursts, BURST_LENGTH);
+    printf("%-10s %18s %18s %14s\n", "mode", "callback ns/op", "callback max ns", "burst us");
+    printBurstResult("inline", runBursts(bursts, device, relayEndpoint, nullptr));
+    printBurstResult("executor", runBursts(bursts, device, relayEndpoint, &executor));
+
+    FakeBlindAccessory blind;
+    blind.setActuationDelay(std::chrono::milliseconds(2));
+    uint16_t windowEndpoint = esp_matter_fake::endpointCount();
+    WindowDevice window("Window", &blind, aggregator);
+
+    printf("\nSlider drag, 101 writes 200 us apart, 2 ms per motor command\n\n");
+    printf("%-10s %18s %18s %14s\n", "mode", "motor commands", "final position", "settle us");
+    printDragResult("inline", runDrag(window, blind, windowEndpoint, nullptr));
+    printDragResult("executor", runDrag(window, blind, windowEndpoint, &executor));
+
+    executor.stop();
+    printf("\n%u writes actuated by the executor, %u replaced by a newer write, %u rejected\n", executor.executed(),
+           executor.coalesced(), executor.overflows());
+    return 0;
+}
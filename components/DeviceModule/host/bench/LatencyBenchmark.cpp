@@ -0,0 +1,179 @@
+/**
+ * @brief End-to-end command and report latency of a small bridge, inline and through the executor tasks.
+ *
+ * A light, a relay whose switching blocks for 200 us, a fan and a blind whose motor command blocks for 1 ms
+ * receive one attribute write every 250 us, in turn, through an attribute callback equivalent to
+ * app_attribute_cb, while the light and the relay also toggle locally. A second thread plays the Matter task
+ * and holds the chip stack lock for 500 us out of every millisecond.
+ *
+ * Each scenario ends with the per-device histograms of `matter device latency`: command latency is the
+ * time from the callback to the accessory call, report latency the time from the accessory state change
+ * to its attribute report.
+ *
+ * Usage: device_latency_bench [writes]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "ActuationExecutor.hpp"
+#include "DeviceRegistry.hpp"
+#include "ReportDispatcher.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr uint8_t DEVICE_COUNT = 4;
+
+struct Target
+{
+    uint16_t id;          /**< Registry id of the device. */
+    uint16_t endpointId;  /**< Endpoint the writes go to. */
+    uint32_t clusterId;   /**< Written cluster. */
+    uint32_t attributeId; /**< Written attribute. */
+};
+
+/* Holds the chip stack lock half of the time, like a busy Matter task. Sleeping keeps the CPU free on single-core hosts. */
+void holdStackLock(std::atomic<bool> & running)
+{
+    while (running.load())
+    {
+        esp_matter::lock::chip_stack_lock(portMAX_DELAY);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        esp_matter::lock::chip_stack_unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+}
+
+esp_matter_attr_val_t valueOf(const Target & target, uint32_t i)
+{
+    if (target.clusterId == FanControl::Id)
+    {
+        return esp_matter_nullable_uint8((i & 1) ? 100 : 0);
+    }
+    if (target.clusterId == WindowCovering::Id)
+    {
+        return esp_matter_nullable_uint16((i % 101) * 100);
+    }
+    return esp_matter_bool(i & 1);
+}
+
+/* Same routing as app_attribute_cb: through the executor when there is one, inline otherwise */
+void write(BaseDeviceInterface * device, const Target & target, uint32_t i, ActuationExecutor * executor)
+{
+    esp_matter_attr_val_t val = valueOf(target, i);
+    esp_err_t err             = ESP_ERR_INVALID_STATE;
+    if (executor != nullptr)
+    {
+        err = executor->submit(device, target.endpointId, target.clusterId, target.attributeId, &val);
+    }
+    if (err != ESP_OK)
+    {
+        if (err == ESP_ERR_NO_MEM)
+        {
+            device->getStats().recordActuationOverflow();
+        }
+        device->getStats().markCommand(DeviceStats::now());
+        device->updateAccessory(target.endpointId, target.clusterId, target.attributeId, &val);
+    }
+}
+
+void runScenario(const char * name, uint32_t writes, DeviceRegistry & registry, const Target (&targets)[DEVICE_COUNT],
+                 FakeLightAccessory & light, FakePluginAccessory & relay, ActuationExecutor * executor,
+                 ReportDispatcher * dispatcher)
+{
+    registry.resetStats();
+    if (dispatcher != nullptr)
+    {
+        dispatcher->start();
+        registry.setReportDispatcher(dispatcher);
+    }
+
+    std::atomic<bool> running(true);
+    std::thread matterTask(holdStackLock, std::ref(running));
+
+    for (uint32_t i = 0; i < writes; i++)
+    {
+        const Target & target = targets[i % DEVICE_COUNT];
+        write(registry.find(target.id), target, i / DEVICE_COUNT, executor);
+        if (i % 2 == 0)
+        {
+            light.toggle();
+        }
+        else
+        {
+            relay.toggle();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(250));
+    }
+
+    /* Drain pending writes and reports before reading the histograms */
+    if (executor != nullptr)
+    {
+        executor->flush();
+    }
+    if (dispatcher != nullptr)
+    {
+        dispatcher->stop();
+        registry.setReportDispatcher(nullptr);
+    }
+    running.store(false);
+    matterTask.join();
+
+    printf("\n%s\n\n", name);
+    registry.printLatency();
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t writes = bench::iterationsFromArgs(argc, argv, 2000);
+
+    FakeLightAccessory light;
+    FakePluginAccessory relay;
+    FakeFanAccessory fan;
+    FakeBlindAccessory blind;
+    relay.setActuationDelay(std::chrono::microseconds(200));
+    blind.setActuationDelay(std::chrono::microseconds(1000));
+
+    const DeviceDescriptor descriptors[DEVICE_COUNT] = {
+        { 1, DeviceType::LIGHT, "Light", &light, nullptr, 0 },
+        { 2, DeviceType::PLUGIN, "Relay", &relay, nullptr, 0 },
+        { 3, DeviceType::FAN, "Fan", &fan, nullptr, 0 },
+        { 4, DeviceType::WINDOW, "Blind", &blind, nullptr, 0 },
+    };
+    Target targets[DEVICE_COUNT] = {
+        { 1, 0, OnOff::Id, OnOff::Attributes::OnOff::Id },
+        { 2, 0, OnOff::Id, OnOff::Attributes::OnOff::Id },
+        { 3, 0, FanControl::Id, FanControl::Attributes::PercentSetting::Id },
+        { 4, 0, WindowCovering::Id, WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id },
+    };
+
+    /* Endpoint ids are handed out sequentially, so a device gets the endpoint count before it is added */
+    static DeviceRegistry registry(bench::createBridge());
+    for (uint8_t i = 0; i < DEVICE_COUNT; i++)
+    {
+        targets[i].endpointId = esp_matter_fake::endpointCount();
+        registry.addDevice(descriptors[i]);
+    }
+    esp_matter::start(nullptr);
+
+    printf("Latency host benchmark, %u writes, one every 250 us, stack lock held 50%% of the time\n", writes);
+
+    runScenario("Inline actuation and reports", writes, registry, targets, light, relay, nullptr, nullptr);
+
+    ActuationExecutor executor;
+    executor.start();
+    ReportDispatcher dispatcher;
+    runScenario("ActuationExecutor and ReportDispatcher", writes, registry, targets, light, relay, &executor, &dispatcher);
+    executor.stop();
+
+    printf("\n%u writes coalesced by the executor\n", executor.coalesced());
+    return 0;
+}
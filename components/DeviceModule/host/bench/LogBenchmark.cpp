@@ -0,0 +1,79 @@
+/**
+ * @brief Cost of one hot-path log message: text, compiled out, and tokenized.
+ *
+ * Times an ESP_LOGI text message, a DM_LOGI message (text, or a tokenized ring record when built with
+ * CONFIG_D_M_LOG_TOKENIZED=1) and a DM_LOGD message, which the default info level removes at compile
+ * time. Text goes to stderr, redirected to /dev/null, with the host log level at info. The uart column
+ * is the time the formatted line would occupy a 115200 baud console on target, which the host cannot
+ * show.
+ *
+ * With tokenized logs the benchmark ends with the ring dump of `matter device log`, ready for
+ * tools/decode_device_log.py.
+ *
+ * Usage: device_log_bench [iterations]
+ */
+
+#include "BenchHarness.hpp"
+
+#include "DeviceLog.hpp"
+
+namespace {
+
+const char * TAG = "LightDevice";
+
+constexpr double UART_US_PER_CHAR = 10 * 1000000.0 / 115200;
+
+/* Length of a console line of ESP-IDF text logs, "I (<ms>) <tag>: <message>\n" */
+double uartUs(const char * message, bool text)
+{
+    if (!text)
+    {
+        return 0;
+    }
+    char line[128];
+    int length = snprintf(line, sizeof(line), "I (%u) %s: %s\n", 123456u, TAG, message);
+    return length * UART_US_PER_CHAR;
+}
+
+void printCase(const char * operation, const bench::Result & result, double uart)
+{
+    printf("%-26s %10.1f %12.1f\n", operation, result.nsPerOp, uart);
+}
+
+void noPrepare(uint32_t) {}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    uint32_t iterations = bench::iterationsFromArgs(argc, argv, 200000);
+    if (freopen("/dev/null", "w", stderr) == nullptr)
+    {
+        return 1;
+    }
+    esp_log_level_set("*", ESP_LOG_INFO);
+
+    printf("Log host benchmark, %u iterations per case, log level %d, tokenized %s\n\n", iterations, CONFIG_D_M_LOG_LEVEL,
+           CONFIG_D_M_LOG_TOKENIZED ? "yes" : "no");
+    printf("%-26s %10s %12s\n", "message", "ns/op", "uart us/op");
+
+    printCase("ESP_LOGI text", bench::run(iterations, noPrepare, [](uint32_t) { ESP_LOGI(TAG, "Updating accessory state"); }),
+              uartUs("Updating accessory state", true));
+    printCase("DM_LOGI, 1 argument",
+              bench::run(iterations, noPrepare, [](uint32_t i) { DM_LOGI(TAG, "Set accessory power state to %d", i & 1); }),
+              uartUs("Set accessory power state to 1", CONFIG_D_M_LOG_LEVEL >= DM_LOG_LEVEL_INFO && !CONFIG_D_M_LOG_TOKENIZED));
+    printCase("DM_LOGD, 1 argument",
+              bench::run(iterations, noPrepare, [](uint32_t i) { DM_LOGD(TAG, "Set accessory power state to %d", i & 1); }),
+              uartUs("Set accessory power state to 1", CONFIG_D_M_LOG_LEVEL >= DM_LOG_LEVEL_DEBUG && !CONFIG_D_M_LOG_TOKENIZED));
+
+#if CONFIG_D_M_LOG_TOKENIZED
+    DeviceLog::clear();
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        DM_LOGI(TAG, "Set accessory power state to %d", i & 1);
+    }
+    printf("\nRing dump, as printed by `matter device log`\n\n");
+    DeviceLog::print();
+#endif
+    return 0;
+}
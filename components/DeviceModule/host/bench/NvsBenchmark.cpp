@@ -0,0 +1,369 @@
+/**
+ * @brief NVS write amplification of a day of traffic per device class, and the wear it puts on the nvs partition.
+ *
+ * Every device class is bridged alone, once with each persistence policy, and replays one simulated day:
+ * controller commands arrive in bursts of writes a few hundred milliseconds apart (toggling, slider drags),
+ * evenly spread over the day, and the accessory changes state locally a number of times. Blinds move one
+ * percent every 50 ms after each new target, reporting every step like the motor task. The fake counts every
+ * attribute value esp_matter would store and the 32-byte NVS entries it takes; deferred attributes are
+ * stored when their CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS window, which runs in simulated
+ * time, ends.
+ *
+ * The lifetime estimate assumes NVS spreads erases evenly over the pages of the nvs partition of
+ * partitions.csv, keeps one page free for garbage collection and half of the rest holding live data
+ * (fabrics, ACLs, stored attributes), and that the flash endures 100000 erase cycles per sector. It covers
+ * the attribute writes of the module only, not the session counters and other data the Matter stack stores.
+ *
+ * Usage: device_nvs_bench [commands per day] [writes per burst] [ms between writes] [local changes per day]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "DeviceRegistry.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace chip::app::Clusters;
+
+namespace {
+
+constexpr uint64_t DAY_MS               = 24ull * 60 * 60 * 1000;
+constexpr uint32_t MOTOR_STEP_MS        = 50;
+constexpr uint32_t NVS_PAGE_SIZE        = 4096;
+constexpr uint32_t NVS_ENTRIES_PER_PAGE = 126;
+constexpr uint32_t NVS_ENTRY_SIZE       = 32;
+constexpr double FLASH_ERASE_CYCLES     = 100000;
+constexpr uint32_t DEFAULT_NVS_SIZE     = 0xC000;
+constexpr uint16_t DEVICE_ID            = 1;
+constexpr uint8_t RELAY_CHANNELS        = 4;
+
+struct Workload
+{
+    uint32_t commands;     /**< Controller writes per day. */
+    uint32_t burstLength;  /**< Writes per burst. */
+    uint32_t burstGapMs;   /**< Time between the writes of a burst. */
+    uint32_t localChanges; /**< Accessory state changes per day. */
+};
+
+struct DayResult
+{
+    uint32_t commands;     /**< Controller writes replayed. */
+    uint32_t localChanges; /**< Local state changes replayed. */
+    uint64_t nvsWrites;    /**< Attribute values stored. */
+    uint64_t nvsBytes;     /**< Bytes of the stored values. */
+    uint64_t nvsEntries;   /**< NVS entries the stored values took. */
+};
+
+/* One accessory of every class, and the channels of the multi-channel ones */
+struct Accessories
+{
+    FakeButtonAccessory button;
+    FakeDoorLockAccessory doorLock;
+    FakeFanAccessory fan;
+    FakeLightAccessory light;
+    FakePluginAccessory relayChannels[RELAY_CHANNELS];
+    BaseAccessoryInterface * relayChannelAccessories[RELAY_CHANNELS];
+    FakePluginAccessory plugin;
+    FakeTVLifterAccessory tvLifter;
+    FakeBlindAccessory blind;
+};
+
+struct Event
+{
+    uint64_t timeMs; /**< Simulated time of the event. */
+    bool command;    /**< Controller write, or local state change. */
+    uint32_t index;  /**< Number of the event of its kind. */
+};
+
+/* Reads the size of the nvs partition from partitions.csv, or returns the default layout size */
+uint32_t nvsPartitionSize(const char * path)
+{
+    FILE * file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return DEFAULT_NVS_SIZE;
+    }
+
+    uint32_t size = DEFAULT_NVS_SIZE;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        char * fields[5] = {};
+        uint8_t count    = 0;
+        for (char * field = strtok(line, ","); field != nullptr && count < 5; field = strtok(nullptr, ","))
+        {
+            fields[count++] = field;
+        }
+        if (count == 5 && strncmp(fields[0], "nvs", 3) == 0 && strspn(fields[0] + 3, " \t") == strlen(fields[0] + 3))
+        {
+            size = static_cast<uint32_t>(strtoul(fields[4], nullptr, 0));
+        }
+    }
+    fclose(file);
+    return size;
+}
+
+uint32_t argOr(int argc, char ** argv, int index, uint32_t defaultValue)
+{
+    if (argc > index)
+    {
+        long value = strtol(argv[index], nullptr, 10);
+        if (value > 0)
+        {
+            return static_cast<uint32_t>(value);
+        }
+    }
+    return defaultValue;
+}
+
+/* Controller writes of bursts spread evenly over the day, and local changes between them */
+std::vector<Event> dayOfEvents(const Workload & workload)
+{
+    std::vector<Event> events;
+    uint32_t bursts = (workload.commands + workload.burstLength - 1) / workload.burstLength;
+    for (uint32_t i = 0; i < workload.commands; i++)
+    {
+        uint64_t burstStart = DAY_MS * (i / workload.burstLength) / bursts;
+        events.push_back({ burstStart + (i % workload.burstLength) * workload.burstGapMs, true, i });
+    }
+    for (uint32_t i = 0; i < workload.localChanges; i++)
+    {
+        events.push_back({ DAY_MS * (2 * i + 1) / (2 * workload.localChanges), false, i });
+    }
+    std::stable_sort(events.begin(), events.end(), [](const Event & a, const Event & b) { return a.timeMs < b.timeMs; });
+    return events;
+}
+
+/* Writes the attribute a controller would change on the device class, through the attribute callback */
+void command(DeviceType type, uint16_t endpointId, uint32_t index, uint32_t burstLength)
+{
+    uint32_t position = index % burstLength;
+    bool up           = (index / burstLength) % 2 == 0;
+    switch (type)
+    {
+    case DeviceType::DOOR_LOCK:
+        esp_matter_fake::writeAttribute(endpointId, DoorLock::Id, DoorLock::Attributes::LockState::Id,
+                                        esp_matter_nullable_enum8(index % 2 ? 2 : 1));
+        break;
+    case DeviceType::FAN:
+        esp_matter_fake::writeAttribute(endpointId, FanControl::Id, FanControl::Attributes::PercentSetting::Id,
+                                        esp_matter_nullable_uint8(up ? 100 * (position + 1) / burstLength : 0));
+        break;
+    case DeviceType::MULTI_PLUGIN:
+        esp_matter_fake::writeAttribute(endpointId + (index / burstLength) % RELAY_CHANNELS, OnOff::Id,
+                                        OnOff::Attributes::OnOff::Id, esp_matter_bool(index % 2 == 0));
+        break;
+    case DeviceType::TV_LIFTER:
+        esp_matter_fake::writeAttribute(endpointId + index % 3, OnOff::Id, OnOff::Attributes::OnOff::Id, esp_matter_bool(true));
+        break;
+    case DeviceType::WINDOW: {
+        uint32_t percent = 100 * (position + 1) / burstLength;
+        esp_matter_fake::writeAttribute(endpointId, WindowCovering::Id,
+                                        WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
+                                        esp_matter_nullable_uint16((up ? percent : 100 - percent) * 100));
+        break;
+    }
+    case DeviceType::BUTTON:
+        break;
+    default:
+        esp_matter_fake::writeAttribute(endpointId, OnOff::Id, OnOff::Attributes::OnOff::Id, esp_matter_bool(index % 2 == 0));
+        break;
+    }
+}
+
+/* Changes the accessory state locally and reports it, as a wall switch or remote would */
+void localChange(DeviceType type, Accessories & accessories, uint32_t index)
+{
+    switch (type)
+    {
+    case DeviceType::BUTTON:
+        accessories.button.press(StatelessButtonAccessoryInterface::PressType::SinglePress);
+        break;
+    case DeviceType::DOOR_LOCK:
+        accessories.doorLock.toggle();
+        break;
+    case DeviceType::FAN:
+        accessories.fan.toggle();
+        break;
+    case DeviceType::LIGHT:
+        accessories.light.toggle();
+        break;
+    case DeviceType::MULTI_PLUGIN:
+        accessories.relayChannels[index % RELAY_CHANNELS].toggle();
+        break;
+    case DeviceType::PLUGIN:
+        accessories.plugin.toggle();
+        break;
+    case DeviceType::TV_LIFTER:
+        accessories.tvLifter.report();
+        break;
+    case DeviceType::WINDOW:
+        accessories.blind.setPositions(accessories.blind.getCurrentPosition(), index % 2 ? 0 : 100);
+        break;
+    }
+}
+
+DayResult replayDay(DeviceType type, PersistencePolicy policy, const Workload & workload)
+{
+    Accessories accessories;
+    for (uint8_t channel = 0; channel < RELAY_CHANNELS; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+    BaseAccessoryInterface * accessory = nullptr;
+    switch (type)
+    {
+    case DeviceType::BUTTON:
+        accessory = &accessories.button;
+        break;
+    case DeviceType::DOOR_LOCK:
+        accessory = &accessories.doorLock;
+        break;
+    case DeviceType::FAN:
+        accessory = &accessories.fan;
+        break;
+    case DeviceType::LIGHT:
+        accessory = &accessories.light;
+        break;
+    case DeviceType::PLUGIN:
+        accessory = &accessories.plugin;
+        break;
+    case DeviceType::TV_LIFTER:
+        accessory = &accessories.tvLifter;
+        break;
+    case DeviceType::WINDOW:
+        accessory = &accessories.blind;
+        break;
+    case DeviceType::MULTI_PLUGIN:
+        break;
+    }
+
+    DeviceRegistry registry(bench::createBridge());
+    uint16_t endpointId = esp_matter_fake::endpointCount();
+    registry.addDevice({ DEVICE_ID, type, "Device", accessory, accessories.relayChannelAccessories, RELAY_CHANNELS, policy });
+    esp_matter::start(nullptr);
+
+    /* Only the traffic of the day counts, not the values stored while the device was created */
+    esp_matter_fake::advanceDeferredPersistence(CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS);
+    esp_matter_fake::resetCounters();
+
+    uint64_t nowMs      = 0;
+    uint64_t nextStepMs = 0;
+    auto advanceTo      = [&](uint64_t timeMs) {
+        /* The blind motor steps while the simulated time passes */
+        while (accessories.blind.getCurrentPosition() != accessories.blind.getTargetPosition() && nextStepMs <= timeMs)
+        {
+            esp_matter_fake::advanceDeferredPersistence(static_cast<uint32_t>(nextStepMs - nowMs));
+            nowMs = nextStepMs;
+            accessories.blind.step();
+            nextStepMs += MOTOR_STEP_MS;
+        }
+        esp_matter_fake::advanceDeferredPersistence(static_cast<uint32_t>(timeMs - nowMs));
+        nowMs      = timeMs;
+        nextStepMs = nowMs + MOTOR_STEP_MS;
+    };
+
+    DayResult result = {};
+    for (const Event & event : dayOfEvents(workload))
+    {
+        advanceTo(event.timeMs);
+        if (event.command)
+        {
+            command(type, endpointId, event.index, workload.burstLength);
+            result.commands += type == DeviceType::BUTTON ? 0 : 1;
+            if (type == DeviceType::TV_LIFTER)
+            {
+                accessories.tvLifter.report(); // releases the momentary channel
+            }
+        }
+        else
+        {
+            localChange(type, accessories, event.index);
+            result.localChanges++;
+        }
+    }
+    /* Let the last movement end and the last deferral window expire */
+    advanceTo(DAY_MS + 100 * MOTOR_STEP_MS + CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS);
+
+    const esp_matter_fake::Counters & counters = esp_matter_fake::counters();
+    result.nvsWrites                           = counters.nvsWrites;
+    result.nvsBytes                            = counters.nvsBytes;
+    result.nvsEntries                          = counters.nvsEntries;
+    return result;
+}
+
+/* Years until the pages of the partition reach the erase endurance */
+double lifetimeYears(uint64_t entriesPerDay, uint32_t partitionSize)
+{
+    if (entriesPerDay == 0)
+    {
+        return 0;
+    }
+    uint32_t pages         = partitionSize / NVS_PAGE_SIZE;
+    double writableEntries = (pages - 1) * NVS_ENTRIES_PER_PAGE / 2.0;
+    double erasesPerDay    = entriesPerDay / writableEntries;
+    return FLASH_ERASE_CYCLES / erasesPerDay / 365;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    Workload workload = { argOr(argc, argv, 1, 200), argOr(argc, argv, 2, 4), argOr(argc, argv, 3, 400),
+                          argOr(argc, argv, 4, 20) };
+    uint32_t partitionSize = nvsPartitionSize(DM_PARTITIONS_CSV);
+
+    struct Row
+    {
+        const char * name;
+        DeviceType type;
+        uint32_t poolSize;
+    };
+    const Row rows[] = {
+        { "Button", DeviceType::BUTTON, CONFIG_D_M_BUTTON_DEVICE_POOL_SIZE },
+        { "DoorLock", DeviceType::DOOR_LOCK, CONFIG_D_M_DOOR_LOCK_DEVICE_POOL_SIZE },
+        { "Fan", DeviceType::FAN, CONFIG_D_M_FAN_DEVICE_POOL_SIZE },
+        { "Light", DeviceType::LIGHT, CONFIG_D_M_LIGHT_DEVICE_POOL_SIZE },
+        { "MultiPlugin(4)", DeviceType::MULTI_PLUGIN, CONFIG_D_M_MULTI_PLUGIN_DEVICE_POOL_SIZE },
+        { "Plugin", DeviceType::PLUGIN, CONFIG_D_M_PLUGIN_DEVICE_POOL_SIZE },
+        { "TVLifter", DeviceType::TV_LIFTER, CONFIG_D_M_TV_LIFTER_DEVICE_POOL_SIZE },
+        { "Window", DeviceType::WINDOW, CONFIG_D_M_WINDOW_DEVICE_POOL_SIZE },
+    };
+    const PersistencePolicy policies[] = { PersistencePolicy::IMMEDIATE, PersistencePolicy::DEFERRED };
+
+    printf("NVS host benchmark, one day: %u commands in bursts of %u, %u ms apart, %u local changes, deferral window %u ms\n",
+           workload.commands, workload.burstLength, workload.burstGapMs, workload.localChanges,
+           CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS);
+    printf("nvs partition %u bytes (%u pages) from %s\n\n", partitionSize, partitionSize / NVS_PAGE_SIZE, DM_PARTITIONS_CSV);
+    printf("%-16s %-10s %9s %11s %11s %11s %13s %13s\n", "device", "policy", "events", "nvs/day", "nvs/event", "bytes/day",
+           "flash B/day", "years alone");
+
+    uint64_t bridgeEntries[2] = {};
+    for (const Row & row : rows)
+    {
+        for (uint8_t p = 0; p < 2; p++)
+        {
+            DayResult day   = replayDay(row.type, policies[p], workload);
+            uint32_t events = day.commands + day.localChanges;
+            printf("%-16s %-10s %9u %11llu %11.2f %11llu %13llu %13.1f\n", row.name,
+                   policies[p] == PersistencePolicy::DEFERRED ? "deferred" : "immediate", events,
+                   (unsigned long long) day.nvsWrites, events > 0 ? static_cast<double>(day.nvsWrites) / events : 0.0,
+                   (unsigned long long) day.nvsBytes, (unsigned long long) day.nvsEntries * NVS_ENTRY_SIZE,
+                   lifetimeYears(day.nvsEntries, partitionSize));
+            bridgeEntries[p] += day.nvsEntries * row.poolSize;
+        }
+    }
+
+    printf("\nBridge with every device pool full, all devices on this workload:\n\n");
+    printf("%-10s %13s %13s\n", "policy", "flash B/day", "years");
+    for (uint8_t p = 0; p < 2; p++)
+    {
+        printf("%-10s %13llu %13.1f\n", policies[p] == PersistencePolicy::DEFERRED ? "deferred" : "immediate",
+               (unsigned long long) bridgeEntries[p] * NVS_ENTRY_SIZE, lifetimeYears(bridgeEntries[p], partitionSize));
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @brief Benchmark of bridge bring-up through DeviceRegistry on the host fake.
+ *
+ * Every iteration creates a fresh node and aggregator, then builds a 30-device bridge from one
+ * descriptor table, either before esp_matter::start (as app_main does) or after it (devices added
+ * at runtime, under one chip stack lock). Lookup by id is measured on the last bridge.
+ *
+ * Usage: device_registry_bench [iterations]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "DeviceRegistry.hpp"
+
+
+namespace {
+
+constexpr size_t DEVICE_COUNT = 30;
+
+/* One device of every class, filling every pool of the default configuration */
+struct Accessories
+{
+    FakeButtonAccessory buttons[4];
+    FakeDoorLockAccessory doorLocks[2];
+    FakeFanAccessory fans[2];
+    FakeLightAccessory lights[8];
+    FakePluginAccessory relayChannels[8];
+    FakePluginAccessory plugins[8];
+    FakeTVLifterAccessory tvLifter;
+    FakeBlindAccessory windows[4];
+    BaseAccessoryInterface * relayChannelAccessories[8];
+};
+
+/* Ids are spread out and unordered, as hand-written tables tend to be */
+void fillDescriptors(Accessories & accessories, DeviceDescriptor (&descriptors)[DEVICE_COUNT])
+{
+    size_t count = 0;
+    auto add     = [&](DeviceType type, BaseAccessoryInterface * accessory) {
+        descriptors[count] = { static_cast<uint16_t>((count * 7) % DEVICE_COUNT * 10 + 1), type, "Device", accessory, nullptr, 0 };
+        count++;
+    };
+
+    for (FakeButtonAccessory & accessory : accessories.buttons)
+    {
+        add(DeviceType::BUTTON, &accessory);
+    }
+    for (FakeDoorLockAccessory & accessory : accessories.doorLocks)
+    {
+        add(DeviceType::DOOR_LOCK, &accessory);
+    }
+    for (FakeFanAccessory & accessory : accessories.fans)
+    {
+        add(DeviceType::FAN, &accessory);
+    }
+    for (FakeLightAccessory & accessory : accessories.lights)
+    {
+        add(DeviceType::LIGHT, &accessory);
+    }
+    for (FakePluginAccessory & accessory : accessories.plugins)
+    {
+        add(DeviceType::PLUGIN, &accessory);
+    }
+    add(DeviceType::TV_LIFTER, &accessories.tvLifter);
+    for (FakeBlindAccessory & accessory : accessories.windows)
+    {
+        add(DeviceType::WINDOW, &accessory);
+    }
+
+    for (size_t channel = 0; channel < 8; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+    add(DeviceType::MULTI_PLUGIN, nullptr);
+    descriptors[count - 1].channelAccessories = accessories.relayChannelAccessories;
+    descriptors[count - 1].channelCount       = 8;
+}
+
+/**
+ * @brief Times `iterations` bring-ups of the bridge.
+ *
+ * bench::run cannot be used here since createBridge resets the fake counters, so they are summed per bring-up.
+ */
+bench::Result runBringUp(uint32_t iterations, bool started, const DeviceDescriptor * descriptors)
+{
+    using Clock = std::chrono::steady_clock;
+
+    double totalNs = 0;
+    bench::Result result{};
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        esp_matter::endpoint_t * aggregator = bench::createBridge();
+        if (started)
+        {
+            esp_matter::start(nullptr);
+        }
+        DeviceRegistry registry(aggregator);
+        esp_matter_fake::resetCounters();
+
+        Clock::time_point start = Clock::now();
+        registry.createDevices(descriptors, DEVICE_COUNT);
+        totalNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        const esp_matter_fake::Counters & counters = esp_matter_fake::counters();
+        result.lookupsPerOp += counters.lookups();
+        result.locksPerOp += counters.lockAcquisitions;
+        result.reportsPerOp += counters.reports;
+        result.nvsWritesPerOp += counters.nvsWrites;
+    }
+
+    result.nsPerOp = totalNs / iterations;
+    result.lookupsPerOp /= iterations;
+    result.locksPerOp /= iterations;
+    result.reportsPerOp /= iterations;
+    result.nvsWritesPerOp /= iterations;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t iterations        = bench::iterationsFromArgs(argc, argv, 20000);
+    uint32_t bringUpIterations = iterations / 100 + 1;
+
+    Accessories accessories;
+    DeviceDescriptor descriptors[DEVICE_COUNT];
+    fillDescriptors(accessories, descriptors);
+
+    printf("DeviceRegistry host benchmark, %u bring-ups and %u lookups per case\n\n", bringUpIterations, iterations);
+    bench::printHeader();
+
+    bench::printResult("DeviceRegistry", "bring-up(30)", runBringUp(bringUpIterations, false, descriptors));
+    bench::printResult("DeviceRegistry", "bring-up(30,s)", runBringUp(bringUpIterations, true, descriptors));
+
+    esp_matter_fake::reset();
+    DeviceRegistry registry(bench::createBridge());
+    registry.createDevices(descriptors, DEVICE_COUNT);
+
+    volatile uint32_t found = 0;
+    bench::printResult("DeviceRegistry", "find",
+                       bench::run(
+                           iterations, [](uint32_t) {},
+                           [&](uint32_t i) { found = found + (registry.find(descriptors[i % DEVICE_COUNT].id) != nullptr); }));
+
+    printf("\n%-18s %10s %10s %10s %12s\n", "device pool", "used", "peak", "capacity", "bytes/slot");
+    static const char * const TYPE_NAMES[] = {
+        "Button", "DoorLock", "Fan", "Light", "MultiPlugin", "Plugin", "TVLifter", "Window",
+    };
+    for (uint8_t type = 0; type <= static_cast<uint8_t>(DeviceType::WINDOW); type++)
+    {
+        DevicePoolUsage usage = registry.poolUsage(static_cast<DeviceType>(type));
+        printf("%-18s %10u %10u %10u %12u\n", TYPE_NAMES[type], (unsigned) usage.used, (unsigned) usage.peak,
+               (unsigned) usage.capacity, (unsigned) usage.slotSize);
+    }
+    printf("DeviceRegistry     %u bytes, pools included\n", (unsigned) sizeof(DeviceRegistry));
+
+    printf("\n(s) = bring-up after esp_matter::start, under the chip stack lock\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @brief Benchmark of accessory report latency with and without the ReportDispatcher.
+ *
+ * Eight relays toggle every 50 us from an accessory thread while a second thread plays the Matter task and
+ * holds the chip stack lock for 500 us out of every millisecond. Inline, each report callback waits for the
+ * lock; with the dispatcher it only posts the change and the report task reports the batch under one lock.
+ *
+ * A button is then pressed more times than the event queue holds while the lock is held, every press must
+ * still come out as one switch event: queued ones from the report task, the overflow inline.
+ *
+ * Usage: device_report_bench [reports]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "DeviceRegistry.hpp"
+#include "ReportDispatcher.hpp"
+#include "StackLockProfiler.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t RELAY_COUNT = 8;
+
+struct ReportResult
+{
+    double callbackNsMean; /**< Mean time the accessory spent in its report callback. */
+    double callbackNsMax;  /**< Longest report callback. */
+    double sentPerReport;  /**< Attribute reports sent per accessory report. */
+};
+
+/* Holds the chip stack lock half of the time, like a busy Matter task. Sleeping keeps the CPU free on single-core hosts. */
+void holdStackLock(std::atomic<bool> & running)
+{
+    while (running.load())
+    {
+        esp_matter::lock::chip_stack_lock(portMAX_DELAY);
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        esp_matter::lock::chip_stack_unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+}
+
+ReportResult runReports(uint32_t reports, FakePluginAccessory (&relays)[RELAY_COUNT], ReportDispatcher * dispatcher)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<bool> running(true);
+    std::thread matterTask(holdStackLock, std::ref(running));
+    esp_matter_fake::resetCounters();
+    StackLockProfiler::reset();
+
+    double callbackNs    = 0;
+    double callbackNsMax = 0;
+    for (uint32_t i = 0; i < reports; i++)
+    {
+        Clock::time_point start = Clock::now();
+        relays[i % RELAY_COUNT].toggle();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        callbackNs += ns;
+        callbackNsMax = ns > callbackNsMax ? ns : callbackNsMax;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    /* Stopping drains the pending reports */
+    if (dispatcher != nullptr)
+    {
+        dispatcher->stop();
+    }
+    running.store(false);
+    matterTask.join();
+
+    const esp_matter_fake::Counters & counters = esp_matter_fake::counters();
+    return { callbackNs / reports, callbackNsMax, static_cast<double>(counters.reports) / reports };
+}
+
+/* Presses the button with the chip stack lock held, returns the switch events emitted. */
+uint64_t runPresses(uint32_t presses, FakeButtonAccessory & button, ReportDispatcher & dispatcher)
+{
+    esp_matter_fake::resetCounters();
+    dispatcher.start();
+
+    esp_matter::lock::chip_stack_lock(portMAX_DELAY);
+    for (uint32_t i = 0; i < presses; i++)
+    {
+        button.press(i % 2 == 0 ? StatelessButtonAccessoryInterface::PressType::SinglePress
+                                : StatelessButtonAccessoryInterface::PressType::LongPress);
+    }
+    esp_matter::lock::chip_stack_unlock();
+
+    dispatcher.stop();
+    return esp_matter_fake::counters().events;
+}
+
+void printReportResult(const char * mode, const ReportResult & result)
+{
+    printf("%-12s %16.1f %16.1f %12.2f\n", mode, result.callbackNsMean, result.callbackNsMax, result.sentPerReport);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t reports = bench::iterationsFromArgs(argc, argv, 2000);
+
+    FakePluginAccessory relays[RELAY_COUNT];
+    FakeButtonAccessory button;
+    DeviceDescriptor descriptors[RELAY_COUNT + 1];
+    for (uint8_t i = 0; i < RELAY_COUNT; i++)
+    {
+        descriptors[i] = { static_cast<uint16_t>(i + 1), DeviceType::PLUGIN, "Relay", &relays[i], nullptr, 0 };
+    }
+    descriptors[RELAY_COUNT] = { RELAY_COUNT + 1, DeviceType::BUTTON, "Button", &button, nullptr, 0 };
+
+    static DeviceRegistry registry(bench::createBridge());
+    registry.createDevices(descriptors, RELAY_COUNT + 1);
+    esp_matter::start(nullptr);
+
+    printf("ReportDispatcher host benchmark, %u relay toggles, stack lock held 50%% of the time\n", reports);
+    ReportResult inlineResult = runReports(reports, relays, nullptr);
+    printf("\nStack lock profile, inline\n");
+    StackLockProfiler::print();
+
+    ReportDispatcher dispatcher;
+    dispatcher.start();
+    registry.setReportDispatcher(&dispatcher);
+    ReportResult dispatcherResult = runReports(reports, relays, &dispatcher);
+    printf("\nStack lock profile, dispatcher\n");
+    StackLockProfiler::print();
+
+    uint32_t presses = CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH + 4;
+    uint64_t events  = runPresses(presses, button, dispatcher);
+    registry.setReportDispatcher(nullptr);
+
+    printf("\n%-12s %16s %16s %12s\n", "mode", "callback ns/op", "callback max ns", "reports/op");
+    printReportResult("inline", inlineResult);
+    printReportResult("dispatcher", dispatcherResult);
+
+    printf("\n%u reports posted, %u reportEndpoint calls made by the report task\n", dispatcher.posted(), dispatcher.reported());
+
+    printf("\nPer-device counters of both runs, as printed by `matter device stats`\n\n");
+    registry.printStats();
+
+    bool everyPress = events == presses;
+    printf("\n%u presses under a held stack lock, %llu switch events, %u queued events reported, %u overflowed\n", presses,
+           static_cast<unsigned long long>(events), dispatcher.eventsReported(), dispatcher.eventOverflows());
+    printf("%s\n", everyPress ? "PASS: every press is reported" : "FAIL: presses coalesced");
+    return everyPress ? 0 : 1;
+}
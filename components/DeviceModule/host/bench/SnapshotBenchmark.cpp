@@ -0,0 +1,323 @@
+/**
+ * @brief Boot-to-accessories-restored time with and without the DeviceSnapshot, on the host fake.
+ *
+ * Every boot starts from powered-off accessories and NVS holding the state of a 30-device bridge. Without
+ * the snapshot the accessories get their state from the device constructors, once the node, the aggregator
+ * and every endpoint exist; esp_matter reads each non-volatile attribute from NVS on the way. With it one
+ * blob read restores them before the data model is built. The restored states are checked against the
+ * saved ones.
+ *
+ * The fake reads NVS from memory, so the host times only show the work around the reads; on target every
+ * NVS read and endpoint adds tens of microseconds, which the NVS read counts stand for.
+ *
+ * Usage: device_snapshot_bench [boots]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+#include "FakeNvs.hpp"
+
+#include "DeviceRegistry.hpp"
+#include "DeviceSnapshot.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr size_t DEVICE_COUNT    = 30;
+constexpr uint8_t RELAY_CHANNELS = 8;
+
+using Clock = std::chrono::steady_clock;
+
+/* One device of every class, filling every pool of the default configuration */
+struct Accessories
+{
+    FakeButtonAccessory buttons[4];
+    FakeDoorLockAccessory doorLocks[2];
+    FakeFanAccessory fans[2];
+    FakeLightAccessory lights[8];
+    FakePluginAccessory relayChannels[RELAY_CHANNELS];
+    FakePluginAccessory plugins[8];
+    FakeTVLifterAccessory tvLifter;
+    FakeBlindAccessory windows[4];
+    BaseAccessoryInterface * relayChannelAccessories[RELAY_CHANNELS];
+};
+
+void fillDescriptors(Accessories & accessories, DeviceDescriptor (&descriptors)[DEVICE_COUNT])
+{
+    size_t count = 0;
+    auto add     = [&](DeviceType type, BaseAccessoryInterface * accessory) {
+        descriptors[count] = { static_cast<uint16_t>(count + 1), type, "Device", accessory, nullptr, 0 };
+        count++;
+    };
+
+    for (FakeButtonAccessory & accessory : accessories.buttons)
+    {
+        add(DeviceType::BUTTON, &accessory);
+    }
+    for (FakeDoorLockAccessory & accessory : accessories.doorLocks)
+    {
+        add(DeviceType::DOOR_LOCK, &accessory);
+    }
+    for (FakeFanAccessory & accessory : accessories.fans)
+    {
+        add(DeviceType::FAN, &accessory);
+    }
+    for (FakeLightAccessory & accessory : accessories.lights)
+    {
+        add(DeviceType::LIGHT, &accessory);
+    }
+    for (FakePluginAccessory & accessory : accessories.plugins)
+    {
+        add(DeviceType::PLUGIN, &accessory);
+    }
+    add(DeviceType::TV_LIFTER, &accessories.tvLifter);
+    for (FakeBlindAccessory & accessory : accessories.windows)
+    {
+        add(DeviceType::WINDOW, &accessory);
+    }
+
+    for (uint8_t channel = 0; channel < RELAY_CHANNELS; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+    add(DeviceType::MULTI_PLUGIN, nullptr);
+    descriptors[count - 1].channelAccessories = accessories.relayChannelAccessories;
+    descriptors[count - 1].channelCount       = RELAY_CHANNELS;
+}
+
+/* Packs the state of every accessory, to compare what a boot restored with what was saved */
+std::vector<uint32_t> accessoryStates(const Accessories & accessories)
+{
+    std::vector<uint32_t> states;
+    for (const FakeDoorLockAccessory & accessory : accessories.doorLocks)
+    {
+        states.push_back(accessory.getState() == DoorLockAccessoryInterface::DoorLockState::LOCKED);
+    }
+    for (const FakeFanAccessory & accessory : accessories.fans)
+    {
+        states.push_back(accessory.getPower());
+    }
+    for (const FakeLightAccessory & accessory : accessories.lights)
+    {
+        states.push_back(accessory.isPowerOn());
+    }
+    for (const FakePluginAccessory & accessory : accessories.relayChannels)
+    {
+        states.push_back(accessory.getPower());
+    }
+    for (const FakePluginAccessory & accessory : accessories.plugins)
+    {
+        states.push_back(accessory.getPower());
+    }
+    for (const FakeBlindAccessory & accessory : accessories.windows)
+    {
+        states.push_back(accessory.getCurrentPosition());
+    }
+    return states;
+}
+
+/* Puts the accessories in a pseudo-random state, as a day of use leaves them */
+void scramble(Accessories & accessories, uint32_t & seed)
+{
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 16;
+    };
+
+    for (FakeDoorLockAccessory & accessory : accessories.doorLocks)
+    {
+        accessory.setState(next() & 1 ? DoorLockAccessoryInterface::DoorLockState::LOCKED
+                                      : DoorLockAccessoryInterface::DoorLockState::UNLOCKED);
+    }
+    for (FakeFanAccessory & accessory : accessories.fans)
+    {
+        accessory.setPower(next() & 1);
+    }
+    for (FakeLightAccessory & accessory : accessories.lights)
+    {
+        accessory.setPowerState(next() & 1);
+    }
+    for (FakePluginAccessory & accessory : accessories.relayChannels)
+    {
+        accessory.setPower(next() & 1);
+    }
+    for (FakePluginAccessory & accessory : accessories.plugins)
+    {
+        accessory.setPower(next() & 1);
+    }
+    for (FakeBlindAccessory & accessory : accessories.windows)
+    {
+        uint8_t position = static_cast<uint8_t>(next() % 101);
+        accessory.setPositions(position, position);
+    }
+}
+
+/* A power cut: every relay drops, blinds keep no position */
+void powerOff(Accessories & accessories)
+{
+    for (FakeDoorLockAccessory & accessory : accessories.doorLocks)
+    {
+        accessory.setState(DoorLockAccessoryInterface::DoorLockState::UNLOCKED);
+    }
+    for (FakeFanAccessory & accessory : accessories.fans)
+    {
+        accessory.setPower(false);
+    }
+    for (FakeLightAccessory & accessory : accessories.lights)
+    {
+        accessory.setPowerState(false);
+    }
+    for (FakePluginAccessory & accessory : accessories.relayChannels)
+    {
+        accessory.setPower(false);
+    }
+    for (FakePluginAccessory & accessory : accessories.plugins)
+    {
+        accessory.setPower(false);
+    }
+    for (FakeBlindAccessory & accessory : accessories.windows)
+    {
+        accessory.setPositions(0, 0);
+    }
+}
+
+struct BootResult
+{
+    double restoredNs;  /**< Boot start until every accessory has its state. */
+    double createdNs;   /**< Boot start until every device is created. */
+    uint64_t nvsReads;  /**< NVS reads until the accessories were restored. */
+    bool stateRestored; /**< The accessories got the saved state back. */
+};
+
+/**
+ * @brief Boots the bridge once from powered-off accessories.
+ * @param useSnapshot Restore the accessories from the snapshot before building the data model.
+ */
+BootResult boot(Accessories & accessories, const DeviceDescriptor * descriptors, const std::vector<uint32_t> & saved,
+                bool useSnapshot)
+{
+    BootResult result{};
+    powerOff(accessories);
+    nvs_fake::resetCounters();
+
+    Clock::time_point start = Clock::now();
+    if (useSnapshot)
+    {
+        DeviceSnapshot::restore(descriptors, DEVICE_COUNT);
+        result.restoredNs    = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        result.nvsReads      = nvs_fake::counters().reads;
+        result.stateRestored = accessoryStates(accessories) == saved;
+    }
+
+    // createBridge resets the fake counters, so the attribute reads are counted from here
+    esp_matter::endpoint_t * aggregator = bench::createBridge();
+    DeviceRegistry registry(aggregator);
+    registry.createDevices(descriptors, DEVICE_COUNT);
+    result.createdNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    if (!useSnapshot)
+    {
+        // The fake data model forgets its values on reset, so only the time of this path is meaningful
+        result.restoredNs = result.createdNs;
+        result.nvsReads   = esp_matter_fake::counters().nvsReads;
+    }
+    return result;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t boots = bench::iterationsFromArgs(argc, argv, 200);
+
+    Accessories accessories;
+    DeviceDescriptor descriptors[DEVICE_COUNT];
+    fillDescriptors(accessories, descriptors);
+
+    printf("DeviceSnapshot host benchmark, %u boots of a %u-device bridge per case\n\n", boots, (unsigned) DEVICE_COUNT);
+    printf("%-12s %14s %14s %10s %10s\n", "restore", "restored us", "created us", "nvs reads", "state");
+
+    uint32_t seed = 1;
+    for (bool useSnapshot : { false, true })
+    {
+        if (useSnapshot && DeviceSnapshot::restore(nullptr, 0) == ESP_ERR_NOT_SUPPORTED)
+        {
+            printf("%-12s disabled, enable CONFIG_D_M_BOOT_SNAPSHOT\n", "snapshot");
+            continue;
+        }
+
+        std::vector<double> restoredNs;
+        std::vector<double> createdNs;
+        uint64_t nvsReads   = 0;
+        uint32_t mismatches = 0;
+        for (uint32_t i = 0; i < boots; i++)
+        {
+            // The bridge runs, the accessories change and the snapshot is saved before the power cut
+            nvs_fake::erase();
+            {
+                esp_matter::endpoint_t * aggregator = bench::createBridge();
+                DeviceRegistry registry(aggregator);
+                registry.createDevices(descriptors, DEVICE_COUNT);
+                scramble(accessories, seed);
+                registry.saveSnapshot();
+            }
+            std::vector<uint32_t> saved = accessoryStates(accessories);
+
+            BootResult result = boot(accessories, descriptors, saved, useSnapshot);
+            restoredNs.push_back(result.restoredNs);
+            createdNs.push_back(result.createdNs);
+            nvsReads += result.nvsReads;
+            mismatches += (useSnapshot && !result.stateRestored) ? 1 : 0;
+        }
+        printf("%-12s %14.1f %14.1f %10.1f %10s\n", useSnapshot ? "snapshot" : "data model", median(restoredNs) / 1000,
+               median(createdNs) / 1000, static_cast<double>(nvsReads) / boots,
+               useSnapshot ? (mismatches == 0 ? "ok" : "MISMATCH") : "-");
+    }
+
+    // Cost of the periodic save: nothing while no state changes, one blob per save otherwise
+    nvs_fake::erase();
+    esp_matter::endpoint_t * aggregator = bench::createBridge();
+    DeviceRegistry registry(aggregator);
+    registry.createDevices(descriptors, DEVICE_COUNT);
+    registry.saveSnapshot();
+
+    uint32_t writesBefore = DeviceSnapshot::writeCount();
+    nvs_fake::resetCounters();
+    for (uint32_t i = 0; i < boots; i++)
+    {
+        registry.saveSnapshot();
+    }
+    uint32_t idleWrites = DeviceSnapshot::writeCount() - writesBefore;
+
+    writesBefore = DeviceSnapshot::writeCount();
+    nvs_fake::resetCounters();
+    Clock::time_point start = Clock::now();
+    for (uint32_t i = 0; i < boots; i++)
+    {
+        accessories.lights[i % 8].setPowerState(!accessories.lights[i % 8].isPowerOn());
+        registry.saveSnapshot();
+    }
+    double saveNs                       = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / boots;
+    uint32_t changedWrites              = DeviceSnapshot::writeCount() - writesBefore;
+    const nvs_fake::Counters & counters = nvs_fake::counters();
+
+    printf("\n%-22s %10s %10s %12s %10s\n", "save", "writes", "bytes", "nvs entries", "ns/save");
+    printf("%-22s %10u %10s %12s %10s\n", "unchanged", idleWrites, "-", "-", "-");
+    printf("%-22s %10u %10.1f %12.1f %10.1f\n", "one change per save", changedWrites,
+           static_cast<double>(counters.bytes) / std::max<uint32_t>(changedWrites, 1),
+           static_cast<double>(counters.nvsEntries) / std::max<uint32_t>(changedWrites, 1), saveNs);
+
+    printf("\nrestored us = boot start until every accessory has its state, created us = until every device exists\n");
+    printf("nvs reads   = blob reads for the snapshot, non-volatile attribute loads for the data model\n");
+    printf("bytes and nvs entries are per written snapshot\n");
+    return 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * @brief Soak test of runtime add/remove of bridged devices on the host fake.
+ *
+ * A running bridge adds and removes one device per cycle through DeviceRegistry, cycling through every
+ * device class. After a warm-up the heap in use and the endpoint count must stay flat: a removed device
+ * has to destroy its endpoints, detach its accessories and return its pool slot. Every added device gets a
+ * write of an attribute it handles through the ActuationExecutor right before it is removed, mostly while the
+ * write is still queued. Every RUNNING_ROUND_PERIOD-th round over the classes the accessories block for longer
+ * than a scheduler time slice and the device is removed once its handler drives the accessory, so removal
+ * also meets a running write. Reports go through a ReportDispatcher, as in app_main.
+ *
+ * Usage: device_soak_bench [cycles]
+ */
+
+#include "BenchHarness.hpp"
+#include "FakeAccessories.hpp"
+
+#include "ActuationExecutor.hpp"
+#include "DeviceRegistry.hpp"
+#include "ReportDispatcher.hpp"
+
+#include <malloc.h>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t RELAY_CHANNELS = 8;
+
+struct Accessories
+{
+    FakeButtonAccessory button;
+    FakeDoorLockAccessory doorLock;
+    FakeFanAccessory fan;
+    FakeLightAccessory light;
+    FakePluginAccessory relayChannels[RELAY_CHANNELS];
+    FakePluginAccessory plugin;
+    FakeTVLifterAccessory tvLifter;
+    FakeBlindAccessory window;
+    BaseAccessoryInterface * relayChannelAccessories[RELAY_CHANNELS];
+};
+
+using namespace chip::app::Clusters;
+
+constexpr std::chrono::microseconds ACTUATION_DELAY(20);
+constexpr std::chrono::milliseconds RUNNING_ACTUATION_DELAY(10);
+constexpr uint32_t RUNNING_ROUND_PERIOD = 32;
+
+/* Write the attribute callback would submit for a device of the type, false for devices without one */
+bool handledWrite(DeviceType type, uint32_t round, uint32_t & clusterId, uint32_t & attributeId, esp_matter_attr_val_t & val)
+{
+    switch (type)
+    {
+    case DeviceType::DOOR_LOCK:
+        clusterId   = DoorLock::Id;
+        attributeId = DoorLock::Attributes::LockState::Id;
+        val         = esp_matter_nullable_enum8(round & 1 ? 1 : 2);
+        return true;
+    case DeviceType::FAN:
+        clusterId   = FanControl::Id;
+        attributeId = FanControl::Attributes::PercentSetting::Id;
+        val         = esp_matter_nullable_uint8(round & 1 ? 100 : 0);
+        return true;
+    case DeviceType::LIGHT:
+    case DeviceType::MULTI_PLUGIN:
+    case DeviceType::PLUGIN:
+    case DeviceType::TV_LIFTER:
+        clusterId   = OnOff::Id;
+        attributeId = OnOff::Attributes::OnOff::Id;
+        val         = esp_matter_bool(true);
+        return true;
+    case DeviceType::WINDOW:
+        clusterId   = WindowCovering::Id;
+        attributeId = WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id;
+        val         = esp_matter_nullable_uint16((round % 101) * 100);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* First endpoint of a device, found through the private data the device registered */
+uint16_t firstEndpointOf(BaseDeviceInterface * device)
+{
+    uint16_t found = 0;
+    for (uint16_t endpointId = 0; found < esp_matter_fake::endpointCount(); endpointId++)
+    {
+        if (esp_matter::endpoint::get(esp_matter::node::get(), endpointId) == nullptr)
+        {
+            continue;
+        }
+        found++;
+        if (esp_matter::endpoint::get_priv_data(endpointId) == device)
+        {
+            return endpointId;
+        }
+    }
+    return 0;
+}
+
+size_t heapInUse()
+{
+    return mallinfo2().uordblks;
+}
+
+/* Sets the actuation delay of every accessory the devices drive */
+void setActuationDelay(Accessories & accessories, std::chrono::microseconds delay)
+{
+    for (FakePluginAccessory & channel : accessories.relayChannels)
+    {
+        channel.setActuationDelay(delay);
+    }
+    accessories.doorLock.setActuationDelay(delay);
+    accessories.fan.setActuationDelay(delay);
+    accessories.light.setActuationDelay(delay);
+    accessories.plugin.setActuationDelay(delay);
+    accessories.tvLifter.setActuationDelay(delay);
+    accessories.window.setActuationDelay(delay);
+}
+
+/* Actuations of every accessory, only the device of the current cycle drives one */
+uint32_t totalActuations(const Accessories & accessories)
+{
+    uint32_t actuations = accessories.doorLock.actuations() + accessories.fan.actuations() + accessories.light.actuations() +
+        accessories.plugin.actuations() + accessories.tvLifter.actuations() + accessories.window.actuations();
+    for (const FakePluginAccessory & channel : accessories.relayChannels)
+    {
+        actuations += channel.actuations();
+    }
+    return actuations;
+}
+
+/* True if no accessory still points back at a device */
+bool accessoriesDetached(const Accessories & accessories)
+{
+    bool attached = accessories.button.hasReportCallback() || accessories.doorLock.hasReportCallback() ||
+        accessories.fan.hasReportCallback() || accessories.light.hasReportCallback() || accessories.plugin.hasReportCallback() ||
+        accessories.tvLifter.hasReportCallback() || accessories.window.hasReportCallback();
+    for (const FakePluginAccessory & channel : accessories.relayChannels)
+    {
+        attached = attached || channel.hasReportCallback();
+    }
+    return !attached;
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+    uint32_t cycles = bench::iterationsFromArgs(argc, argv, 10000);
+
+    Accessories accessories;
+    for (uint8_t channel = 0; channel < RELAY_CHANNELS; channel++)
+    {
+        accessories.relayChannelAccessories[channel] = &accessories.relayChannels[channel];
+    }
+
+    const DeviceDescriptor descriptors[] = {
+        { 1, DeviceType::BUTTON, "Button", &accessories.button, nullptr, 0 },
+        { 2, DeviceType::DOOR_LOCK, "DoorLock", &accessories.doorLock, nullptr, 0 },
+        { 3, DeviceType::FAN, "Fan", &accessories.fan, nullptr, 0 },
+        { 4, DeviceType::LIGHT, "Light", &accessories.light, nullptr, 0 },
+        { 5, DeviceType::MULTI_PLUGIN, "Relay", nullptr, accessories.relayChannelAccessories, RELAY_CHANNELS },
+        { 6, DeviceType::PLUGIN, "Plugin", &accessories.plugin, nullptr, 0 },
+        { 7, DeviceType::TV_LIFTER, "TVLifter", &accessories.tvLifter, nullptr, 0 },
+        { 8, DeviceType::WINDOW, "Window", &accessories.window, nullptr, 0 },
+    };
+    const uint32_t descriptorCount = sizeof(descriptors) / sizeof(descriptors[0]);
+
+    static DeviceRegistry registry(bench::createBridge());
+    esp_matter::start(nullptr);
+    static ActuationExecutor executor;
+    static ReportDispatcher dispatcher;
+    executor.start();
+    dispatcher.start();
+    registry.setActuationExecutor(&executor);
+    registry.setReportDispatcher(&dispatcher);
+
+    uint32_t failures       = 0;
+    uint32_t runningRemoved = 0;
+    auto cycle              = [&](uint32_t i) {
+        const DeviceDescriptor & descriptor = descriptors[i % descriptorCount];
+        uint32_t round                      = i / descriptorCount;
+        bool removeRunning                  = round % RUNNING_ROUND_PERIOD == 1;
+        setActuationDelay(accessories, removeRunning ? RUNNING_ACTUATION_DELAY : ACTUATION_DELAY);
+        if (registry.addDevice(descriptor) != ESP_OK)
+        {
+            failures++;
+            return;
+        }
+        BaseDeviceInterface * device = registry.find(descriptor.id);
+        uint32_t clusterId           = 0;
+        uint32_t attributeId         = 0;
+        esp_matter_attr_val_t val    = {};
+        if (handledWrite(descriptor.type, round, clusterId, attributeId, val))
+        {
+            uint32_t actuationsBefore = totalActuations(accessories);
+            executor.submit(device, firstEndpointOf(device), clusterId, attributeId, &val);
+            if (removeRunning)
+            {
+                // The accessory counts an actuation when the handler calls it, before its actuation delay
+                using Clock              = std::chrono::steady_clock;
+                Clock::time_point giveUp = Clock::now() + std::chrono::milliseconds(100);
+                while (totalActuations(accessories) == actuationsBefore && Clock::now() < giveUp)
+                {
+                    std::this_thread::yield();
+                }
+                runningRemoved += totalActuations(accessories) != actuationsBefore;
+            }
+        }
+        if (registry.removeDevice(descriptor.id) != ESP_OK)
+        {
+            failures++;
+        }
+    };
+
+    /* Warm up allocator free lists and the fake's bookkeeping with one add/remove of every class */
+    for (uint32_t i = 0; i < descriptorCount; i++)
+    {
+        cycle(i);
+    }
+
+    size_t heapBefore        = heapInUse();
+    uint16_t endpointsBefore = esp_matter_fake::endpointCount();
+    esp_matter_fake::resetCounters();
+
+    using Clock             = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+    for (uint32_t i = 0; i < cycles; i++)
+    {
+        cycle(i);
+    }
+    double totalNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    size_t heapAfter        = heapInUse();
+    uint16_t endpointsAfter = esp_matter_fake::endpointCount();
+    bool detached           = accessoriesDetached(accessories);
+    bool flat               = heapAfter <= heapBefore && endpointsAfter == endpointsBefore && detached && failures == 0 &&
+        registry.size() == 0;
+
+    printf("DeviceRegistry soak, %u add/remove cycles over %u device classes\n\n", cycles, descriptorCount);
+    printf("%-28s %10.1f\n", "ns per add/remove", totalNs / cycles);
+    printf("%-28s %10.2f\n", "locks per add/remove",
+           static_cast<double>(esp_matter_fake::counters().lockAcquisitions) / cycles);
+    printf("%-28s %10zu -> %zu\n", "heap in use (bytes)", heapBefore, heapAfter);
+    printf("%-28s %10u -> %u\n", "endpoints", endpointsBefore, endpointsAfter);
+    printf("%-28s %10s\n", "accessories detached", detached ? "yes" : "no");
+    printf("%-28s %10u\n", "failed cycles", failures);
+    printf("%-28s %10u\n", "writes run by the executor", executor.executed());
+    printf("%-28s %10u\n", "writes dropped by removal", executor.cancelled());
+    printf("%-28s %10u\n", "removed while running", runningRemoved);
+    printf("%-28s %10u\n", "devices left in registry", (unsigned) registry.size());
+    printf("\n%s\n", flat ? "PASS: heap and endpoints stay flat" : "FAIL: add/remove leaks");
+    return flat ? 0 : 1;
+}
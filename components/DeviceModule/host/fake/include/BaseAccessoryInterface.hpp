@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * @brief Host stand-in for the accessorymodule base interface.
+ *
+ * Accessories notify their device through a plain function pointer and an opaque argument.
+ */
+class BaseAccessoryInterface
+{
+public:
+    typedef void (*ReportCallback)(void * callbackParameter, bool onlySave);
+
+    virtual ~BaseAccessoryInterface() = default;
+
+    /**
+     * @brief Sets the callback invoked when the accessory state changes.
+     */
+    virtual void setReportCallback(ReportCallback callback, void * callbackParameter) = 0;
+
+    /**
+     * @brief Identifies the accessory (e.g. blinks a LED).
+     */
+    virtual void identify() = 0;
+};
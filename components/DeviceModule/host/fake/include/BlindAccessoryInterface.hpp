@@ -0,0 +1,16 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+#include <cstdint>
+
+/**
+ * @brief Host stand-in for the accessorymodule blind interface. Positions are percentages (0-100).
+ */
+class BlindAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    virtual void moveBlindTo(uint8_t position)        = 0;
+    virtual uint8_t getCurrentPosition() const        = 0;
+    virtual uint8_t getTargetPosition() const         = 0;
+    virtual void setDefaultPosition(uint8_t position) = 0;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+
+/**
+ * @brief Host stand-in for the accessorymodule door lock interface.
+ */
+class DoorLockAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    enum class DoorLockState
+    {
+        LOCKED,
+        UNLOCKED
+    };
+
+    virtual void setState(DoorLockState state) = 0;
+    virtual DoorLockState getState() const     = 0;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "BlindAccessoryInterface.hpp"
+#include "DoorLockAccessoryInterface.hpp"
+#include "FanAccessoryInterface.hpp"
+#include "LightAccessoryInterface.hpp"
+#include "PluginAccessoryInterface.hpp"
+#include "StatelessButtonAccessoryInterface.hpp"
+#include "TVLifterAccessoryInterface.hpp"
+
+/**
+ * @brief In-memory accessories for host builds.
+ *
+ * Each fake records how often the device drove it (actuations) and can simulate a physical state change
+ * with report(), which invokes the callback installed by the device exactly like a real accessory does.
+ */
+template <typename Interface>
+class FakeAccessory : public Interface
+{
+public:
+    void setReportCallback(BaseAccessoryInterface::ReportCallback callback, void * callbackParameter) override
+    {
+        m_callback          = callback;
+        m_callbackParameter = callbackParameter;
+    }
+
+    void identify() override { m_identifyCount++; }
+
+    /**
+     * @brief Simulates a physical state change by invoking the device report callback.
+     */
+    void report(bool onlySave = false)
+    {
+        if (m_callback != nullptr)
+        {
+            m_callback(m_callbackParameter, onlySave);
+        }
+    }
+
+    bool hasReportCallback() const { return m_callback != nullptr; }
+    uint32_t actuations() const { return m_actuations; }
+    uint32_t identifyCount() const { return m_identifyCount; }
+
+    /**
+     * @brief Makes every actuation busy-wait, like a blocking relay, motor or lock driver.
+     */
+    void setActuationDelay(std::chrono::microseconds delay) { m_actuationDelay = delay; }
+
+protected:
+    /**
+     * @brief Counts an actuation and waits for the configured actuation delay.
+     */
+    void actuate()
+    {
+        m_actuations++;
+        if (m_actuationDelay.count() > 0)
+        {
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + m_actuationDelay;
+            while (std::chrono::steady_clock::now() < end)
+            {
+            }
+        }
+    }
+
+    std::atomic<uint32_t> m_actuations{ 0 };
+
+private:
+    BaseAccessoryInterface::ReportCallback m_callback = nullptr;
+    void * m_callbackParameter                        = nullptr;
+    uint32_t m_identifyCount                          = 0;
+    std::chrono::microseconds m_actuationDelay{ 0 };
+};
+
+class FakeLightAccessory : public FakeAccessory<LightAccessoryInterface>
+{
+public:
+    void setPowerState(bool powerState) override
+    {
+        m_power = powerState;
+        actuate();
+    }
+    bool isPowerOn() const override { return m_power; }
+
+    /**
+     * @brief Simulates a local toggle (e.g. wall switch) followed by a report.
+     */
+    void toggle()
+    {
+        m_power = !m_power;
+        report();
+    }
+
+private:
+    bool m_power = false;
+};
+
+class FakePluginAccessory : public FakeAccessory<PluginAccessoryInterface>
+{
+public:
+    void setPower(bool power) override
+    {
+        m_power = power;
+        actuate();
+    }
+    bool getPower() const override { return m_power; }
+
+    void toggle()
+    {
+        m_power = !m_power;
+        report();
+    }
+
+private:
+    bool m_power = false;
+};
+
+class FakeFanAccessory : public FakeAccessory<FanAccessoryInterface>
+{
+public:
+    void setPower(bool power) override
+    {
+        m_power = power;
+        actuate();
+    }
+    bool getPower() const override { return m_power; }
+
+    void toggle()
+    {
+        m_power = !m_power;
+        report();
+    }
+
+private:
+    bool m_power = false;
+};
+
+class FakeDoorLockAccessory : public FakeAccessory<DoorLockAccessoryInterface>
+{
+public:
+    void setState(DoorLockState state) override
+    {
+        m_state = state;
+        actuate();
+    }
+    DoorLockState getState() const override { return m_state; }
+
+    void toggle()
+    {
+        m_state = m_state == DoorLockState::LOCKED ? DoorLockState::UNLOCKED : DoorLockState::LOCKED;
+        report();
+    }
+
+private:
+    DoorLockState m_state = DoorLockState::UNLOCKED;
+};
+
+class FakeBlindAccessory : public FakeAccessory<BlindAccessoryInterface>
+{
+public:
+    void moveBlindTo(uint8_t position) override
+    {
+        m_target = position;
+        actuate();
+    }
+    uint8_t getCurrentPosition() const override { return m_current; }
+    uint8_t getTargetPosition() const override { return m_target; }
+    void setDefaultPosition(uint8_t position) override
+    {
+        m_current = position;
+        m_target  = position;
+    }
+
+    /**
+     * @brief Sets both positions without actuating or reporting.
+     */
+    void setPositions(uint8_t current, uint8_t target)
+    {
+        m_current = current;
+        m_target  = target;
+    }
+
+    /**
+     * @brief Moves one percent towards the target, as the motor task does, and reports the new position.
+     *
+     * @return true while the blind is still moving.
+     */
+    bool step()
+    {
+        if (m_current == m_target)
+        {
+            return false;
+        }
+        m_current = m_current < m_target ? m_current + 1 : m_current - 1;
+        report(m_current != m_target);
+        return m_current != m_target;
+    }
+
+private:
+    uint8_t m_current = 0;
+    uint8_t m_target  = 0;
+};
+
+class FakeButtonAccessory : public FakeAccessory<StatelessButtonAccessoryInterface>
+{
+public:
+    PressType getLastPressType() const override { return m_lastPress; }
+
+    void press(PressType pressType)
+    {
+        m_lastPress = pressType;
+        report();
+    }
+
+private:
+    PressType m_lastPress = PressType::SinglePress;
+};
+
+class FakeTVLifterAccessory : public FakeAccessory<TVLifterAccessoryInterface>
+{
+public:
+    void moveUp() override { actuate(); }
+    void moveDown() override { actuate(); }
+    void stop() override { actuate(); }
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <esp_err.h>
+#include <esp_matter.h>
+
+/**
+ * @brief Control and inspection API of the host esp_matter stand-in.
+ *
+ * Host tools use this to reset the in-memory data model, simulate controller writes and read the
+ * counters that the benchmarks report per operation.
+ */
+namespace esp_matter_fake {
+
+/**
+ * @brief Running totals of the data model work done since the last resetCounters().
+ */
+struct Counters
+{
+    uint64_t endpointLookups;  /**< endpoint::get calls. */
+    uint64_t clusterLookups;   /**< cluster::get calls. */
+    uint64_t attributeLookups; /**< attribute::get calls. */
+    uint64_t lookupSteps;      /**< List nodes visited by all lookups. */
+    uint64_t lockAcquisitions; /**< chip_stack_lock calls that took the lock. */
+    uint64_t lockAlreadyTaken; /**< chip_stack_lock calls made while already holding the lock. */
+    uint64_t lockFailures;     /**< chip_stack_lock calls that timed out. */
+    uint64_t reports;          /**< Attribute change notifications sent to subscribers. */
+    uint64_t getVals;          /**< attribute::get_val calls. */
+    uint64_t setVals;          /**< attribute::set_val calls. */
+    uint64_t nvsReads;         /**< Non-volatile attribute values loaded from NVS when they were created. */
+    uint64_t nvsWrites;        /**< Attribute values written to NVS. */
+    uint64_t nvsBytes;         /**< Bytes of attribute values written to NVS. */
+    uint64_t nvsEntries;       /**< 32-byte NVS entries the writes took, the unit of flash wear. */
+    uint64_t events;           /**< Events emitted (switch presses). */
+
+    /**
+     * @brief Total number of data model lookups (endpoint, cluster and attribute).
+     */
+    uint64_t lookups() const { return endpointLookups + clusterLookups + attributeLookups; }
+};
+
+/**
+ * @brief Returns the counters accumulated since the last reset.
+ */
+const Counters & counters();
+
+/**
+ * @brief Clears all counters.
+ */
+void resetCounters();
+
+/**
+ * @brief Destroys the node and every endpoint, and clears all counters and the stored endpoint id counter.
+ */
+void reset();
+
+/**
+ * @brief Destroys the node and every endpoint like a reboot, keeping what esp_matter stores in NVS.
+ *
+ * Like esp_matter, the fake stores the minimum unused endpoint id whenever an endpoint is created after
+ * esp_matter::start, and start() raises the id counter to it, so endpoint::resume can bring back the ids of
+ * the previous boot.
+ */
+void reboot();
+
+/**
+ * @brief Simulates a controller write: updates the value and runs PRE_UPDATE/POST_UPDATE callbacks.
+ *
+ * @return ESP_ERR_NOT_FOUND if the attribute does not exist, otherwise the callback result.
+ */
+esp_err_t writeAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t val);
+
+/**
+ * @brief Stores a value straight into the data model without callbacks, persistence or counters.
+ *
+ * Benchmarks use it to stage the value a controller wrote before timing updateAccessory.
+ */
+esp_err_t storeAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t val);
+
+/**
+ * @brief Reads a value straight from the data model without touching the counters.
+ */
+esp_err_t readAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val);
+
+/**
+ * @brief Writes every attribute with pending deferred persistence to NVS.
+ */
+void flushDeferredPersistence();
+
+/**
+ * @brief Advances the clock of deferred persistence and writes the attributes whose window ended.
+ *
+ * Like esp_matter, the first change of a deferred attribute starts a timer of
+ * CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS that stores the value it has when it expires. The fake
+ * timers only run through this call, so workloads can replay days of traffic in simulated time.
+ */
+void advanceDeferredPersistence(uint32_t elapsedMs);
+
+/**
+ * @brief Returns the number of endpoints currently in the data model, including the root endpoint.
+ */
+uint16_t endpointCount();
+
+} // namespace esp_matter_fake
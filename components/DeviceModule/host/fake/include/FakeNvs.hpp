@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Control and inspection API of the host NVS stand-in.
+ *
+ * Keys live in memory for the life of the process, so a benchmark can write a blob, reset the esp_matter
+ * fake to simulate a reboot and read the blob back.
+ */
+namespace nvs_fake {
+
+/**
+ * @brief Running totals of the NVS work done since the last resetCounters().
+ */
+struct Counters
+{
+    uint64_t reads;      /**< nvs_get_blob calls that found their key. */
+    uint64_t writes;     /**< nvs_set_blob calls. */
+    uint64_t bytes;      /**< Bytes written by nvs_set_blob. */
+    uint64_t nvsEntries; /**< 32-byte NVS entries the writes took, the unit of flash wear. */
+};
+
+/**
+ * @brief Returns the counters accumulated since the last reset.
+ */
+const Counters & counters();
+
+/**
+ * @brief Clears all counters.
+ */
+void resetCounters();
+
+/**
+ * @brief Erases every namespace and key, like nvs_flash_erase, and clears all counters.
+ */
+void erase();
+
+} // namespace nvs_fake
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+
+/**
+ * @brief Host stand-in for the accessorymodule light interface.
+ */
+class LightAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    virtual void setPowerState(bool powerState) = 0;
+    virtual bool isPowerOn() const              = 0;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+
+/**
+ * @brief Host stand-in for the accessorymodule plug-in interface.
+ */
+class PluginAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    virtual void setPower(bool power) = 0;
+    virtual bool getPower() const     = 0;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+
+/**
+ * @brief Host stand-in for the accessorymodule stateless button interface.
+ */
+class StatelessButtonAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    enum class PressType
+    {
+        SinglePress,
+        DoublePress,
+        LongPress
+    };
+
+    virtual PressType getLastPressType() const = 0;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "BaseAccessoryInterface.hpp"
+
+/**
+ * @brief Host stand-in for the accessorymodule TV lifter interface.
+ */
+class TVLifterAccessoryInterface : public BaseAccessoryInterface
+{
+public:
+    virtual void moveUp()   = 0;
+    virtual void moveDown() = 0;
+    virtual void stop()     = 0;
+};
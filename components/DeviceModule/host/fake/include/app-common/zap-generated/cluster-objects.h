@@ -0,0 +1,184 @@
+#pragma once
+
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * @brief Host stand-in for the generated cluster and attribute ids used by the module.
+ *
+ * Only the clusters and attributes touched by the device classes are listed; values match the Matter specification.
+ */
+namespace chip {
+namespace app {
+namespace Clusters {
+
+namespace Identify {
+inline constexpr ClusterId Id = 0x0003;
+namespace Attributes {
+namespace IdentifyTime {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace IdentifyTime
+namespace IdentifyType {
+inline constexpr AttributeId Id = 0x0001;
+} // namespace IdentifyType
+} // namespace Attributes
+} // namespace Identify
+
+namespace Groups {
+inline constexpr ClusterId Id = 0x0004;
+namespace Attributes {
+namespace NameSupport {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace NameSupport
+} // namespace Attributes
+} // namespace Groups
+
+namespace OnOff {
+inline constexpr ClusterId Id = 0x0006;
+namespace Attributes {
+namespace OnOff {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace OnOff
+namespace GlobalSceneControl {
+inline constexpr AttributeId Id = 0x4000;
+} // namespace GlobalSceneControl
+namespace OnTime {
+inline constexpr AttributeId Id = 0x4001;
+} // namespace OnTime
+namespace OffWaitTime {
+inline constexpr AttributeId Id = 0x4002;
+} // namespace OffWaitTime
+namespace StartUpOnOff {
+inline constexpr AttributeId Id = 0x4003;
+} // namespace StartUpOnOff
+} // namespace Attributes
+} // namespace OnOff
+
+namespace Descriptor {
+inline constexpr ClusterId Id = 0x001D;
+namespace Attributes {
+namespace DeviceTypeList {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace DeviceTypeList
+namespace PartsList {
+inline constexpr AttributeId Id = 0x0003;
+} // namespace PartsList
+} // namespace Attributes
+} // namespace Descriptor
+
+namespace BridgedDeviceBasicInformation {
+inline constexpr ClusterId Id = 0x0039;
+namespace Attributes {
+namespace NodeLabel {
+inline constexpr AttributeId Id = 0x0005;
+} // namespace NodeLabel
+namespace Reachable {
+inline constexpr AttributeId Id = 0x0011;
+} // namespace Reachable
+} // namespace Attributes
+} // namespace BridgedDeviceBasicInformation
+
+namespace Switch {
+inline constexpr ClusterId Id = 0x003B;
+namespace Attributes {
+namespace NumberOfPositions {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace NumberOfPositions
+namespace CurrentPosition {
+inline constexpr AttributeId Id = 0x0001;
+} // namespace CurrentPosition
+namespace MultiPressMax {
+inline constexpr AttributeId Id = 0x0002;
+} // namespace MultiPressMax
+} // namespace Attributes
+} // namespace Switch
+
+namespace DoorLock {
+inline constexpr ClusterId Id = 0x0101;
+
+enum class DlLockState : uint8_t
+{
+    kNotFullyLocked = 0x00,
+    kLocked         = 0x01,
+    kUnlocked       = 0x02,
+    kUnlatched      = 0x03,
+};
+
+enum class OperationErrorEnum : uint8_t
+{
+    kUnspecified         = 0x00,
+    kInvalidCredential   = 0x01,
+    kDisabledUserDenied  = 0x02,
+    kRestricted          = 0x03,
+    kInsufficientBattery = 0x04,
+};
+
+namespace Attributes {
+namespace LockState {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace LockState
+namespace LockType {
+inline constexpr AttributeId Id = 0x0001;
+} // namespace LockType
+namespace ActuatorEnabled {
+inline constexpr AttributeId Id = 0x0002;
+} // namespace ActuatorEnabled
+} // namespace Attributes
+} // namespace DoorLock
+
+namespace WindowCovering {
+inline constexpr ClusterId Id = 0x0102;
+namespace Attributes {
+namespace Type {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace Type
+namespace ConfigStatus {
+inline constexpr AttributeId Id = 0x0007;
+} // namespace ConfigStatus
+namespace CurrentPositionLiftPercentage {
+inline constexpr AttributeId Id = 0x0008;
+} // namespace CurrentPositionLiftPercentage
+namespace OperationalStatus {
+inline constexpr AttributeId Id = 0x000A;
+} // namespace OperationalStatus
+namespace TargetPositionLiftPercent100ths {
+inline constexpr AttributeId Id = 0x000B;
+} // namespace TargetPositionLiftPercent100ths
+namespace EndProductType {
+inline constexpr AttributeId Id = 0x000D;
+} // namespace EndProductType
+namespace CurrentPositionLiftPercent100ths {
+inline constexpr AttributeId Id = 0x000E;
+} // namespace CurrentPositionLiftPercent100ths
+namespace InstalledOpenLimitLift {
+inline constexpr AttributeId Id = 0x0010;
+} // namespace InstalledOpenLimitLift
+namespace InstalledClosedLimitLift {
+inline constexpr AttributeId Id = 0x0011;
+} // namespace InstalledClosedLimitLift
+namespace Mode {
+inline constexpr AttributeId Id = 0x0017;
+} // namespace Mode
+} // namespace Attributes
+} // namespace WindowCovering
+
+namespace FanControl {
+inline constexpr ClusterId Id = 0x0202;
+namespace Attributes {
+namespace FanMode {
+inline constexpr AttributeId Id = 0x0000;
+} // namespace FanMode
+namespace FanModeSequence {
+inline constexpr AttributeId Id = 0x0001;
+} // namespace FanModeSequence
+namespace PercentSetting {
+inline constexpr AttributeId Id = 0x0002;
+} // namespace PercentSetting
+namespace PercentCurrent {
+inline constexpr AttributeId Id = 0x0003;
+} // namespace PercentCurrent
+} // namespace Attributes
+} // namespace FanControl
+
+} // namespace Clusters
+} // namespace app
+} // namespace chip
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * @brief Host stand-in for the CHIP door lock server.
+ *
+ * SetLockState writes LockState through the fake data model, which invokes the node attribute callback
+ * the same way the real server does.
+ */
+class DoorLockServer
+{
+public:
+    static DoorLockServer & Instance();
+
+    bool SetLockState(chip::EndpointId endpointId, chip::app::Clusters::DoorLock::DlLockState newLockState);
+};
+
+bool emberAfPluginDoorLockOnDoorLockCommand(chip::EndpointId endpointId,
+                                            const chip::app::DataModel::Nullable<chip::FabricIndex> & fabricIdx,
+                                            const chip::app::DataModel::Nullable<chip::NodeId> & nodeId,
+                                            const chip::Optional<chip::ByteSpan> & pinCode,
+                                            chip::app::Clusters::DoorLock::OperationErrorEnum & err);
+
+bool emberAfPluginDoorLockOnDoorUnlockCommand(chip::EndpointId endpointId,
+                                              const chip::app::DataModel::Nullable<chip::FabricIndex> & fabricIdx,
+                                              const chip::app::DataModel::Nullable<chip::NodeId> & nodeId,
+                                              const chip::Optional<chip::ByteSpan> & pinCode,
+                                              chip::app::Clusters::DoorLock::OperationErrorEnum & err);
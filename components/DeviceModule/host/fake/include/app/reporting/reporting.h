@@ -0,0 +1,10 @@
+#pragma once
+
+#include <lib/core/DataModelTypes.h>
+
+/**
+ * @brief Host stand-in for the CHIP reporting engine entry point.
+ *
+ * Marks the attribute dirty for subscribers. Like on target, it must be called with the chip stack lock held.
+ */
+void MatterReportingAttributeChangeCallback(chip::EndpointId endpoint, chip::ClusterId clusterId, chip::AttributeId attributeId);
@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * @brief Host stand-in for the ESP-IDF section attributes; host memory is never retained across runs.
+ */
+#define RTC_NOINIT_ATTR
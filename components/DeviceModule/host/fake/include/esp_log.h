@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @brief Host stand-in for esp_log.
+ *
+ * Messages at or above the level returned by esp_log_host_level() are written to stderr.
+ * Benchmarks lower the level to ESP_LOG_NONE so that logging does not skew measurements.
+ */
+typedef enum
+{
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+/**
+ * @brief Returns a reference to the global host log level.
+ */
+esp_log_level_t & esp_log_host_level();
+
+inline void esp_log_level_set(const char * tag, esp_log_level_t level)
+{
+    (void) tag;
+    esp_log_host_level() = level;
+}
+
+#define ESP_HOST_LOG(level, letter, tag, format, ...)                                                                              \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        if (esp_log_host_level() >= level)                                                                                         \
+        {                                                                                                                          \
+            fprintf(stderr, letter " (%s): " format "\n", tag, ##__VA_ARGS__);                                                     \
+        }                                                                                                                          \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_HOST_LOG(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_HOST_LOG(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_HOST_LOG(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_HOST_LOG(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_HOST_LOG(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
+
+#ifndef __FILENAME__
+#define __FILENAME__ __FILE__
+#endif
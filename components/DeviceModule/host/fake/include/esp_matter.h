@@ -0,0 +1,507 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <esp_err.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Host stand-in for the subset of the esp_matter 1.3.0 API used by DeviceModule.
+ *
+ * The data model is kept in memory as singly linked lists (node -> endpoints -> clusters -> attributes),
+ * matching the way esp_matter walks its own lists, so lookup costs are representative. Every lookup,
+ * stack lock, report and persisted write is counted; see FakeEspMatter.hpp for the control API.
+ */
+
+/* ---------------------------------------------------------------------------------------------------------------- */
+/* Attribute values                                                                                                 */
+/* ---------------------------------------------------------------------------------------------------------------- */
+
+typedef enum
+{
+    ESP_MATTER_VAL_TYPE_INVALID                  = 0,
+    ESP_MATTER_VAL_TYPE_BOOLEAN                  = 1,
+    ESP_MATTER_VAL_TYPE_INTEGER                  = 2,
+    ESP_MATTER_VAL_TYPE_FLOAT                    = 3,
+    ESP_MATTER_VAL_TYPE_ARRAY                    = 4,
+    ESP_MATTER_VAL_TYPE_CHAR_STRING              = 5,
+    ESP_MATTER_VAL_TYPE_OCTET_STRING             = 6,
+    ESP_MATTER_VAL_TYPE_INT8                     = 7,
+    ESP_MATTER_VAL_TYPE_UINT8                    = 8,
+    ESP_MATTER_VAL_TYPE_INT16                    = 9,
+    ESP_MATTER_VAL_TYPE_UINT16                   = 10,
+    ESP_MATTER_VAL_TYPE_INT32                    = 11,
+    ESP_MATTER_VAL_TYPE_UINT32                   = 12,
+    ESP_MATTER_VAL_TYPE_INT64                    = 13,
+    ESP_MATTER_VAL_TYPE_UINT64                   = 14,
+    ESP_MATTER_VAL_TYPE_ENUM8                    = 15,
+    ESP_MATTER_VAL_TYPE_BITMAP8                  = 16,
+    ESP_MATTER_VAL_TYPE_BITMAP16                 = 17,
+    ESP_MATTER_VAL_TYPE_BITMAP32                 = 18,
+    ESP_MATTER_VAL_TYPE_ENUM16                   = 19,
+    ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS = 0x80,
+    ESP_MATTER_VAL_TYPE_NULLABLE_UINT8           = ESP_MATTER_VAL_TYPE_UINT8 | ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS,
+    ESP_MATTER_VAL_TYPE_NULLABLE_UINT16          = ESP_MATTER_VAL_TYPE_UINT16 | ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS,
+    ESP_MATTER_VAL_TYPE_NULLABLE_ENUM8           = ESP_MATTER_VAL_TYPE_ENUM8 | ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS,
+} esp_matter_val_type_t;
+
+typedef union
+{
+    bool b;
+    int i;
+    float f;
+    int8_t i8;
+    uint8_t u8;
+    int16_t i16;
+    uint16_t u16;
+    int32_t i32;
+    uint32_t u32;
+    int64_t i64;
+    uint64_t u64;
+    struct
+    {
+        uint8_t * b;
+        uint16_t s;
+        uint16_t n;
+        uint16_t t;
+    } a;
+    void * p;
+} esp_matter_val_t;
+
+typedef struct
+{
+    esp_matter_val_type_t type;
+    esp_matter_val_t val;
+} esp_matter_attr_val_t;
+
+/**
+ * @brief Nullable scalar, stored with the Matter null sentinel (all bits set) like esp_matter does.
+ */
+template <typename T>
+class nullable
+{
+public:
+    nullable() : m_value(null_value()) {}
+    template <typename U, typename = typename std::enable_if<std::is_arithmetic<U>::value>::type>
+    nullable(U value) : m_value(static_cast<T>(value))
+    {}
+    nullable(std::nullptr_t) : m_value(null_value()) {}
+
+    bool is_null() const { return m_value == null_value(); }
+    T value() const { return m_value; }
+    T value_or(T defaultValue) const { return is_null() ? defaultValue : m_value; }
+
+    static constexpr T null_value() { return std::numeric_limits<T>::max(); }
+
+private:
+    T m_value;
+};
+
+inline esp_matter_attr_val_t esp_matter_invalid(void * val)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type  = ESP_MATTER_VAL_TYPE_INVALID;
+    attrVal.val.p = val;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_bool(bool val)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type    = ESP_MATTER_VAL_TYPE_BOOLEAN;
+    attrVal.val.u64 = 0;
+    attrVal.val.b   = val;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_uint8(uint8_t val)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type    = ESP_MATTER_VAL_TYPE_UINT8;
+    attrVal.val.u64 = 0;
+    attrVal.val.u8  = val;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_nullable_uint8(nullable<uint8_t> val)
+{
+    esp_matter_attr_val_t attrVal = esp_matter_uint8(val.value());
+    attrVal.type                  = ESP_MATTER_VAL_TYPE_NULLABLE_UINT8;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_uint16(uint16_t val)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type    = ESP_MATTER_VAL_TYPE_UINT16;
+    attrVal.val.u64 = 0;
+    attrVal.val.u16 = val;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_nullable_uint16(nullable<uint16_t> val)
+{
+    esp_matter_attr_val_t attrVal = esp_matter_uint16(val.value());
+    attrVal.type                  = ESP_MATTER_VAL_TYPE_NULLABLE_UINT16;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_uint32(uint32_t val)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type    = ESP_MATTER_VAL_TYPE_UINT32;
+    attrVal.val.u64 = 0;
+    attrVal.val.u32 = val;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_enum8(uint8_t val)
+{
+    esp_matter_attr_val_t attrVal = esp_matter_uint8(val);
+    attrVal.type                  = ESP_MATTER_VAL_TYPE_ENUM8;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_nullable_enum8(nullable<uint8_t> val)
+{
+    esp_matter_attr_val_t attrVal = esp_matter_uint8(val.value());
+    attrVal.type                  = ESP_MATTER_VAL_TYPE_NULLABLE_ENUM8;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_bitmap8(uint8_t val)
+{
+    esp_matter_attr_val_t attrVal = esp_matter_uint8(val);
+    attrVal.type                  = ESP_MATTER_VAL_TYPE_BITMAP8;
+    return attrVal;
+}
+
+inline esp_matter_attr_val_t esp_matter_char_str(char * val, uint16_t dataSize)
+{
+    esp_matter_attr_val_t attrVal;
+    attrVal.type    = ESP_MATTER_VAL_TYPE_CHAR_STRING;
+    attrVal.val.a.b = reinterpret_cast<uint8_t *>(val);
+    attrVal.val.a.s = dataSize;
+    attrVal.val.a.n = dataSize;
+    attrVal.val.a.t = dataSize;
+    return attrVal;
+}
+
+namespace chip {
+namespace DeviceLayer {
+struct ChipDeviceEvent
+{
+    uint16_t Type;
+};
+} // namespace DeviceLayer
+} // namespace chip
+
+namespace esp_matter {
+
+/* ---------------------------------------------------------------------------------------------------------------- */
+/* Data model handles                                                                                               */
+/* ---------------------------------------------------------------------------------------------------------------- */
+
+typedef struct _node_t node_t;
+typedef struct _endpoint_t endpoint_t;
+typedef struct _cluster_t cluster_t;
+typedef struct _attribute_t attribute_t;
+
+namespace endpoint_flags {
+enum endpoint_flags : uint8_t
+{
+    ENDPOINT_FLAG_NONE        = 0x00,
+    ENDPOINT_FLAG_DESTROYABLE = 0x01,
+    ENDPOINT_FLAG_BRIDGE      = 0x02,
+};
+} // namespace endpoint_flags
+
+namespace attribute_flags {
+enum attribute_flags : uint16_t
+{
+    ATTRIBUTE_FLAG_NONE        = 0x00,
+    ATTRIBUTE_FLAG_WRITABLE    = 0x01,
+    ATTRIBUTE_FLAG_NULLABLE    = 0x02,
+    ATTRIBUTE_FLAG_NONVOLATILE = 0x04,
+    ATTRIBUTE_FLAG_DEFERRED    = 0x08,
+};
+} // namespace attribute_flags
+
+using namespace endpoint_flags;
+using namespace attribute_flags;
+
+typedef void (*event_callback_t)(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg);
+
+/**
+ * @brief Starts the Matter stack. On the host this only marks the stack as started.
+ */
+esp_err_t start(event_callback_t callback, intptr_t callback_arg = 0);
+
+/**
+ * @brief Returns true once start() has been called.
+ */
+bool is_started();
+
+namespace attribute {
+typedef enum callback_type
+{
+    PRE_UPDATE,
+    POST_UPDATE,
+    READ,
+    WRITE,
+} callback_type_t;
+
+typedef esp_err_t (*callback_t)(callback_type_t type, uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id,
+                                esp_matter_attr_val_t * val, void * priv_data);
+
+attribute_t * create(cluster_t * cluster, uint32_t attribute_id, uint16_t flags, esp_matter_attr_val_t val);
+attribute_t * get(cluster_t * cluster, uint32_t attribute_id);
+uint32_t get_id(attribute_t * attribute);
+uint16_t get_flags(attribute_t * attribute);
+esp_err_t get_val(attribute_t * attribute, esp_matter_attr_val_t * val);
+esp_err_t set_val(attribute_t * attribute, esp_matter_attr_val_t * val);
+esp_err_t set_deferred_persistence(attribute_t * attribute);
+
+/**
+ * @brief Updates the value in the data model and notifies subscribers, like esp_matter::attribute::report.
+ */
+esp_err_t report(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t * val);
+
+/**
+ * @brief Writes the value through the application callbacks, like esp_matter::attribute::update.
+ */
+esp_err_t update(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t * val);
+} // namespace attribute
+
+namespace identification {
+typedef enum callback_type
+{
+    START,
+    STOP,
+    EFFECT,
+} callback_type_t;
+
+typedef esp_err_t (*callback_t)(callback_type_t type, uint16_t endpoint_id, uint8_t effect_id, uint8_t effect_variant,
+                                void * priv_data);
+} // namespace identification
+
+namespace lock {
+typedef enum status
+{
+    FAILED,
+    ALREADY_TAKEN,
+    SUCCESS,
+} status_t;
+
+status_t chip_stack_lock(uint32_t ticks_to_wait);
+esp_err_t chip_stack_unlock();
+
+class ScopedChipStackLock
+{
+public:
+    ScopedChipStackLock(uint32_t ticks_to_wait) { status = chip_stack_lock(ticks_to_wait); }
+    ~ScopedChipStackLock()
+    {
+        if (status == SUCCESS)
+        {
+            chip_stack_unlock();
+        }
+    }
+
+private:
+    status_t status;
+};
+} // namespace lock
+
+namespace node {
+typedef struct config
+{
+    uint8_t reserved = 0;
+} config_t;
+
+node_t * create(config_t * config, attribute::callback_t attribute_callback, identification::callback_t identification_callback);
+node_t * get();
+} // namespace node
+
+namespace cluster {
+cluster_t * create(endpoint_t * endpoint, uint32_t cluster_id, uint8_t flags);
+cluster_t * get(endpoint_t * endpoint, uint32_t cluster_id);
+uint32_t get_id(cluster_t * cluster);
+
+namespace bridged_device_basic_information {
+namespace attribute {
+attribute_t * create_node_label(cluster_t * cluster, char * value, uint16_t length);
+} // namespace attribute
+} // namespace bridged_device_basic_information
+
+namespace window_covering {
+namespace feature {
+namespace lift {
+typedef struct config
+{
+    uint16_t number_of_actuations_lift = 0;
+} config_t;
+esp_err_t add(cluster_t * cluster, config_t * config);
+} // namespace lift
+
+namespace position_aware_lift {
+typedef struct config
+{
+    nullable<uint8_t> current_position_lift_percentage;
+    nullable<uint16_t> target_position_lift_percent_100ths;
+    nullable<uint16_t> current_position_lift_percent_100ths;
+} config_t;
+esp_err_t add(cluster_t * cluster, config_t * config);
+} // namespace position_aware_lift
+
+namespace absolute_position {
+typedef struct config
+{
+    uint16_t installed_open_limit_lift   = 0;
+    uint16_t installed_closed_limit_lift = 65534;
+} config_t;
+esp_err_t add(cluster_t * cluster, config_t * config);
+} // namespace absolute_position
+} // namespace feature
+} // namespace window_covering
+
+namespace switch_cluster {
+namespace feature {
+namespace momentary_switch {
+esp_err_t add(cluster_t * cluster);
+} // namespace momentary_switch
+namespace momentary_switch_release {
+esp_err_t add(cluster_t * cluster);
+} // namespace momentary_switch_release
+namespace momentary_switch_long_press {
+esp_err_t add(cluster_t * cluster);
+} // namespace momentary_switch_long_press
+namespace momentary_switch_multi_press {
+typedef struct config
+{
+    uint8_t multi_press_max = 2;
+} config_t;
+esp_err_t add(cluster_t * cluster, config_t * config);
+} // namespace momentary_switch_multi_press
+} // namespace feature
+
+namespace event {
+esp_err_t send_long_press(uint16_t endpoint_id, uint8_t new_position);
+esp_err_t send_multi_press_complete(uint16_t endpoint_id, uint8_t previous_position, uint8_t total_number_of_presses_counted);
+} // namespace event
+} // namespace switch_cluster
+} // namespace cluster
+
+namespace endpoint {
+endpoint_t * create(node_t * node, uint8_t flags, void * priv_data);
+endpoint_t * resume(node_t * node, uint8_t flags, uint16_t endpoint_id, void * priv_data);
+esp_err_t destroy(node_t * node, endpoint_t * endpoint);
+endpoint_t * get(node_t * node, uint16_t endpoint_id);
+uint16_t get_id(endpoint_t * endpoint);
+void * get_priv_data(uint16_t endpoint_id);
+esp_err_t set_parent_endpoint(endpoint_t * endpoint, endpoint_t * parent_endpoint);
+esp_err_t enable(endpoint_t * endpoint);
+
+namespace aggregator {
+typedef struct config
+{
+    uint8_t reserved = 0;
+} config_t;
+endpoint_t * create(node_t * node, config_t * config, uint8_t flags, void * priv_data);
+} // namespace aggregator
+
+namespace bridged_node {
+typedef struct config
+{
+    uint8_t reserved = 0;
+} config_t;
+endpoint_t * create(node_t * node, config_t * config, uint8_t flags, void * priv_data);
+endpoint_t * resume(node_t * node, config_t * config, uint8_t flags, uint16_t endpoint_id, void * priv_data);
+} // namespace bridged_node
+
+namespace on_off_light {
+typedef struct config
+{
+    struct
+    {
+        bool on_off = false;
+        struct
+        {
+            bool global_scene_control = true;
+            nullable<uint16_t> on_time;
+            nullable<uint16_t> off_wait_time;
+            nullable<uint8_t> start_up_on_off;
+        } lighting;
+    } on_off;
+} config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace on_off_light
+
+namespace on_off_plugin_unit {
+typedef on_off_light::config_t config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace on_off_plugin_unit
+
+namespace fan {
+typedef struct config
+{
+    struct
+    {
+        uint8_t fan_mode          = 0;
+        uint8_t fan_mode_sequence = 2;
+        nullable<uint8_t> percent_setting;
+        uint8_t percent_current = 0;
+    } fan_control;
+} config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace fan
+
+namespace door_lock {
+typedef struct config
+{
+    struct
+    {
+        nullable<uint8_t> lock_state;
+        uint8_t lock_type     = 0;
+        bool actuator_enabled = true;
+    } door_lock;
+} config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace door_lock
+
+namespace generic_switch {
+typedef struct config
+{
+    struct
+    {
+        uint8_t number_of_positions = 2;
+        uint8_t current_position    = 0;
+    } switch_cluster;
+} config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace generic_switch
+
+namespace window_covering_device {
+typedef struct config
+{
+    struct
+    {
+        uint8_t type               = 0;
+        uint8_t config_status      = 0;
+        uint8_t operational_status = 0;
+        uint8_t end_product_type   = 0;
+        uint8_t mode               = 0;
+    } window_covering;
+} config_t;
+esp_err_t add(endpoint_t * endpoint, config_t * config);
+} // namespace window_covering_device
+} // namespace endpoint
+
+} // namespace esp_matter
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Host stand-in for esp_timer_get_time, microseconds since the process started.
+ */
+int64_t esp_timer_get_time();
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+/**
+ * @brief Host stand-in for FreeRTOS binary semaphores and mutexes, which FreeRTOS also builds on queues.
+ */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    return xQueueCreate(1, 0);
+}
+
+/* Without priority inheritance, which host threads do not need */
+inline SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    SemaphoreHandle_t mutex = xQueueCreate(1, 0);
+    if (mutex != nullptr)
+    {
+        xQueueSend(mutex, nullptr, 0);
+    }
+    return mutex;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return xQueueSend(semaphore, nullptr, 0);
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    return xQueueReceive(semaphore, nullptr, ticksToWait);
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    vQueueDelete(semaphore);
+}
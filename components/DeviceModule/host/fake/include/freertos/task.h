@@ -0,0 +1,28 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @brief Host stand-in for the FreeRTOS task API, backed by detached std::threads.
+ *
+ * Core affinity and priorities are accepted and ignored. vTaskDelete(nullptr) does not end the
+ * calling thread, so task functions must return after calling it.
+ */
+typedef void (*TaskFunction_t)(void * parameter);
+typedef struct FakeTask * TaskHandle_t;
+
+#define tskNO_AFFINITY ((BaseType_t) 0x7FFFFFFF)
+#define configMAX_PRIORITIES 25
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunction, const char * name, uint32_t stackDepth, void * parameter,
+                                   UBaseType_t priority, TaskHandle_t * createdTask, BaseType_t coreId);
+
+inline BaseType_t xTaskCreate(TaskFunction_t taskFunction, const char * name, uint32_t stackDepth, void * parameter,
+                              UBaseType_t priority, TaskHandle_t * createdTask)
+{
+    return xTaskCreatePinnedToCore(taskFunction, name, stackDepth, parameter, priority, createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Host stand-in for the CHIP scalar types and containers referenced by the module.
+ */
+namespace chip {
+
+typedef uint16_t EndpointId;
+typedef uint32_t ClusterId;
+typedef uint32_t AttributeId;
+typedef uint8_t FabricIndex;
+typedef uint64_t NodeId;
+
+template <typename T>
+class Optional
+{
+public:
+    Optional() : m_hasValue(false), m_value() {}
+    explicit Optional(const T & value) : m_hasValue(true), m_value(value) {}
+
+    bool HasValue() const { return m_hasValue; }
+    const T & Value() const { return m_value; }
+
+private:
+    bool m_hasValue;
+    T m_value;
+};
+
+class ByteSpan
+{
+public:
+    ByteSpan() : m_data(nullptr), m_size(0) {}
+    ByteSpan(const uint8_t * data, size_t size) : m_data(data), m_size(size) {}
+
+    const uint8_t * data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t * m_data;
+    size_t m_size;
+};
+
+namespace app {
+namespace DataModel {
+
+template <typename T>
+class Nullable
+{
+public:
+    Nullable() : m_isNull(true), m_value() {}
+    Nullable(const T & value) : m_isNull(false), m_value(value) {}
+
+    bool IsNull() const { return m_isNull; }
+    const T & Value() const { return m_value; }
+
+private:
+    bool m_isNull;
+    T m_value;
+};
+
+} // namespace DataModel
+} // namespace app
+
+} // namespace chip
+
+#define ChipLogProgress(module, format, ...) ((void) 0)
+#define ChipLogError(module, format, ...) ((void) 0)
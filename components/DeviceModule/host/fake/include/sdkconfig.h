@@ -0,0 +1,135 @@
+#pragma once
+
+/**
+ * @brief Host stand-in for the generated sdkconfig.h.
+ *
+ * Mirrors the defaults of Kconfig.projbuild so the module compiles with the same limits as on target.
+ */
+#ifndef CONFIG_D_M_MAX_DEVICE_NAME_LEN
+#define CONFIG_D_M_MAX_DEVICE_NAME_LEN 64
+#endif
+
+#ifndef CONFIG_D_M_ATTRIBUTE_BATCH_CAPACITY
+#define CONFIG_D_M_ATTRIBUTE_BATCH_CAPACITY 8
+#endif
+
+#ifndef CONFIG_D_M_MAX_CHANNELS_PER_DEVICE
+#define CONFIG_D_M_MAX_CHANNELS_PER_DEVICE 16
+#endif
+
+#ifndef CONFIG_D_M_DEVICE_STATS
+#define CONFIG_D_M_DEVICE_STATS 1
+#endif
+
+#ifndef CONFIG_D_M_LATENCY_TRACING
+#define CONFIG_D_M_LATENCY_TRACING 1
+#endif
+
+#ifndef CONFIG_D_M_STACK_LOCK_PROFILER
+#define CONFIG_D_M_STACK_LOCK_PROFILER 1
+#endif
+
+#ifndef CONFIG_D_M_PERSISTENCE_DEFERRED
+#define CONFIG_D_M_PERSISTENCE_DEFERRED 1
+#endif
+
+#ifndef CONFIG_D_M_BOOT_PROFILER
+#define CONFIG_D_M_BOOT_PROFILER 1
+#endif
+
+#ifndef CONFIG_D_M_BOOT_PROFILER_RECORDS
+#define CONFIG_D_M_BOOT_PROFILER_RECORDS 64
+#endif
+
+#ifndef CONFIG_D_M_BOOT_SNAPSHOT
+#define CONFIG_D_M_BOOT_SNAPSHOT 1
+#endif
+
+#ifndef CONFIG_D_M_SNAPSHOT_SAVE_INTERVAL_MS
+#define CONFIG_D_M_SNAPSHOT_SAVE_INTERVAL_MS 60000
+#endif
+
+#ifndef CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES
+#define CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES 64
+#endif
+
+#ifndef CONFIG_D_M_LOG_LEVEL
+#define CONFIG_D_M_LOG_LEVEL 3
+#endif
+
+#ifndef CONFIG_D_M_LOG_TOKENIZED
+#define CONFIG_D_M_LOG_TOKENIZED 0
+#endif
+
+#ifndef CONFIG_D_M_LOG_RING_RECORDS
+#define CONFIG_D_M_LOG_RING_RECORDS 128
+#endif
+
+#ifndef CONFIG_D_M_ACTUATION_QUEUE_LENGTH
+#define CONFIG_D_M_ACTUATION_QUEUE_LENGTH 32
+#endif
+
+#ifndef CONFIG_D_M_ACTUATION_TASK_STACK_SIZE
+#define CONFIG_D_M_ACTUATION_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_D_M_ACTUATION_TASK_PRIORITY
+#define CONFIG_D_M_ACTUATION_TASK_PRIORITY 5
+#endif
+
+#ifndef CONFIG_D_M_ACTUATION_TASK_CORE
+#define CONFIG_D_M_ACTUATION_TASK_CORE -1
+#endif
+
+#ifndef CONFIG_D_M_REPORT_DISPATCHER_SLOTS
+#define CONFIG_D_M_REPORT_DISPATCHER_SLOTS 32
+#endif
+
+#ifndef CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH
+#define CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH 16
+#endif
+
+#ifndef CONFIG_D_M_REPORT_TASK_STACK_SIZE
+#define CONFIG_D_M_REPORT_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_D_M_REPORT_TASK_PRIORITY
+#define CONFIG_D_M_REPORT_TASK_PRIORITY 5
+#endif
+
+#ifndef CONFIG_D_M_BUTTON_DEVICE_POOL_SIZE
+#define CONFIG_D_M_BUTTON_DEVICE_POOL_SIZE 4
+#endif
+
+#ifndef CONFIG_D_M_DOOR_LOCK_DEVICE_POOL_SIZE
+#define CONFIG_D_M_DOOR_LOCK_DEVICE_POOL_SIZE 2
+#endif
+
+#ifndef CONFIG_D_M_FAN_DEVICE_POOL_SIZE
+#define CONFIG_D_M_FAN_DEVICE_POOL_SIZE 2
+#endif
+
+#ifndef CONFIG_D_M_LIGHT_DEVICE_POOL_SIZE
+#define CONFIG_D_M_LIGHT_DEVICE_POOL_SIZE 8
+#endif
+
+#ifndef CONFIG_D_M_MULTI_PLUGIN_DEVICE_POOL_SIZE
+#define CONFIG_D_M_MULTI_PLUGIN_DEVICE_POOL_SIZE 1
+#endif
+
+#ifndef CONFIG_D_M_PLUGIN_DEVICE_POOL_SIZE
+#define CONFIG_D_M_PLUGIN_DEVICE_POOL_SIZE 8
+#endif
+
+#ifndef CONFIG_D_M_TV_LIFTER_DEVICE_POOL_SIZE
+#define CONFIG_D_M_TV_LIFTER_DEVICE_POOL_SIZE 1
+#endif
+
+#ifndef CONFIG_D_M_WINDOW_DEVICE_POOL_SIZE
+#define CONFIG_D_M_WINDOW_DEVICE_POOL_SIZE 4
+#endif
+
+/* esp_matter option, the window of the fake deferred persistence timers */
+#ifndef CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS
+#define CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS 3000
+#endif
@@ -0,0 +1,18 @@
+#include <app/clusters/door-lock-server/door-lock-server.h>
+
+#include <esp_matter.h>
+
+#include "FakeEspMatter.hpp"
+
+DoorLockServer & DoorLockServer::Instance()
+{
+    static DoorLockServer instance;
+    return instance;
+}
+
+bool DoorLockServer::SetLockState(chip::EndpointId endpointId, chip::app::Clusters::DoorLock::DlLockState newLockState)
+{
+    esp_matter_attr_val_t val = esp_matter_nullable_enum8(static_cast<uint8_t>(newLockState));
+    return esp_matter_fake::writeAttribute(endpointId, chip::app::Clusters::DoorLock::Id,
+                                           chip::app::Clusters::DoorLock::Attributes::LockState::Id, val) == ESP_OK;
+}
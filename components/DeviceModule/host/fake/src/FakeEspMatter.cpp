@@ -0,0 +1,1063 @@
+#include "FakeEspMatter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <app/reporting/reporting.h>
+#include <esp_log.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+using namespace chip::app::Clusters;
+
+static const char * TAG = "esp_matter_fake";
+
+struct esp_matter::_attribute_t
+{
+    uint32_t id;
+    uint16_t flags;
+    esp_matter_attr_val_t val;
+    std::string str;
+    bool deferredPending;
+    uint64_t deferredDueMs;
+    _cluster_t * cluster;
+    _attribute_t * next;
+};
+
+struct esp_matter::_cluster_t
+{
+    uint32_t id;
+    uint8_t flags;
+    _endpoint_t * endpoint;
+    _attribute_t * attributes;
+    _cluster_t * next;
+};
+
+struct esp_matter::_endpoint_t
+{
+    uint16_t id;
+    uint8_t flags;
+    void * privData;
+    _endpoint_t * parent;
+    _cluster_t * clusters;
+    _endpoint_t * next;
+};
+
+struct esp_matter::_node_t
+{
+    _endpoint_t * endpoints;
+    uint16_t nextEndpointId;
+    esp_matter::attribute::callback_t attributeCallback;
+    esp_matter::identification::callback_t identificationCallback;
+};
+
+namespace {
+
+esp_matter::node_t * s_node = nullptr;
+bool s_started              = false;
+esp_matter_fake::Counters s_counters;
+uint64_t s_deferredClockMs            = 0;
+uint16_t s_storedMinUnusedEndpointId = 0; /* Stored in NVS by esp_matter, kept by reboot() */
+
+std::timed_mutex s_stackMutex;
+std::atomic<std::thread::id> s_stackOwner;
+
+size_t valueSize(const esp_matter_attr_val_t & val)
+{
+    switch (val.type & ~ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS)
+    {
+    case ESP_MATTER_VAL_TYPE_BOOLEAN:
+    case ESP_MATTER_VAL_TYPE_INT8:
+    case ESP_MATTER_VAL_TYPE_UINT8:
+    case ESP_MATTER_VAL_TYPE_ENUM8:
+    case ESP_MATTER_VAL_TYPE_BITMAP8:
+        return 1;
+    case ESP_MATTER_VAL_TYPE_INT16:
+    case ESP_MATTER_VAL_TYPE_UINT16:
+    case ESP_MATTER_VAL_TYPE_ENUM16:
+    case ESP_MATTER_VAL_TYPE_BITMAP16:
+        return 2;
+    case ESP_MATTER_VAL_TYPE_INTEGER:
+    case ESP_MATTER_VAL_TYPE_FLOAT:
+    case ESP_MATTER_VAL_TYPE_INT32:
+    case ESP_MATTER_VAL_TYPE_UINT32:
+    case ESP_MATTER_VAL_TYPE_BITMAP32:
+        return 4;
+    case ESP_MATTER_VAL_TYPE_INT64:
+    case ESP_MATTER_VAL_TYPE_UINT64:
+        return 8;
+    case ESP_MATTER_VAL_TYPE_CHAR_STRING:
+    case ESP_MATTER_VAL_TYPE_OCTET_STRING:
+        return val.val.a.s;
+    default:
+        return 0;
+    }
+}
+
+/* NVS keeps values of up to 8 bytes in one 32-byte entry, blobs in an index entry, a data header entry and data entries */
+size_t nvsEntries(size_t size)
+{
+    return size <= 8 ? 1 : 2 + (size + 31) / 32;
+}
+
+void storeValInNvs(esp_matter::attribute_t * attribute)
+{
+    size_t size = valueSize(attribute->val);
+    s_counters.nvsWrites++;
+    s_counters.nvsBytes += size;
+    s_counters.nvsEntries += nvsEntries(size);
+}
+
+/* Stores every attribute whose deferred persistence timer expires at or before dueMs */
+void storeDeferredValues(uint64_t dueMs)
+{
+    if (s_node == nullptr)
+    {
+        return;
+    }
+    for (esp_matter::endpoint_t * endpoint = s_node->endpoints; endpoint != nullptr; endpoint = endpoint->next)
+    {
+        for (esp_matter::cluster_t * cluster = endpoint->clusters; cluster != nullptr; cluster = cluster->next)
+        {
+            for (esp_matter::attribute_t * attribute = cluster->attributes; attribute != nullptr; attribute = attribute->next)
+            {
+                if (attribute->deferredPending && attribute->deferredDueMs <= dueMs)
+                {
+                    attribute->deferredPending = false;
+                    storeValInNvs(attribute);
+                }
+            }
+        }
+    }
+}
+
+void destroyEndpoint(esp_matter::endpoint_t * endpoint)
+{
+    esp_matter::cluster_t * cluster = endpoint->clusters;
+    while (cluster != nullptr)
+    {
+        esp_matter::attribute_t * attribute = cluster->attributes;
+        while (attribute != nullptr)
+        {
+            esp_matter::attribute_t * nextAttribute = attribute->next;
+            delete attribute;
+            attribute = nextAttribute;
+        }
+        esp_matter::cluster_t * nextCluster = cluster->next;
+        delete cluster;
+        cluster = nextCluster;
+    }
+    delete endpoint;
+}
+
+esp_matter::attribute_t * findAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId)
+{
+    if (s_node == nullptr)
+    {
+        return nullptr;
+    }
+    for (esp_matter::endpoint_t * endpoint = s_node->endpoints; endpoint != nullptr; endpoint = endpoint->next)
+    {
+        if (endpoint->id != endpointId)
+        {
+            continue;
+        }
+        for (esp_matter::cluster_t * cluster = endpoint->clusters; cluster != nullptr; cluster = cluster->next)
+        {
+            if (cluster->id != clusterId)
+            {
+                continue;
+            }
+            for (esp_matter::attribute_t * attribute = cluster->attributes; attribute != nullptr; attribute = attribute->next)
+            {
+                if (attribute->id == attributeId)
+                {
+                    return attribute;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+esp_matter::endpoint_t * addEndpoint(esp_matter::node_t * node, uint16_t endpointId, uint8_t flags, void * privData)
+{
+    esp_matter::endpoint_t * endpoint = new esp_matter::_endpoint_t();
+    endpoint->id                      = endpointId;
+    endpoint->flags                   = flags;
+    endpoint->privData                = privData;
+    endpoint->parent                  = nullptr;
+    endpoint->clusters                = nullptr;
+    endpoint->next                    = nullptr;
+
+    /* Append, like esp_matter does, so lookups of recent endpoints walk the whole list */
+    esp_matter::endpoint_t ** tail = &node->endpoints;
+    while (*tail != nullptr)
+    {
+        tail = &(*tail)->next;
+    }
+    *tail = endpoint;
+    return endpoint;
+}
+
+esp_matter::attribute_t * createAttribute(esp_matter::cluster_t * cluster, uint32_t attributeId, uint16_t flags,
+                                          esp_matter_attr_val_t val)
+{
+    return esp_matter::attribute::create(cluster, attributeId, flags, val);
+}
+
+esp_matter::cluster_t * getOrCreateCluster(esp_matter::endpoint_t * endpoint, uint32_t clusterId)
+{
+    for (esp_matter::cluster_t * cluster = endpoint->clusters; cluster != nullptr; cluster = cluster->next)
+    {
+        if (cluster->id == clusterId)
+        {
+            return cluster;
+        }
+    }
+    return esp_matter::cluster::create(endpoint, clusterId, 0);
+}
+
+void addIdentifyCluster(esp_matter::endpoint_t * endpoint)
+{
+    esp_matter::cluster_t * cluster = getOrCreateCluster(endpoint, Identify::Id);
+    createAttribute(cluster, Identify::Attributes::IdentifyTime::Id, esp_matter::ATTRIBUTE_FLAG_WRITABLE, esp_matter_uint16(0));
+    createAttribute(cluster, Identify::Attributes::IdentifyType::Id, esp_matter::ATTRIBUTE_FLAG_NONE, esp_matter_enum8(0));
+}
+
+void addOnOffClusters(esp_matter::endpoint_t * endpoint, esp_matter::endpoint::on_off_light::config_t * config)
+{
+    addIdentifyCluster(endpoint);
+    esp_matter::cluster_t * groups = getOrCreateCluster(endpoint, Groups::Id);
+    createAttribute(groups, Groups::Attributes::NameSupport::Id, esp_matter::ATTRIBUTE_FLAG_NONE, esp_matter_bitmap8(0));
+
+    esp_matter::cluster_t * onOff = getOrCreateCluster(endpoint, OnOff::Id);
+    createAttribute(onOff, OnOff::Attributes::OnOff::Id, esp_matter::ATTRIBUTE_FLAG_NONVOLATILE,
+                    esp_matter_bool(config->on_off.on_off));
+    createAttribute(onOff, OnOff::Attributes::GlobalSceneControl::Id, esp_matter::ATTRIBUTE_FLAG_NONE,
+                    esp_matter_bool(config->on_off.lighting.global_scene_control));
+    createAttribute(onOff, OnOff::Attributes::OnTime::Id, esp_matter::ATTRIBUTE_FLAG_WRITABLE,
+                    esp_matter_nullable_uint16(config->on_off.lighting.on_time));
+    createAttribute(onOff, OnOff::Attributes::OffWaitTime::Id, esp_matter::ATTRIBUTE_FLAG_WRITABLE,
+                    esp_matter_nullable_uint16(config->on_off.lighting.off_wait_time));
+    createAttribute(onOff, OnOff::Attributes::StartUpOnOff::Id,
+                    esp_matter::ATTRIBUTE_FLAG_WRITABLE | esp_matter::ATTRIBUTE_FLAG_NONVOLATILE,
+                    esp_matter_nullable_enum8(config->on_off.lighting.start_up_on_off));
+}
+
+} // namespace
+
+esp_log_level_t & esp_log_host_level()
+{
+    static esp_log_level_t level = ESP_LOG_ERROR;
+    return level;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------- */
+/* esp_matter                                                                                                       */
+/* ---------------------------------------------------------------------------------------------------------------- */
+
+namespace esp_matter {
+
+esp_err_t start(event_callback_t callback, intptr_t callback_arg)
+{
+    (void) callback;
+    (void) callback_arg;
+    s_started = true;
+    // esp_matter reads the minimum unused endpoint id from NVS as it starts
+    if (s_node != nullptr && s_node->nextEndpointId < s_storedMinUnusedEndpointId)
+    {
+        s_node->nextEndpointId = s_storedMinUnusedEndpointId;
+    }
+    return ESP_OK;
+}
+
+bool is_started()
+{
+    return s_started;
+}
+
+namespace lock {
+status_t chip_stack_lock(uint32_t ticks_to_wait)
+{
+    if (s_stackOwner.load() == std::this_thread::get_id())
+    {
+        s_counters.lockAlreadyTaken++;
+        return ALREADY_TAKEN;
+    }
+
+    if (ticks_to_wait == portMAX_DELAY)
+    {
+        s_stackMutex.lock();
+    }
+    else if (!s_stackMutex.try_lock_for(std::chrono::milliseconds(ticks_to_wait * portTICK_PERIOD_MS)))
+    {
+        s_counters.lockFailures++;
+        return FAILED;
+    }
+
+    s_stackOwner.store(std::this_thread::get_id());
+    s_counters.lockAcquisitions++;
+    return SUCCESS;
+}
+
+esp_err_t chip_stack_unlock()
+{
+    s_stackOwner.store(std::thread::id());
+    s_stackMutex.unlock();
+    return ESP_OK;
+}
+} // namespace lock
+
+namespace node {
+node_t * create(config_t * config, attribute::callback_t attribute_callback, identification::callback_t identification_callback)
+{
+    (void) config;
+    if (s_node != nullptr)
+    {
+        return s_node;
+    }
+
+    s_node                         = new _node_t();
+    s_node->endpoints              = nullptr;
+    s_node->nextEndpointId         = 0;
+    s_node->attributeCallback      = attribute_callback;
+    s_node->identificationCallback = identification_callback;
+
+    endpoint_t * root = endpoint::create(s_node, ENDPOINT_FLAG_NONE, nullptr);
+    cluster::create(root, Descriptor::Id, 0);
+    return s_node;
+}
+
+node_t * get()
+{
+    return s_node;
+}
+} // namespace node
+
+namespace endpoint {
+endpoint_t * create(node_t * node, uint8_t flags, void * priv_data)
+{
+    if (node == nullptr)
+    {
+        ESP_LOGE(TAG, "Node cannot be NULL");
+        return nullptr;
+    }
+
+    endpoint_t * endpoint = addEndpoint(node, node->nextEndpointId++, flags, priv_data);
+    // Endpoints created before esp_matter::start are expected to come back in the same order
+    if (s_started)
+    {
+        s_storedMinUnusedEndpointId = node->nextEndpointId;
+    }
+    return endpoint;
+}
+
+endpoint_t * resume(node_t * node, uint8_t flags, uint16_t endpoint_id, void * priv_data)
+{
+    if (node == nullptr)
+    {
+        ESP_LOGE(TAG, "Node cannot be NULL");
+        return nullptr;
+    }
+    for (endpoint_t * endpoint = node->endpoints; endpoint != nullptr; endpoint = endpoint->next)
+    {
+        if (endpoint->id == endpoint_id)
+        {
+            ESP_LOGE(TAG, "Could not resume an endpoint that has been added to the node");
+            return nullptr;
+        }
+    }
+    if (endpoint_id >= node->nextEndpointId)
+    {
+        ESP_LOGE(TAG, "The endpoint_id of the resumed endpoint should have been used");
+        return nullptr;
+    }
+    return addEndpoint(node, endpoint_id, flags, priv_data);
+}
+
+esp_err_t destroy(node_t * node, endpoint_t * endpoint)
+{
+    if (node == nullptr || endpoint == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if ((endpoint->flags & ENDPOINT_FLAG_DESTROYABLE) == 0)
+    {
+        ESP_LOGE(TAG, "This endpoint cannot be deleted since the ENDPOINT_FLAG_DESTROYABLE is not set");
+        return ESP_FAIL;
+    }
+
+    endpoint_t ** link = &node->endpoints;
+    while (*link != nullptr && *link != endpoint)
+    {
+        link = &(*link)->next;
+    }
+    if (*link == nullptr)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *link = endpoint->next;
+    destroyEndpoint(endpoint);
+    return ESP_OK;
+}
+
+endpoint_t * get(node_t * node, uint16_t endpoint_id)
+{
+    s_counters.endpointLookups++;
+    if (node == nullptr)
+    {
+        return nullptr;
+    }
+    for (endpoint_t * endpoint = node->endpoints; endpoint != nullptr; endpoint = endpoint->next)
+    {
+        s_counters.lookupSteps++;
+        if (endpoint->id == endpoint_id)
+        {
+            return endpoint;
+        }
+    }
+    return nullptr;
+}
+
+uint16_t get_id(endpoint_t * endpoint)
+{
+    return endpoint == nullptr ? 0xFFFF : endpoint->id;
+}
+
+void * get_priv_data(uint16_t endpoint_id)
+{
+    endpoint_t * endpoint = get(node::get(), endpoint_id);
+    return endpoint == nullptr ? nullptr : endpoint->privData;
+}
+
+esp_err_t set_parent_endpoint(endpoint_t * endpoint, endpoint_t * parent_endpoint)
+{
+    if (endpoint == nullptr || parent_endpoint == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    endpoint->parent = parent_endpoint;
+    return ESP_OK;
+}
+
+esp_err_t enable(endpoint_t * endpoint)
+{
+    return endpoint == nullptr ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+
+namespace aggregator {
+endpoint_t * create(node_t * node, config_t * config, uint8_t flags, void * priv_data)
+{
+    (void) config;
+    endpoint_t * endpoint = endpoint::create(node, flags, priv_data);
+    if (endpoint != nullptr)
+    {
+        cluster::create(endpoint, Descriptor::Id, 0);
+    }
+    return endpoint;
+}
+} // namespace aggregator
+
+namespace bridged_node {
+static endpoint_t * addClusters(endpoint_t * endpoint)
+{
+    if (endpoint == nullptr)
+    {
+        return nullptr;
+    }
+    cluster::create(endpoint, Descriptor::Id, 0);
+    cluster_t * basicInformation = cluster::create(endpoint, BridgedDeviceBasicInformation::Id, 0);
+    attribute::create(basicInformation, BridgedDeviceBasicInformation::Attributes::Reachable::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_bool(true));
+    return endpoint;
+}
+
+endpoint_t * create(node_t * node, config_t * config, uint8_t flags, void * priv_data)
+{
+    (void) config;
+    return addClusters(endpoint::create(node, flags, priv_data));
+}
+
+endpoint_t * resume(node_t * node, config_t * config, uint8_t flags, uint16_t endpoint_id, void * priv_data)
+{
+    (void) config;
+    return addClusters(endpoint::resume(node, flags, endpoint_id, priv_data));
+}
+} // namespace bridged_node
+
+namespace on_off_light {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addOnOffClusters(endpoint, config);
+    return ESP_OK;
+}
+} // namespace on_off_light
+
+namespace on_off_plugin_unit {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addOnOffClusters(endpoint, config);
+    return ESP_OK;
+}
+} // namespace on_off_plugin_unit
+
+namespace fan {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addIdentifyCluster(endpoint);
+    cluster_t * cluster = getOrCreateCluster(endpoint, FanControl::Id);
+    attribute::create(cluster, FanControl::Attributes::FanMode::Id, ATTRIBUTE_FLAG_WRITABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_enum8(config->fan_control.fan_mode));
+    attribute::create(cluster, FanControl::Attributes::FanModeSequence::Id, ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_enum8(config->fan_control.fan_mode_sequence));
+    attribute::create(cluster, FanControl::Attributes::PercentSetting::Id,
+                      ATTRIBUTE_FLAG_WRITABLE | ATTRIBUTE_FLAG_NULLABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_nullable_uint8(config->fan_control.percent_setting));
+    attribute::create(cluster, FanControl::Attributes::PercentCurrent::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_uint8(config->fan_control.percent_current));
+    return ESP_OK;
+}
+} // namespace fan
+
+namespace door_lock {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addIdentifyCluster(endpoint);
+    cluster_t * cluster = getOrCreateCluster(endpoint, DoorLock::Id);
+    attribute::create(cluster, DoorLock::Attributes::LockState::Id, ATTRIBUTE_FLAG_NULLABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_nullable_enum8(config->door_lock.lock_state));
+    attribute::create(cluster, DoorLock::Attributes::LockType::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_enum8(config->door_lock.lock_type));
+    attribute::create(cluster, DoorLock::Attributes::ActuatorEnabled::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_bool(config->door_lock.actuator_enabled));
+    return ESP_OK;
+}
+} // namespace door_lock
+
+namespace generic_switch {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addIdentifyCluster(endpoint);
+    cluster_t * cluster = getOrCreateCluster(endpoint, Switch::Id);
+    attribute::create(cluster, Switch::Attributes::NumberOfPositions::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_uint8(config->switch_cluster.number_of_positions));
+    attribute::create(cluster, Switch::Attributes::CurrentPosition::Id, ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_uint8(config->switch_cluster.current_position));
+    return ESP_OK;
+}
+} // namespace generic_switch
+
+namespace window_covering_device {
+esp_err_t add(endpoint_t * endpoint, config_t * config)
+{
+    if (endpoint == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    addIdentifyCluster(endpoint);
+    cluster_t * cluster = getOrCreateCluster(endpoint, WindowCovering::Id);
+    attribute::create(cluster, WindowCovering::Attributes::Type::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_enum8(config->window_covering.type));
+    attribute::create(cluster, WindowCovering::Attributes::ConfigStatus::Id, ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_bitmap8(config->window_covering.config_status));
+    attribute::create(cluster, WindowCovering::Attributes::OperationalStatus::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_bitmap8(config->window_covering.operational_status));
+    attribute::create(cluster, WindowCovering::Attributes::EndProductType::Id, ATTRIBUTE_FLAG_NONE,
+                      esp_matter_enum8(config->window_covering.end_product_type));
+    attribute::create(cluster, WindowCovering::Attributes::Mode::Id, ATTRIBUTE_FLAG_WRITABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                      esp_matter_bitmap8(config->window_covering.mode));
+    return ESP_OK;
+}
+} // namespace window_covering_device
+} // namespace endpoint
+
+namespace cluster {
+cluster_t * create(endpoint_t * endpoint, uint32_t cluster_id, uint8_t flags)
+{
+    if (endpoint == nullptr)
+    {
+        return nullptr;
+    }
+
+    cluster_t * cluster = new _cluster_t();
+    cluster->id         = cluster_id;
+    cluster->flags      = flags;
+    cluster->endpoint   = endpoint;
+    cluster->attributes = nullptr;
+    cluster->next       = nullptr;
+
+    cluster_t ** tail = &endpoint->clusters;
+    while (*tail != nullptr)
+    {
+        tail = &(*tail)->next;
+    }
+    *tail = cluster;
+    return cluster;
+}
+
+cluster_t * get(endpoint_t * endpoint, uint32_t cluster_id)
+{
+    s_counters.clusterLookups++;
+    if (endpoint == nullptr)
+    {
+        return nullptr;
+    }
+    for (cluster_t * cluster = endpoint->clusters; cluster != nullptr; cluster = cluster->next)
+    {
+        s_counters.lookupSteps++;
+        if (cluster->id == cluster_id)
+        {
+            return cluster;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t get_id(cluster_t * cluster)
+{
+    return cluster == nullptr ? 0xFFFFFFFF : cluster->id;
+}
+
+namespace bridged_device_basic_information {
+namespace attribute {
+attribute_t * create_node_label(cluster_t * cluster, char * value, uint16_t length)
+{
+    return esp_matter::attribute::create(cluster, BridgedDeviceBasicInformation::Attributes::NodeLabel::Id,
+                                         ATTRIBUTE_FLAG_WRITABLE | ATTRIBUTE_FLAG_NONVOLATILE, esp_matter_char_str(value, length));
+}
+} // namespace attribute
+} // namespace bridged_device_basic_information
+
+namespace window_covering {
+namespace feature {
+namespace lift {
+esp_err_t add(cluster_t * cluster, config_t * config)
+{
+    if (cluster == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+} // namespace lift
+
+namespace position_aware_lift {
+esp_err_t add(cluster_t * cluster, config_t * config)
+{
+    if (cluster == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_matter::attribute::create(cluster, WindowCovering::Attributes::CurrentPositionLiftPercentage::Id,
+                                  ATTRIBUTE_FLAG_NULLABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                                  esp_matter_nullable_uint8(config->current_position_lift_percentage));
+    esp_matter::attribute::create(cluster, WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
+                                  ATTRIBUTE_FLAG_NULLABLE, esp_matter_nullable_uint16(config->target_position_lift_percent_100ths));
+    esp_matter::attribute::create(cluster, WindowCovering::Attributes::CurrentPositionLiftPercent100ths::Id,
+                                  ATTRIBUTE_FLAG_NULLABLE | ATTRIBUTE_FLAG_NONVOLATILE,
+                                  esp_matter_nullable_uint16(config->current_position_lift_percent_100ths));
+    return ESP_OK;
+}
+} // namespace position_aware_lift
+
+namespace absolute_position {
+esp_err_t add(cluster_t * cluster, config_t * config)
+{
+    if (cluster == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_matter::attribute::create(cluster, WindowCovering::Attributes::InstalledOpenLimitLift::Id, ATTRIBUTE_FLAG_NONVOLATILE,
+                                  esp_matter_uint16(config->installed_open_limit_lift));
+    esp_matter::attribute::create(cluster, WindowCovering::Attributes::InstalledClosedLimitLift::Id, ATTRIBUTE_FLAG_NONVOLATILE,
+                                  esp_matter_uint16(config->installed_closed_limit_lift));
+    return ESP_OK;
+}
+} // namespace absolute_position
+} // namespace feature
+} // namespace window_covering
+
+namespace switch_cluster {
+namespace feature {
+namespace momentary_switch {
+esp_err_t add(cluster_t * cluster)
+{
+    return cluster == nullptr ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+} // namespace momentary_switch
+
+namespace momentary_switch_release {
+esp_err_t add(cluster_t * cluster)
+{
+    return cluster == nullptr ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+} // namespace momentary_switch_release
+
+namespace momentary_switch_long_press {
+esp_err_t add(cluster_t * cluster)
+{
+    return cluster == nullptr ? ESP_ERR_INVALID_ARG : ESP_OK;
+}
+} // namespace momentary_switch_long_press
+
+namespace momentary_switch_multi_press {
+esp_err_t add(cluster_t * cluster, config_t * config)
+{
+    if (cluster == nullptr || config == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_matter::attribute::create(cluster, Switch::Attributes::MultiPressMax::Id, ATTRIBUTE_FLAG_NONE,
+                                  esp_matter_uint8(config->multi_press_max));
+    return ESP_OK;
+}
+} // namespace momentary_switch_multi_press
+} // namespace feature
+
+namespace event {
+esp_err_t send_long_press(uint16_t endpoint_id, uint8_t new_position)
+{
+    (void) endpoint_id;
+    (void) new_position;
+    s_counters.events++;
+    return ESP_OK;
+}
+
+esp_err_t send_multi_press_complete(uint16_t endpoint_id, uint8_t previous_position, uint8_t total_number_of_presses_counted)
+{
+    (void) endpoint_id;
+    (void) previous_position;
+    (void) total_number_of_presses_counted;
+    s_counters.events++;
+    return ESP_OK;
+}
+} // namespace event
+} // namespace switch_cluster
+} // namespace cluster
+
+namespace attribute {
+attribute_t * create(cluster_t * cluster, uint32_t attribute_id, uint16_t flags, esp_matter_attr_val_t val)
+{
+    if (cluster == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (attribute_t * existing = cluster->attributes; existing != nullptr; existing = existing->next)
+    {
+        if (existing->id == attribute_id)
+        {
+            return existing;
+        }
+    }
+
+    attribute_t * attribute    = new _attribute_t();
+    attribute->id              = attribute_id;
+    attribute->flags           = flags;
+    attribute->deferredPending = false;
+    attribute->deferredDueMs   = 0;
+    attribute->cluster         = cluster;
+    attribute->next            = nullptr;
+    attribute->val             = val;
+    // esp_matter loads the stored value of every non-volatile attribute from NVS as it creates it
+    if (flags & ATTRIBUTE_FLAG_NONVOLATILE)
+    {
+        s_counters.nvsReads++;
+    }
+    if (val.type == ESP_MATTER_VAL_TYPE_CHAR_STRING || val.type == ESP_MATTER_VAL_TYPE_OCTET_STRING)
+    {
+        attribute->str.assign(reinterpret_cast<const char *>(val.val.a.b), val.val.a.s);
+        attribute->val.val.a.b = reinterpret_cast<uint8_t *>(&attribute->str[0]);
+    }
+
+    attribute_t ** tail = &cluster->attributes;
+    while (*tail != nullptr)
+    {
+        tail = &(*tail)->next;
+    }
+    *tail = attribute;
+    return attribute;
+}
+
+attribute_t * get(cluster_t * cluster, uint32_t attribute_id)
+{
+    s_counters.attributeLookups++;
+    if (cluster == nullptr)
+    {
+        return nullptr;
+    }
+    for (attribute_t * attribute = cluster->attributes; attribute != nullptr; attribute = attribute->next)
+    {
+        s_counters.lookupSteps++;
+        if (attribute->id == attribute_id)
+        {
+            return attribute;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t get_id(attribute_t * attribute)
+{
+    return attribute == nullptr ? 0xFFFFFFFF : attribute->id;
+}
+
+uint16_t get_flags(attribute_t * attribute)
+{
+    return attribute == nullptr ? 0 : attribute->flags;
+}
+
+esp_err_t get_val(attribute_t * attribute, esp_matter_attr_val_t * val)
+{
+    if (attribute == nullptr || val == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_counters.getVals++;
+    *val = attribute->val;
+    return ESP_OK;
+}
+
+esp_err_t set_val(attribute_t * attribute, esp_matter_attr_val_t * val)
+{
+    if (attribute == nullptr || val == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_counters.setVals++;
+    if (val->type == ESP_MATTER_VAL_TYPE_CHAR_STRING || val->type == ESP_MATTER_VAL_TYPE_OCTET_STRING)
+    {
+        attribute->str.assign(reinterpret_cast<const char *>(val->val.a.b), val->val.a.s);
+        attribute->val         = *val;
+        attribute->val.val.a.b = reinterpret_cast<uint8_t *>(&attribute->str[0]);
+    }
+    else
+    {
+        attribute->val = *val;
+    }
+
+    /* Same policy as esp_matter: non-volatile attributes are stored on every set, unless deferred, in which case the
+     * first pending change starts a timer that stores the value when the deferral window ends */
+    if (attribute->flags & ATTRIBUTE_FLAG_NONVOLATILE)
+    {
+        if (attribute->flags & ATTRIBUTE_FLAG_DEFERRED)
+        {
+            if (!attribute->deferredPending)
+            {
+                attribute->deferredPending = true;
+                attribute->deferredDueMs   = s_deferredClockMs + CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS;
+            }
+        }
+        else
+        {
+            storeValInNvs(attribute);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t set_deferred_persistence(attribute_t * attribute)
+{
+    if (attribute == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if ((attribute->flags & ATTRIBUTE_FLAG_NONVOLATILE) == 0)
+    {
+        ESP_LOGE(TAG, "Attribute should be non-volatile to set a deferred persistence time");
+        return ESP_ERR_INVALID_ARG;
+    }
+    attribute->flags |= ATTRIBUTE_FLAG_DEFERRED;
+    return ESP_OK;
+}
+
+esp_err_t report(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t * val)
+{
+    endpoint_t * endpoint   = endpoint::get(node::get(), endpoint_id);
+    cluster_t * cluster     = cluster::get(endpoint, cluster_id);
+    attribute_t * attribute = get(cluster, attribute_id);
+    if (attribute == nullptr)
+    {
+        ESP_LOGE(TAG, "Couldn't find attribute 0x%08x on endpoint 0x%04x", (unsigned) attribute_id, endpoint_id);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "********** R : Endpoint 0x%04x's Cluster 0x%08x's Attribute 0x%08x **********", endpoint_id,
+             (unsigned) cluster_id, (unsigned) attribute_id);
+    esp_err_t err = set_val(attribute, val);
+    if (err == ESP_OK)
+    {
+        /* MatterReportingAttributeChangeCallback must run with the stack lock held */
+        lock::ScopedChipStackLock lock(portMAX_DELAY);
+        MatterReportingAttributeChangeCallback(endpoint_id, cluster_id, attribute_id);
+    }
+    return err;
+}
+
+esp_err_t update(uint16_t endpoint_id, uint32_t cluster_id, uint32_t attribute_id, esp_matter_attr_val_t * val)
+{
+    if (val == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    lock::ScopedChipStackLock lock(portMAX_DELAY);
+    return esp_matter_fake::writeAttribute(endpoint_id, cluster_id, attribute_id, *val);
+}
+} // namespace attribute
+
+} // namespace esp_matter
+
+void MatterReportingAttributeChangeCallback(chip::EndpointId endpoint, chip::ClusterId clusterId, chip::AttributeId attributeId)
+{
+    if (s_stackOwner.load() != std::this_thread::get_id())
+    {
+        ESP_LOGE(TAG, "Attribute 0x%08x of endpoint 0x%04x reported without holding the chip stack lock", (unsigned) attributeId,
+                 endpoint);
+    }
+    (void) clusterId;
+    s_counters.reports++;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------- */
+/* Fake control API                                                                                                 */
+/* ---------------------------------------------------------------------------------------------------------------- */
+
+namespace esp_matter_fake {
+
+const Counters & counters()
+{
+    return s_counters;
+}
+
+void resetCounters()
+{
+    s_counters = Counters();
+}
+
+void reboot()
+{
+    if (s_node != nullptr)
+    {
+        esp_matter::endpoint_t * endpoint = s_node->endpoints;
+        while (endpoint != nullptr)
+        {
+            esp_matter::endpoint_t * next = endpoint->next;
+            destroyEndpoint(endpoint);
+            endpoint = next;
+        }
+        delete s_node;
+        s_node = nullptr;
+    }
+    s_started         = false;
+    s_deferredClockMs = 0;
+    resetCounters();
+}
+
+void reset()
+{
+    reboot();
+    s_storedMinUnusedEndpointId = 0;
+}
+
+esp_err_t writeAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t val)
+{
+    esp_matter::attribute_t * attribute = findAttribute(endpointId, clusterId, attributeId);
+    if (attribute == nullptr)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    void * privData                            = attribute->cluster->endpoint->privData;
+    esp_matter::attribute::callback_t callback = s_node->attributeCallback;
+    esp_err_t err                              = ESP_OK;
+    if (callback != nullptr)
+    {
+        err = callback(esp_matter::attribute::PRE_UPDATE, endpointId, clusterId, attributeId, &val, privData);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    esp_matter::attribute::set_val(attribute, &val);
+
+    if (callback != nullptr)
+    {
+        err = callback(esp_matter::attribute::POST_UPDATE, endpointId, clusterId, attributeId, &val, privData);
+    }
+    return err;
+}
+
+esp_err_t storeAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t val)
+{
+    esp_matter::attribute_t * attribute = findAttribute(endpointId, clusterId, attributeId);
+    if (attribute == nullptr)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    attribute->val = val;
+    return ESP_OK;
+}
+
+esp_err_t readAttribute(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val)
+{
+    esp_matter::attribute_t * attribute = findAttribute(endpointId, clusterId, attributeId);
+    if (attribute == nullptr || val == nullptr)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *val = attribute->val;
+    return ESP_OK;
+}
+
+void flushDeferredPersistence()
+{
+    storeDeferredValues(UINT64_MAX);
+}
+
+void advanceDeferredPersistence(uint32_t elapsedMs)
+{
+    s_deferredClockMs += elapsedMs;
+    storeDeferredValues(s_deferredClockMs);
+}
+
+uint16_t endpointCount()
+{
+    uint16_t count = 0;
+    if (s_node != nullptr)
+    {
+        for (esp_matter::endpoint_t * endpoint = s_node->endpoints; endpoint != nullptr; endpoint = endpoint->next)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+} // namespace esp_matter_fake
@@ -0,0 +1,143 @@
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct FakeQueue
+{
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::vector<uint8_t> storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+namespace {
+
+/* Waits on a condition for at most ticksToWait, forever for portMAX_DELAY */
+template <typename Predicate>
+bool waitFor(std::condition_variable & condition, std::unique_lock<std::mutex> & lock, TickType_t ticksToWait, Predicate ready)
+{
+    if (ticksToWait == portMAX_DELAY)
+    {
+        condition.wait(lock, ready);
+        return true;
+    }
+    return condition.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), ready);
+}
+
+const std::chrono::steady_clock::time_point s_bootTime = std::chrono::steady_clock::now();
+
+} // namespace
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    if (length == 0)
+    {
+        return nullptr;
+    }
+
+    FakeQueue * queue = new FakeQueue();
+    queue->storage.resize(static_cast<size_t>(length) * itemSize);
+    queue->length   = length;
+    queue->itemSize = itemSize;
+    queue->head     = 0;
+    queue->count    = 0;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void * item, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->notFull, lock, ticksToWait, [queue] { return queue->count < queue->length; }))
+    {
+        return pdFAIL;
+    }
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    if (queue->itemSize > 0)
+    {
+        memcpy(&queue->storage[static_cast<size_t>(tail) * queue->itemSize], item, queue->itemSize);
+    }
+    queue->count++;
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void * buffer, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->notEmpty, lock, ticksToWait, [queue] { return queue->count > 0; }))
+    {
+        return pdFAIL;
+    }
+
+    if (queue->itemSize > 0)
+    {
+        memcpy(buffer, &queue->storage[static_cast<size_t>(queue->head) * queue->itemSize], queue->itemSize);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->notFull.notify_one();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->count;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskFunction, const char * name, uint32_t stackDepth, void * parameter,
+                                   UBaseType_t priority, TaskHandle_t * createdTask, BaseType_t coreId)
+{
+    (void) name;
+    (void) stackDepth;
+    (void) priority;
+    (void) coreId;
+
+    std::thread(taskFunction, parameter).detach();
+    if (createdTask != nullptr)
+    {
+        /* Threads are detached, the handle only tells callers that the task exists */
+        *createdTask = reinterpret_cast<TaskHandle_t>(taskFunction);
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void) task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return static_cast<TickType_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - s_bootTime).count() /
+        portTICK_PERIOD_MS);
+}
+
+int64_t esp_timer_get_time()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_bootTime).count();
+}
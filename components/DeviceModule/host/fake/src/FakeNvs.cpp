@@ -0,0 +1,174 @@
+#include "FakeNvs.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nvs.h>
+
+namespace {
+
+struct Handle
+{
+    std::string name;
+    bool writable;
+};
+
+std::mutex s_mutex;
+std::map<std::string, std::vector<uint8_t>> s_blobs;
+std::vector<Handle> s_handles;
+nvs_fake::Counters s_counters;
+
+/* Handles are 1-based indexes into s_handles, 0 is never a valid handle */
+Handle * findHandle(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > s_handles.size() || s_handles[handle - 1].name.empty())
+    {
+        return nullptr;
+    }
+    return &s_handles[handle - 1];
+}
+
+std::string blobKey(const Handle & handle, const char * key)
+{
+    return handle.name + '\0' + key;
+}
+
+bool namespaceExists(const std::string & name)
+{
+    std::string prefix = name + '\0';
+    auto it            = s_blobs.lower_bound(prefix);
+    return it != s_blobs.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace
+
+esp_err_t nvs_open(const char * name, nvs_open_mode_t open_mode, nvs_handle_t * out_handle)
+{
+    if (name == nullptr || name[0] == '\0' || out_handle == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::lock_guard<std::mutex> guard(s_mutex);
+    // Like NVS, a read-only open of a namespace that was never written fails
+    if (open_mode == NVS_READONLY && !namespaceExists(name))
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    s_handles.push_back({ name, open_mode == NVS_READWRITE });
+    *out_handle = static_cast<nvs_handle_t>(s_handles.size());
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char * key, void * out_value, size_t * length)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    Handle * entry = findHandle(handle);
+    if (entry == nullptr)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (key == nullptr || length == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    auto it = s_blobs.find(blobKey(*entry, key));
+    if (it == s_blobs.end())
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_value == nullptr)
+    {
+        *length = it->second.size();
+        return ESP_OK;
+    }
+    if (*length < it->second.size())
+    {
+        *length = it->second.size();
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    std::copy(it->second.begin(), it->second.end(), static_cast<uint8_t *>(out_value));
+    *length = it->second.size();
+    s_counters.reads++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char * key, const void * value, size_t length)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    Handle * entry = findHandle(handle);
+    if (entry == nullptr || !entry->writable)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (key == nullptr || (value == nullptr && length > 0))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint8_t * bytes         = static_cast<const uint8_t *>(value);
+    s_blobs[blobKey(*entry, key)] = std::vector<uint8_t>(bytes, bytes + length);
+    s_counters.writes++;
+    s_counters.bytes += length;
+    // A blob takes an index entry, a data header entry and its data entries
+    s_counters.nvsEntries += 2 + (length + 31) / 32;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char * key)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    Handle * entry = findHandle(handle);
+    if (entry == nullptr || !entry->writable)
+    {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (key == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return s_blobs.erase(blobKey(*entry, key)) > 0 ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    return findHandle(handle) != nullptr ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    Handle * entry = findHandle(handle);
+    if (entry != nullptr)
+    {
+        entry->name.clear();
+    }
+}
+
+namespace nvs_fake {
+
+const Counters & counters()
+{
+    return s_counters;
+}
+
+void resetCounters()
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    s_counters = Counters();
+}
+
+void erase()
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    s_blobs.clear();
+    s_counters = Counters();
+}
+
+} // namespace nvs_fake
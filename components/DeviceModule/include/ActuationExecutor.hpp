@@ -0,0 +1,189 @@
+#pragma once
+
+#include "BaseDeviceInterface.hpp"
+#include <atomic>
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Runs accessory actuation on a dedicated FreeRTOS task instead of the Matter task.
+ *
+ * The attribute callback submits the written value and returns at once; the executor task then calls
+ * the value-carrying updateAccessory of the device, so slow accessories (blind motors, relays, lock
+ * actuators) never block message processing. Writes run in submission order on one task, so a device
+ * never sees two of its writes at once.
+ *
+ * Pending writes wait in mailboxes keyed by (device, endpoint, cluster, attribute), latest wins: a write
+ * to an attribute that still has one pending replaces its value instead of queueing again. A slider drag
+ * that streams TargetPositionLiftPercent100ths or PercentSetting writes faster than the accessory moves
+ * therefore costs one actuation with the newest value, and the queue only ever holds distinct attributes.
+ * The replaced write keeps its place in the queue.
+ *
+ * The task is sized and placed by the D_M_ACTUATION_* options and can be pinned to the core the Matter
+ * task does not run on. Submission never blocks: when every mailbox is used the write is rejected and the
+ * caller applies it itself.
+ *
+ * Call cancel() before destroying a device; DeviceRegistry does so for the executor set with
+ * setActuationExecutor().
+ */
+class ActuationExecutor
+{
+public:
+    /**
+     * @brief Constructor for ActuationExecutor, the task is created by start().
+     */
+    ActuationExecutor();
+
+    /**
+     * @brief Destructor for ActuationExecutor, stops the task after the queued writes ran.
+     */
+    ~ActuationExecutor();
+
+    /**
+     * @brief Creates the queue and the executor task.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Runs the queued writes, then stops and deletes the executor task.
+     */
+    void stop();
+
+    /**
+     * @brief Queues a written attribute value for the device, without blocking.
+     * @param device Device the write is for.
+     * @param endpointId ID of the written endpoint.
+     * @param clusterId ID of the written cluster.
+     * @param attributeId ID of the written attribute.
+     * @param val The written value, copied into the mailbox of the attribute.
+     * @return ESP_OK if queued or merged into a pending write, ESP_ERR_INVALID_STATE if not started,
+     *         ESP_ERR_NOT_SUPPORTED for string and array values, which only live as long as the callback,
+     *         ESP_ERR_NO_MEM if every mailbox is used.
+     */
+    esp_err_t submit(BaseDeviceInterface * device, uint16_t endpointId, uint32_t clusterId, uint32_t attributeId,
+                     const esp_matter_attr_val_t * val);
+
+    /**
+     * @brief Waits until every write submitted before the call has run.
+     *
+     * Must not be called from the executor task, i.e. from an accessory driven by it.
+     * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not started.
+     */
+    esp_err_t flush();
+
+    /**
+     * @brief Drops the pending writes of a device and waits for a write of it that is already running.
+     *
+     * Called before the device is destroyed, under the chip stack lock, so a running write that waits for the
+     * lock deadlocks the stack. Device handlers never take it themselves: state they write back goes through
+     * requestReport(), which only takes it inline for devices not attached to a ReportDispatcher. Use the
+     * executor together with a dispatcher when devices are removed at runtime. Must not be called from the
+     * executor task.
+     * @param device Device about to be destroyed.
+     */
+    void cancel(BaseDeviceInterface * device);
+
+    /**
+     * @brief Returns true between start() and stop().
+     */
+    bool isRunning() const { return m_queue != nullptr; }
+
+    /**
+     * @brief Returns the number of writes run by the executor task.
+     */
+    uint32_t executed() const { return m_executed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of writes replaced by a newer write before they ran.
+     */
+    uint32_t coalesced() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of writes rejected because every mailbox was used.
+     */
+    uint32_t overflows() const { return m_overflows.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of pending writes dropped by cancel().
+     */
+    uint32_t cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Queue item.
+     */
+    struct Work
+    {
+        /**
+         * @brief What the executor task does with the item.
+         */
+        enum Kind : uint8_t
+        {
+            UPDATE, /**< Run the write pending in a mailbox. */
+            FLUSH,  /**< Give the done semaphore. */
+            STOP,   /**< Give the done semaphore and end the task. */
+        };
+
+        Kind kind;              /**< What to do. */
+        uint8_t mailbox;        /**< Mailbox of an UPDATE. */
+        SemaphoreHandle_t done; /**< Semaphore of a FLUSH or STOP. */
+    };
+
+    /**
+     * @brief Newest pending write of one attribute.
+     */
+    struct Mailbox
+    {
+        BaseDeviceInterface * device; /**< Device of the write, nullptr if the mailbox is free. */
+        uint16_t endpointId;          /**< ID of the written endpoint. */
+        uint32_t clusterId;           /**< ID of the written cluster. */
+        uint32_t attributeId;         /**< ID of the written attribute. */
+        esp_matter_attr_val_t val;    /**< Newest written value. */
+        uint32_t receivedAtUs;        /**< DeviceStats::now() of the oldest write merged into the mailbox. */
+    };
+
+    /**
+     * @brief Returns true for values that hold no pointer into the caller's buffers.
+     */
+    static bool isScalar(const esp_matter_attr_val_t & val);
+
+    /**
+     * @brief Entry point of the executor task.
+     */
+    static void taskFunction(void * self);
+
+    /**
+     * @brief Deletes the mailbox lock and the run semaphore.
+     */
+    void deleteSemaphores();
+
+    /**
+     * @brief Posts a FLUSH or STOP item and waits for the task to reach it.
+     */
+    esp_err_t postAndWait(Work::Kind kind);
+
+    /**
+     * @brief Runs and frees the write pending in a mailbox, if cancel() did not drop it.
+     */
+    void runMailbox(uint8_t index);
+
+    QueueHandle_t m_queue;                                  /**< Pending work, nullptr when stopped. */
+    SemaphoreHandle_t m_mailboxLock;                        /**< Guards m_mailboxes, m_running and m_cancelWaiting. */
+    SemaphoreHandle_t m_runDone;                            /**< Given when the write cancel() waits for has run. */
+    Mailbox m_mailboxes[CONFIG_D_M_ACTUATION_QUEUE_LENGTH]; /**< Pending writes, one per queued UPDATE. */
+    BaseDeviceInterface * m_running;                        /**< Device of the write being run, nullptr if none. */
+    bool m_cancelWaiting;                                   /**< cancel() waits for the running write. */
+    std::atomic<uint32_t> m_executed;                       /**< Writes run by the task. */
+    std::atomic<uint32_t> m_coalesced;                      /**< Writes replaced before they ran. */
+    std::atomic<uint32_t> m_overflows;                      /**< Writes rejected with every mailbox used. */
+    std::atomic<uint32_t> m_cancelled;                      /**< Writes dropped by cancel(). */
+
+    // delete the copy constructor and assignment operator
+    ActuationExecutor(const ActuationExecutor &)             = delete;
+    ActuationExecutor & operator=(const ActuationExecutor &) = delete;
+};
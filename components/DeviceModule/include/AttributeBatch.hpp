@@ -0,0 +1,93 @@
+#pragma once
+
+#include "DeviceStats.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Stages several attribute values and commits them under a single chip stack lock.
+ *
+ * attribute::report() takes the stack lock and resolves the attribute by id for every value, so a
+ * device that publishes several attributes per state change pays that cost once per attribute.
+ * AttributeBatch works on cached attribute handles instead: values are staged with stage() and
+ * written by commit(), which locks the stack once, stores every value and, unless only saving,
+ * marks all of them for reporting in the same pass.
+ *
+ * commit() reads every attribute before writing it and skips both the write and the report of a value
+ * the data model already holds. The data model is what subscribers were last sent, including controller
+ * writes the stack stored and reported itself, so nothing a device keeps on the side can go stale.
+ *
+ * When created with DeviceStats, commit() counts its lock acquisition and the reports it sent and skipped.
+ *
+ * The batch has a fixed capacity and does not allocate. It holds at least one value per channel of a
+ * multi-channel device, so a report of every channel commits once.
+ */
+class AttributeBatch
+{
+public:
+    /**
+     * @brief Number of values a batch can stage, CONFIG_D_M_ATTRIBUTE_BATCH_CAPACITY raised to one per channel.
+     */
+    static constexpr size_t CAPACITY = CONFIG_D_M_ATTRIBUTE_BATCH_CAPACITY > CONFIG_D_M_MAX_CHANNELS_PER_DEVICE
+        ? CONFIG_D_M_ATTRIBUTE_BATCH_CAPACITY
+        : CONFIG_D_M_MAX_CHANNELS_PER_DEVICE;
+
+    /**
+     * @brief Constructor for AttributeBatch.
+     * @param stats Optional performance counters of the owning device.
+     */
+    explicit AttributeBatch(DeviceStats * stats = nullptr);
+
+    /**
+     * @brief Stages an attribute value for the next commit.
+     * @param endpointId ID of the endpoint the attribute belongs to.
+     * @param clusterId ID of the cluster the attribute belongs to.
+     * @param attribute Cached handle of the attribute.
+     * @param value Value to store.
+     * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the attribute is null, ESP_ERR_NO_MEM if the batch is full.
+     */
+    esp_err_t stage(uint16_t endpointId, uint32_t clusterId, esp_matter::attribute_t * attribute, esp_matter_attr_val_t value);
+
+    /**
+     * @brief Writes every staged value under one chip stack lock and empties the batch.
+     * @param onlySave If true, only store the values without reporting them to subscribers.
+     * @return ESP_OK on success, ESP_FAIL if the lock could not be taken or a value could not be stored.
+     */
+    esp_err_t commit(bool onlySave = false);
+
+    /**
+     * @brief Drops every staged value.
+     */
+    void clear() { m_count = 0; }
+
+    /**
+     * @brief Returns the number of staged values.
+     */
+    size_t size() const { return m_count; }
+
+private:
+    /**
+     * @brief One staged attribute value.
+     */
+    struct Entry
+    {
+        esp_matter::attribute_t * attribute; /**< Cached handle of the attribute. */
+        esp_matter_attr_val_t value;         /**< Value to store. */
+        uint32_t clusterId;                  /**< ID of the cluster, needed to report the change. */
+        uint16_t endpointId;                 /**< ID of the endpoint, needed to report the change. */
+    };
+
+    /**
+     * @brief Returns true if two values have the same type and the same scalar value; strings and arrays never match.
+     */
+    static bool isSameValue(const esp_matter_attr_val_t & lhs, const esp_matter_attr_val_t & rhs);
+
+    Entry m_entries[CAPACITY]; /**< Staged values, in staging order. */
+    size_t m_count;            /**< Number of staged values. */
+    DeviceStats * m_stats;     /**< Counters of the owning device, may be null. */
+
+    // delete the copy constructor and assignment operator
+    AttributeBatch(const AttributeBatch &)             = delete;
+    AttributeBatch & operator=(const AttributeBatch &) = delete;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "DeviceStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <esp_err.h>
+#include <esp_matter.h>
+
+/**
+ * @brief Member function of a device that applies one written attribute to its accessory.
+ */
+template <typename Device>
+struct AttributeHandler
+{
+    uint32_t clusterId;   /**< Cluster of the handled attribute. */
+    uint32_t attributeId; /**< Handled attribute. */
+
+    /**
+     * @brief Member function called when the attribute is written.
+     */
+    esp_err_t (Device::*handler)(uint16_t endpointId, esp_matter_attr_val_t * val);
+};
+
+/**
+ * @brief Compile-time routing of attribute writes to device member functions.
+ *
+ * Built from a constexpr array of AttributeHandler entries, the table is sorted by (clusterId, attributeId)
+ * at compile time, so dispatch() is a binary search over a constant array in flash instead of a ladder of
+ * comparisons. Devices declare the table next to their value-carrying updateAccessory:
+ *
+ *     static constexpr AttributeHandler<LightDevice> handlers[] = {
+ *         { OnOff::Id, OnOff::Attributes::OnOff::Id, &LightDevice::updateOnOff },
+ *     };
+ *     static constexpr AttributeDispatchTable<LightDevice, 1> table(handlers);
+ *     static_assert(table.isValid(), "Duplicate attribute handler");
+ *     return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+ *
+ * Supporting a new attribute only takes a new entry and its handler.
+ */
+template <typename Device, size_t N>
+class AttributeDispatchTable
+{
+public:
+    /**
+     * @brief Constructor for AttributeDispatchTable.
+     * @param handlers Handlers in any order.
+     */
+    constexpr explicit AttributeDispatchTable(const AttributeHandler<Device> (&handlers)[N]) : m_keys(), m_handlers()
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            // Insertion sort, N is a handful of attributes
+            uint64_t key = makeKey(handlers[i].clusterId, handlers[i].attributeId);
+            size_t j     = i;
+            while (j > 0 && m_keys[j - 1] > key)
+            {
+                m_keys[j]     = m_keys[j - 1];
+                m_handlers[j] = m_handlers[j - 1];
+                j--;
+            }
+            m_keys[j]     = key;
+            m_handlers[j] = handlers[i].handler;
+        }
+    }
+
+    /**
+     * @brief Returns false if two handlers are registered for the same attribute.
+     */
+    constexpr bool isValid() const
+    {
+        for (size_t i = 1; i < N; i++)
+        {
+            if (m_keys[i - 1] == m_keys[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Calls the handler registered for an attribute.
+     * @param device Device to call the handler on.
+     * @param endpointId ID of the written endpoint.
+     * @param clusterId ID of the written cluster.
+     * @param attributeId ID of the written attribute.
+     * @param val The written value.
+     * @return The handler result, or ESP_OK if the attribute is not handled or the value is null.
+     *
+     * Handled writes and the time their handler took, and ignored writes, are counted in the device stats;
+     * the start of the handler ends the command latency of the write.
+     */
+    esp_err_t dispatch(Device & device, uint16_t endpointId, uint32_t clusterId, uint32_t attributeId,
+                       esp_matter_attr_val_t * val) const
+    {
+        if (val == nullptr)
+        {
+            device.getStats().recordFilteredUpdate();
+            return ESP_OK;
+        }
+
+        uint64_t key = makeKey(clusterId, attributeId);
+        size_t low   = 0;
+        size_t high  = N;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            if (m_keys[middle] < key)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (low == N || m_keys[low] != key)
+        {
+            device.getStats().recordFilteredUpdate();
+            return ESP_OK;
+        }
+
+        uint32_t start   = DeviceStats::now();
+        esp_err_t result = (device.*m_handlers[low])(endpointId, val);
+        device.getStats().recordUpdate(start, DeviceStats::now());
+        return result;
+    }
+
+private:
+    static constexpr uint64_t makeKey(uint32_t clusterId, uint32_t attributeId)
+    {
+        return (static_cast<uint64_t>(clusterId) << 32) | attributeId;
+    }
+
+    uint64_t m_keys[N]; /**< Sorted (clusterId, attributeId) keys. */
+
+    /**
+     * @brief Handlers, in the order of m_keys.
+     */
+    esp_err_t (Device::*m_handlers[N])(uint16_t endpointId, esp_matter_attr_val_t * val);
+};
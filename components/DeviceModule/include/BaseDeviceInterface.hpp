@@ -1,8 +1,15 @@
 #pragma once
 
+#include "DeviceLog.hpp"
+#include "DeviceStats.hpp"
+#include "EndpointIdMap.hpp"
+#include "PersistencePolicy.hpp"
+#include <atomic>
 #include <esp_err.h>
 #include <esp_matter.h>
 
+class ReportDispatcher;
+
 /**
  * @brief Base interface for device functionalities.
  */
@@ -10,9 +17,14 @@ class BaseDeviceInterface
 {
 public:
     /**
-     * @brief Virtual destructor for BaseDeviceInterface.
+     * @brief Change mask meaning that any reported field may have changed.
+     */
+    static constexpr uint32_t CHANGED_ALL = 0xFFFFFFFF;
+
+    /**
+     * @brief Virtual destructor for BaseDeviceInterface, detaches the device from its ReportDispatcher.
      */
-    virtual ~BaseDeviceInterface() = default;
+    virtual ~BaseDeviceInterface();
 
     /**
      * @brief Updates the accessory state.
@@ -22,6 +34,24 @@ public:
 
     virtual esp_err_t updateAccessory(uint32_t attributeId, uint16_t endpointIּd) { return updateAccessory(attributeId); };
 
+    /**
+     * @brief Updates the accessory from the value written to the data model.
+     *
+     * The attribute callback already carries the written value, so devices overriding this act on it
+     * without reading it back. The default falls back to updateAccessory(attributeId, endpointId).
+     * @param endpointId ID of the written endpoint.
+     * @param clusterId ID of the written cluster.
+     * @param attributeId ID of the written attribute.
+     * @param val The written value.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    virtual esp_err_t updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val)
+    {
+        (void) clusterId;
+        (void) val;
+        return updateAccessory(attributeId, endpointId);
+    }
+
     /**
      * @brief Reports the endpoint state.
      * @param onlySave If true, only save the endpoint state without reporting it.
@@ -29,6 +59,99 @@ public:
      */
     virtual esp_err_t reportEndpoint(bool onlySave) = 0;
 
+    /**
+     * @brief Reports only the endpoint attributes backed by the fields that changed.
+     *
+     * Devices that do not tell their fields apart report their whole state.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Device specific bit mask of the changed fields, CHANGED_ALL if unknown.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    virtual esp_err_t reportEndpoint(bool onlySave, uint32_t changeMask)
+    {
+        (void) changeMask;
+        return reportEndpoint(onlySave);
+    }
+
+    /**
+     * @brief Emits one event posted with requestEvent().
+     *
+     * Devices whose accessories raise one-off events (switch presses) override this, the default ignores them.
+     * @param event Device specific event, captured when the accessory raised it.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    virtual esp_err_t reportEvent(uint32_t event)
+    {
+        (void) event;
+        return ESP_OK;
+    }
+
+    /**
+     * @brief Report callback for accessories that know which fields changed.
+     *
+     * Accessories that only supply onlySave keep using the device's own callback, which reports CHANGED_ALL.
+     * @param device Pointer to the BaseDeviceInterface to report.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Device specific bit mask of the changed fields.
+     */
+    static void reportChangesCallback(void * device, bool onlySave, uint32_t changeMask)
+    {
+        static_cast<BaseDeviceInterface *>(device)->requestReport(onlySave, changeMask);
+    }
+
+    /**
+     * @brief Reports an accessory state change, the entry point of accessory report callbacks.
+     *
+     * Devices attached to a ReportDispatcher only post the request to the report task, which never
+     * blocks the calling accessory task; other devices report at once.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Device specific bit mask of the changed fields, CHANGED_ALL if unknown.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t requestReport(bool onlySave, uint32_t changeMask = CHANGED_ALL);
+
+    /**
+     * @brief Reports an accessory event, which unlike a state change cannot be read back later.
+     *
+     * Devices attached to a ReportDispatcher queue the event for the report task, so every event is emitted
+     * once and in order; other devices, and events finding the queue full, are emitted at once.
+     * @param event Device specific event, passed on to reportEvent().
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t requestEvent(uint32_t event);
+
+    /**
+     * @brief Returns the performance counters of the device.
+     */
+    DeviceStats & getStats() { return m_stats; }
+
+    /**
+     * @brief Returns the performance counters of the device.
+     */
+    const DeviceStats & getStats() const { return m_stats; }
+
+    /**
+     * @brief Applies a persistence policy to the non-volatile attributes holding the device state.
+     *
+     * esp_matter cannot return a deferred attribute to immediate persistence, so the policy is applied
+     * once, right after the device is created. Must be called with the chip stack lock held once the
+     * stack is started.
+     * @param policy Persistence of the state attributes.
+     */
+    void applyPersistencePolicy(PersistencePolicy policy);
+
+    /**
+     * @brief Returns the persistence policy applied to the device, IMMEDIATE unless one was applied.
+     */
+    PersistencePolicy getPersistencePolicy() const { return m_persistencePolicy; }
+
+    /**
+     * @brief Returns the actuator state of the accessory, packed as described by DeviceSnapshot.
+     *
+     * Devices without actuator state keep the default, which returns 0.
+     */
+    virtual uint32_t captureState() const { return 0; }
+
     /**
      * @brief Identifies the device.
      * @return ESP_OK on success, or an error code on failure.
@@ -38,6 +161,8 @@ public:
     /**
      * @brief Initialize the bridged node
      *
+     * Once the stack is started the endpoint gets the id EndpointIdMap stored for it at a previous boot.
+     *
      * @param endpoint Pointer to endpoint
      * @param deviceName Device name
      * @param aggregator Pointer to endpoint aggregator
@@ -48,7 +173,7 @@ public:
         esp_matter::endpoint::bridged_node::config_t bridgedNodeConfig;
         uint8_t flags = esp_matter::endpoint_flags::ENDPOINT_FLAG_BRIDGE | esp_matter::endpoint_flags::ENDPOINT_FLAG_DESTROYABLE;
         esp_matter::endpoint_t * endpoint =
-            esp_matter::endpoint::bridged_node::create(esp_matter::node::get(), &bridgedNodeConfig, flags, privData);
+            EndpointIdMap::createBridgedNode(esp_matter::node::get(), &bridgedNodeConfig, flags, privData);
         if (deviceName != nullptr && strlen(deviceName) > 0 && strlen(deviceName) < CONFIG_D_M_MAX_DEVICE_NAME_LEN)
         {
             esp_matter::cluster_t * bridgeDeviceBasicInformationCluster =
@@ -61,6 +186,33 @@ public:
         return endpoint;
     }
 
+    /**
+     * @brief Resolves an attribute handle of an endpoint.
+     *
+     * Devices call this once after their clusters are set up and keep the handle, so the hot paths
+     * do not walk the endpoint's cluster and attribute lists on every call.
+     *
+     * @param endpoint Pointer to endpoint
+     * @param clusterId Cluster ID
+     * @param attributeId Attribute ID
+     * @return The attribute handle, or nullptr if the endpoint, cluster or attribute does not exist.
+     */
+    static esp_matter::attribute_t * resolveAttribute(esp_matter::endpoint_t * endpoint, uint32_t clusterId, uint32_t attributeId)
+    {
+        if (endpoint == nullptr)
+        {
+            return nullptr;
+        }
+
+        esp_matter::cluster_t * cluster = esp_matter::cluster::get(endpoint, clusterId);
+        if (cluster == nullptr)
+        {
+            return nullptr;
+        }
+
+        return esp_matter::attribute::get(cluster, attributeId);
+    }
+
     /**
      * @brief Initialize a standalone node
      *
@@ -69,9 +221,79 @@ public:
      */
     static esp_matter::endpoint_t * initializeStandaloneNode(void * privData)
     {
-        uint8_t flags                     = esp_matter::endpoint_flags::ENDPOINT_FLAG_NONE;
+        uint8_t flags                     = esp_matter::endpoint_flags::ENDPOINT_FLAG_DESTROYABLE;
         esp_matter::endpoint_t * endpoint = esp_matter::endpoint::create(esp_matter::node::get(), flags, privData);
 
         return endpoint;
     }
+
+    /**
+     * @brief Enables an endpoint whose clusters are set up.
+     *
+     * esp_matter::start enables every endpoint created before it, so this only acts on devices added
+     * to a running bridge. Must be called with the chip stack lock held.
+     *
+     * @param endpoint Pointer to endpoint
+     */
+    static esp_err_t enableEndpoint(esp_matter::endpoint_t * endpoint)
+    {
+        if (endpoint == nullptr || !esp_matter::is_started())
+        {
+            return ESP_OK;
+        }
+
+        return esp_matter::endpoint::enable(endpoint);
+    }
+
+    /**
+     * @brief Destroys an endpoint created by initializeBridgedNode or initializeStandaloneNode.
+     *
+     * Device destructors call this so a removed device leaves neither the endpoint nor a dangling
+     * priv_data behind. Must be called with the chip stack lock held once the stack is started.
+     *
+     * @param endpoint Pointer to endpoint, set to nullptr
+     */
+    static void releaseEndpoint(esp_matter::endpoint_t *& endpoint)
+    {
+        if (endpoint == nullptr)
+        {
+            return;
+        }
+
+        if (esp_matter::endpoint::destroy(esp_matter::node::get(), endpoint) != ESP_OK)
+        {
+            DM_LOGE("BaseDeviceInterface", "Failed to destroy endpoint %u", esp_matter::endpoint::get_id(endpoint));
+        }
+        endpoint = nullptr;
+    }
+
+protected:
+    /**
+     * @brief Defers the persistence of the non-volatile attributes holding the device state.
+     *
+     * Devices without such attributes keep the default, which does nothing.
+     */
+    virtual void deferStatePersistence() {}
+
+    /**
+     * @brief Defers the persistence of one attribute, logging attributes esp_matter does not store.
+     * @param attribute Cached attribute handle, may be nullptr.
+     */
+    static void deferPersistence(esp_matter::attribute_t * attribute);
+
+    /**
+     * @brief Counts a change of an attribute in the persistence counters of the device.
+     *
+     * Called by handlers of controller writes, which esp_matter stores before the device sees them.
+     * @param attribute Cached handle of the changed attribute, may be nullptr.
+     */
+    void recordPersistence(esp_matter::attribute_t * attribute);
+
+private:
+    friend class ReportDispatcher;
+
+    std::atomic<ReportDispatcher *> m_reportDispatcher{ nullptr };        /**< Dispatcher the device is attached to. */
+    uint8_t m_reportSlot = 0;                                             /**< Slot of the device in m_reportDispatcher. */
+    DeviceStats m_stats;                                                  /**< Performance counters. */
+    PersistencePolicy m_persistencePolicy = PersistencePolicy::IMMEDIATE; /**< Policy applied to the state attributes. */
 };
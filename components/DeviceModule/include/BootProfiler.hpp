@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sdkconfig.h>
+
+/**
+ * @brief Records when each phase of the boot ends, from app_main to the Matter server, in a retained buffer.
+ *
+ * app_main calls begin() first and mark() at the end of every phase; DeviceRegistry marks each device it
+ * creates until DEVICES_CREATED is marked. Records hold the esp_timer time, so the gap to the previous record is
+ * the cost of the phase (`matter device boot`). esp_timer starts with the application, the bootloader is
+ * not included.
+ *
+ * The buffer lives in RTC memory that survives software, panic and watchdog resets: begin() keeps the
+ * records of the previous boot, which show the phase a crashing boot got stuck in. A power cut clears it.
+ * Each phase is recorded once per boot, DEVICE_CREATED once per device. With D_M_BOOT_PROFILER disabled
+ * every function does nothing.
+ */
+class BootProfiler
+{
+public:
+    /**
+     * @brief Boot phases.
+     *
+     * app_main creates the devices on the started stack so they keep their endpoint ids (EndpointIdMap):
+     * DEVICE_CREATED and DEVICES_CREATED are recorded after MATTER_STARTED.
+     */
+    enum Phase : uint8_t
+    {
+        APP_START,          /**< app_main entered. */
+        NVS_INIT,           /**< nvs_flash_init done. */
+        SNAPSHOT_RESTORED,  /**< DeviceSnapshot applied to the accessories. */
+        NODE_CREATED,       /**< esp_matter::node::create done. */
+        AGGREGATOR_CREATED, /**< Aggregator endpoint created. */
+        DEVICE_CREATED,     /**< One device constructed, the record holds its id. */
+        DEVICES_CREATED,    /**< DeviceRegistry::createDevices done. */
+        MATTER_STARTED,     /**< esp_matter::start returned. */
+        SERVER_READY,       /**< Matter server ready, the bridge is reachable by its fabrics. */
+        COMMISSIONABLE,     /**< Commissioning window opened. */
+        PHASE_COUNT,
+    };
+
+    /**
+     * @brief End of one phase.
+     */
+    struct Record
+    {
+        uint32_t timeUs; /**< esp_timer time at the end of the phase. */
+        uint16_t id;     /**< Device id of DEVICE_CREATED records, 0 otherwise. */
+        uint8_t phase;   /**< Phase. */
+        uint8_t valid;   /**< Set once the record is written. */
+    };
+
+    /**
+     * @brief Starts the profile of this boot, keeping the records of the previous one.
+     *
+     * Call first thing in app_main, before any mark().
+     */
+    static void begin();
+
+    /**
+     * @brief Records the end of a phase, unless the phase was already recorded or the buffer is full.
+     *
+     * DEVICE_CREATED is recorded once per call until DEVICES_CREATED is recorded.
+     * @param phase The phase that ended.
+     * @param id Device id of DEVICE_CREATED, 0 otherwise.
+     */
+    static void mark(Phase phase, uint16_t id = 0);
+
+    /**
+     * @brief Copies the records of this boot.
+     * @param records Destination.
+     * @param capacity Number of records the destination holds.
+     * @return Number of records copied.
+     */
+    static size_t records(Record * records, size_t capacity);
+
+    /**
+     * @brief Copies the records of the previous boot, none after a power cut.
+     * @param records Destination.
+     * @param capacity Number of records the destination holds.
+     * @return Number of records copied.
+     */
+    static size_t previousRecords(Record * records, size_t capacity);
+
+    /**
+     * @brief Returns the name of a phase.
+     */
+    static const char * phaseName(uint8_t phase);
+
+    /**
+     * @brief Prints the profile of this boot and, if there is one, of the previous boot to the console.
+     */
+    static void print();
+};
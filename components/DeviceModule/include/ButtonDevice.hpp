@@ -38,6 +38,13 @@ public:
      */
     esp_err_t reportEndpoint(bool onlySave = false) override;
 
+    /**
+     * @brief Emits a switch press event.
+     * @param event The StatelessButtonAccessoryInterface::PressType of the press.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t reportEvent(uint32_t event) override;
+
     /**
      * @brief Identifies the device.
      * @return ESP_OK on success, or an error code on failure.
@@ -56,8 +63,9 @@ private:
      */
     void setEndpointSwitchPressEvent(StatelessButtonAccessoryInterface::PressType pressType);
 
-    esp_matter::endpoint_t * m_endpoint;             /**< Pointer to the esp_matter endpoint. */
-    StatelessButtonAccessoryInterface * m_accessory; /**< Pointer to the StatelessButtonAccessory instance. */
+    esp_matter::endpoint_t * m_endpoint;                  /**< Pointer to the esp_matter endpoint. */
+    esp_matter::attribute_t * m_currentPositionAttribute; /**< Cached Switch CurrentPosition attribute handle. */
+    StatelessButtonAccessoryInterface * m_accessory;      /**< Pointer to the StatelessButtonAccessory instance. */
 
     // Delete the copy constructor and assignment operator
     ButtonDevice(const ButtonDevice &)             = delete;
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <esp_log.h>
+#include <sdkconfig.h>
+#include <type_traits>
+
+#define DM_LOG_LEVEL_NONE    0
+#define DM_LOG_LEVEL_ERROR   1
+#define DM_LOG_LEVEL_WARN    2
+#define DM_LOG_LEVEL_INFO    3
+#define DM_LOG_LEVEL_DEBUG   4
+#define DM_LOG_LEVEL_VERBOSE 5
+
+/**
+ * @brief Logging of the module, with compile-time level removal and an optional tokenized ring.
+ *
+ * The DM_LOGx macros take the arguments of ESP_LOGx. Messages above CONFIG_D_M_LOG_LEVEL are removed at
+ * compile time, format string included; their arguments still compile, so no variable turns unused.
+ * Per-command messages of the update and report paths are debug messages, so the default info level keeps
+ * console output at 115200 baud (about 87 us per character) out of the actuation path.
+ *
+ * With D_M_LOG_TOKENIZED, info, debug and verbose messages do not format anything: write() stores a
+ * hash of the source file name and format string, computed at compile time, a timestamp and up to
+ * MAX_ARGS integer arguments in a RAM ring. print() dumps the ring as `DMLOG` lines, which
+ * tools/decode_device_log.py turns back into text by hashing the format strings of the sources. String
+ * arguments are recorded as their address only. Errors and warnings are always printed as text.
+ */
+class DeviceLog
+{
+public:
+    /**
+     * @brief Most arguments a tokenized message records.
+     */
+    static constexpr uint8_t MAX_ARGS = 4;
+
+    /**
+     * @brief One tokenized message.
+     */
+    struct Record
+    {
+        uint32_t token;          /**< token() of the source file and format string. */
+        uint32_t timestampUs;    /**< esp_timer time of the message, wrapping. */
+        uint8_t level;           /**< DM_LOG_LEVEL_x of the message. */
+        uint8_t argCount;        /**< Number of recorded arguments. */
+        uint32_t args[MAX_ARGS]; /**< Arguments, truncated or sign-extended to 32 bits. */
+    };
+
+    /**
+     * @brief Returns the 32-bit FNV-1a hash of "<file name>:<format>", the file name without directories.
+     */
+    static constexpr uint32_t token(const char * file, const char * format)
+    {
+        const char * name = file;
+        for (const char * c = file; *c != '\0'; c++)
+        {
+            if (*c == '/' || *c == '\\')
+            {
+                name = c + 1;
+            }
+        }
+
+        uint32_t hash = 2166136261u;
+        for (const char * c = name; *c != '\0'; c++)
+        {
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+        }
+        hash = (hash ^ static_cast<uint8_t>(':')) * 16777619u;
+        for (const char * c = format; *c != '\0'; c++)
+        {
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Stores a tokenized message in the ring, safe from any task.
+     * @param token token() of the message.
+     * @param level DM_LOG_LEVEL_x of the message.
+     * @param args Integer, enum or pointer arguments of the format string.
+     */
+    template <typename... Args>
+    static void write(uint32_t token, uint8_t level, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Tokenized messages record at most MAX_ARGS arguments");
+        uint32_t values[MAX_ARGS] = { toArg(args)... };
+        writeRecord(token, level, values, sizeof...(Args));
+    }
+
+    /**
+     * @brief Copies the messages of the ring, oldest first.
+     * @param records Destination.
+     * @param capacity Number of records the destination holds.
+     * @return Number of records copied.
+     */
+    static size_t snapshot(Record * records, size_t capacity);
+
+    /**
+     * @brief Prints the messages of the ring to the console, one `DMLOG` line each, oldest first.
+     */
+    static void print();
+
+    /**
+     * @brief Discards the messages of the ring.
+     */
+    static void clear();
+
+private:
+    template <typename T>
+    static uint32_t toArg(T value)
+    {
+        static_assert(!std::is_floating_point<T>::value, "Tokenized messages take no floating point arguments");
+        if constexpr (std::is_pointer<T>::value)
+        {
+            return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+        }
+        else
+        {
+            return static_cast<uint32_t>(value);
+        }
+    }
+
+    static void writeRecord(uint32_t token, uint8_t level, const uint32_t * args, uint8_t argCount);
+};
+
+#define DM_LOG_TEXT(level, letter, tag, format, ...)                                                                               \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        if (CONFIG_D_M_LOG_LEVEL >= level)                                                                                         \
+        {                                                                                                                          \
+            ESP_LOG##letter(tag, format, ##__VA_ARGS__);                                                                           \
+        }                                                                                                                          \
+    } while (0)
+
+#if CONFIG_D_M_LOG_TOKENIZED
+#define DM_LOG_OUTPUT(level, letter, tag, format, ...)                                                                             \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        if (CONFIG_D_M_LOG_LEVEL >= level)                                                                                         \
+        {                                                                                                                          \
+            (void) tag;                                                                                                            \
+            DeviceLog::write(std::integral_constant<uint32_t, DeviceLog::token(__FILE__, format)>::value, level, ##__VA_ARGS__);   \
+        }                                                                                                                          \
+    } while (0)
+#else
+#define DM_LOG_OUTPUT(level, letter, tag, format, ...) DM_LOG_TEXT(level, letter, tag, format, ##__VA_ARGS__)
+#endif
+
+#define DM_LOGE(tag, format, ...) DM_LOG_TEXT(DM_LOG_LEVEL_ERROR, E, tag, format, ##__VA_ARGS__)
+#define DM_LOGW(tag, format, ...) DM_LOG_TEXT(DM_LOG_LEVEL_WARN, W, tag, format, ##__VA_ARGS__)
+#define DM_LOGI(tag, format, ...) DM_LOG_OUTPUT(DM_LOG_LEVEL_INFO, I, tag, format, ##__VA_ARGS__)
+#define DM_LOGD(tag, format, ...) DM_LOG_OUTPUT(DM_LOG_LEVEL_DEBUG, D, tag, format, ##__VA_ARGS__)
+#define DM_LOGV(tag, format, ...) DM_LOG_OUTPUT(DM_LOG_LEVEL_VERBOSE, V, tag, format, ##__VA_ARGS__)
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "ActuationExecutor.hpp"
+#include "BaseAccessoryInterface.hpp"
+#include "BaseDeviceInterface.hpp"
+#include "ButtonDevice.hpp"
+#include "DoorLockDevice.hpp"
+#include "FanDevice.hpp"
+#include "LightDevice.hpp"
+#include "MultiPluginDevice.hpp"
+#include "ObjectPool.hpp"
+#include "PersistencePolicy.hpp"
+#include "PluginDevice.hpp"
+#include "ReportDispatcher.hpp"
+#include "TVLifterDevice.hpp"
+#include "WindowDevice.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Device classes a DeviceRegistry can create.
+ */
+enum class DeviceType : uint8_t
+{
+    BUTTON,       /**< ButtonDevice, StatelessButtonAccessoryInterface. */
+    DOOR_LOCK,    /**< DoorLockDevice, DoorLockAccessoryInterface. */
+    FAN,          /**< FanDevice, FanAccessoryInterface. */
+    LIGHT,        /**< LightDevice, LightAccessoryInterface. */
+    MULTI_PLUGIN, /**< MultiPluginDevice, one PluginAccessoryInterface per channel. */
+    PLUGIN,       /**< PluginDevice, PluginAccessoryInterface. */
+    TV_LIFTER,    /**< TVLifterDevice, TVLifterAccessoryInterface. */
+    WINDOW,       /**< WindowDevice, BlindAccessoryInterface. */
+};
+
+/**
+ * @brief Describes one device of a bridge.
+ *
+ * The accessory must implement the accessory interface of the device type. Descriptors that leave out
+ * the persistence policy get the D_M_PERSISTENCE_x default.
+ */
+struct DeviceDescriptor
+{
+    uint16_t id;                                                /**< Application id the device is looked up by, unique. */
+    DeviceType type;                                            /**< Device class to create. */
+    const char * name;                                          /**< Name of the bridged endpoint. */
+    BaseAccessoryInterface * accessory;                         /**< Accessory of single-endpoint devices. */
+    BaseAccessoryInterface * const * channelAccessories;        /**< Accessory of each channel, MULTI_PLUGIN only. */
+    uint8_t channelCount;                                       /**< Number of channels, MULTI_PLUGIN only. */
+    PersistencePolicy persistence = DEFAULT_PERSISTENCE_POLICY; /**< Persistence of the state attributes. */
+};
+
+/**
+ * @brief Slot usage of the device pool of one device type.
+ */
+struct DevicePoolUsage
+{
+    size_t used;     /**< Slots holding a device. */
+    size_t peak;     /**< Highest number of slots used at once. */
+    size_t capacity; /**< Configured number of slots. */
+    size_t slotSize; /**< Bytes per slot. */
+};
+
+/**
+ * @brief Creates the devices of a bridge from a descriptor table and looks them up by id.
+ *
+ * All devices and their endpoints are created in one pass. Once the Matter stack is started the chip
+ * stack lock is taken once for the whole table instead of once per endpoint. Devices are kept sorted
+ * by id, so find() is a binary search.
+ *
+ * Devices can be added and removed while the bridge runs; removing a device destroys its endpoints,
+ * detaches its accessories and returns its slot to the pool.
+ *
+ * Devices are placed in one ObjectPool per device class, sized by the D_M_*_DEVICE_POOL_SIZE options,
+ * instead of the heap. Declare the registry with static storage duration so the pools land in .bss.
+ */
+class DeviceRegistry
+{
+public:
+    /**
+     * @brief Total number of devices the pools can hold.
+     */
+    static constexpr size_t CAPACITY = CONFIG_D_M_BUTTON_DEVICE_POOL_SIZE + CONFIG_D_M_DOOR_LOCK_DEVICE_POOL_SIZE +
+        CONFIG_D_M_FAN_DEVICE_POOL_SIZE + CONFIG_D_M_LIGHT_DEVICE_POOL_SIZE + CONFIG_D_M_MULTI_PLUGIN_DEVICE_POOL_SIZE +
+        CONFIG_D_M_PLUGIN_DEVICE_POOL_SIZE + CONFIG_D_M_TV_LIFTER_DEVICE_POOL_SIZE + CONFIG_D_M_WINDOW_DEVICE_POOL_SIZE;
+    static_assert(CAPACITY > 0, "Every device pool is empty");
+
+    /**
+     * @brief Constructor for DeviceRegistry.
+     * @param endpointAggregator Pointer to the aggregator endpoint devices are bridged under,
+     *                           nullptr for standalone endpoints.
+     */
+    explicit DeviceRegistry(esp_matter::endpoint_t * endpointAggregator = nullptr);
+
+    /**
+     * @brief Destructor for DeviceRegistry, destroys the created devices and their endpoints.
+     */
+    ~DeviceRegistry();
+
+    /**
+     * @brief Creates one device per descriptor.
+     *
+     * Descriptors with a duplicate id or an unknown type are skipped, as are descriptors whose
+     * device pool is full. Once the stack is started, bridged endpoints keep the id EndpointIdMap stored
+     * for their device at a previous boot.
+     * @param descriptors Descriptor table.
+     * @param count Number of descriptors.
+     * @return ESP_OK if every device was created, or an error code on failure.
+     */
+    esp_err_t createDevices(const DeviceDescriptor * descriptors, size_t count);
+
+    /**
+     * @brief Creates one device, under the chip stack lock once the stack is started.
+     * @param descriptor Descriptor of the device.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t addDevice(const DeviceDescriptor & descriptor);
+
+    /**
+     * @brief Destroys a device and its endpoints, under the chip stack lock once the stack is started.
+     * @param id Application id of the device.
+     * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no device with the id.
+     */
+    esp_err_t removeDevice(uint16_t id);
+
+    /**
+     * @brief Routes the accessory reports of every current and future device through a dispatcher.
+     * @param dispatcher The dispatcher, nullptr to report from the accessory tasks again.
+     * @return ESP_OK on success, ESP_ERR_NO_MEM if the dispatcher has too few slots.
+     */
+    esp_err_t setReportDispatcher(ReportDispatcher * dispatcher);
+
+    /**
+     * @brief Sets the executor the attribute callback submits writes to, so removed devices drop their pending writes.
+     *
+     * Set a ReportDispatcher as well, see ActuationExecutor::cancel().
+     * @param executor The executor, nullptr if writes run on the Matter task.
+     */
+    void setActuationExecutor(ActuationExecutor * executor);
+
+    /**
+     * @brief Returns the device with the given id, or nullptr if there is none.
+     */
+    BaseDeviceInterface * find(uint16_t id) const;
+
+    /**
+     * @brief Returns the number of created devices.
+     */
+    size_t size() const { return m_count; }
+
+    /**
+     * @brief Returns the slot usage of the pool of a device type.
+     */
+    DevicePoolUsage poolUsage(DeviceType type) const;
+
+    /**
+     * @brief Logs the slot usage of every device pool.
+     */
+    void logPoolUsage() const;
+
+    /**
+     * @brief Prints the performance counters of every device to the console, one row per device.
+     */
+    void printStats() const;
+
+    /**
+     * @brief Prints the command and report latency percentiles of every device to the console.
+     */
+    void printLatency() const;
+
+    /**
+     * @brief Prints the persistence policy and NVS write counters of every device to the console.
+     */
+    void printPersistence() const;
+
+    /**
+     * @brief Clears the performance counters and latency histograms of every device.
+     */
+    void resetStats();
+
+    /**
+     * @brief Saves the actuator state of every device to the DeviceSnapshot restored at the next boot.
+     *
+     * Writes to NVS only if a state changed since the last save.
+     * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED with D_M_BOOT_SNAPSHOT disabled, or an error code on failure.
+     */
+    esp_err_t saveSnapshot() const;
+
+private:
+    /**
+     * @brief Creates the device of a descriptor.
+     * @return The device, or nullptr on failure.
+     */
+    BaseDeviceInterface * createDevice(const DeviceDescriptor & descriptor);
+
+    /**
+     * @brief Cancels the pending writes of a device, destroys it and returns its slot to the pool of its type.
+     */
+    void destroyDevice(DeviceType type, BaseDeviceInterface * device);
+
+    /**
+     * @brief Takes the chip stack lock if the stack is started.
+     * @return ALREADY_TAKEN before esp_matter::start, otherwise the chip_stack_lock result.
+     */
+    static esp_matter::lock::status_t lockStack();
+
+    /**
+     * @brief Releases the chip stack lock if lockStack took it.
+     */
+    static void unlockStack(esp_matter::lock::status_t lockStatus);
+
+    /**
+     * @brief Returns the index of the first entry with an id not less than the given one.
+     */
+    size_t lowerBound(uint16_t id) const;
+
+    /**
+     * @brief Created device and its id.
+     */
+    struct Entry
+    {
+        uint16_t id;                  /**< Application id of the device. */
+        DeviceType type;              /**< Device class, selects the pool. */
+        BaseDeviceInterface * device; /**< The device. */
+    };
+
+    esp_matter::endpoint_t * m_endpointAggregator;                                          /**< Aggregator endpoint. */
+    Entry m_entries[CAPACITY];                                                              /**< Devices sorted by id. */
+    size_t m_count;                                                                         /**< Number of created devices. */
+    ReportDispatcher * m_reportDispatcher;                                                  /**< Report dispatcher, optional. */
+    ActuationExecutor * m_actuationExecutor;                                                /**< Actuation executor, optional. */
+    ObjectPool<ButtonDevice, CONFIG_D_M_BUTTON_DEVICE_POOL_SIZE> m_buttons;                 /**< ButtonDevice slots. */
+    ObjectPool<DoorLockDevice, CONFIG_D_M_DOOR_LOCK_DEVICE_POOL_SIZE> m_doorLocks;          /**< DoorLockDevice slots. */
+    ObjectPool<FanDevice, CONFIG_D_M_FAN_DEVICE_POOL_SIZE> m_fans;                          /**< FanDevice slots. */
+    ObjectPool<LightDevice, CONFIG_D_M_LIGHT_DEVICE_POOL_SIZE> m_lights;                    /**< LightDevice slots. */
+    ObjectPool<MultiPluginDevice, CONFIG_D_M_MULTI_PLUGIN_DEVICE_POOL_SIZE> m_multiPlugins; /**< MultiPluginDevice slots. */
+    ObjectPool<PluginDevice, CONFIG_D_M_PLUGIN_DEVICE_POOL_SIZE> m_plugins;                 /**< PluginDevice slots. */
+    ObjectPool<TVLifterDevice, CONFIG_D_M_TV_LIFTER_DEVICE_POOL_SIZE> m_tvLifters;          /**< TVLifterDevice slots. */
+    ObjectPool<WindowDevice, CONFIG_D_M_WINDOW_DEVICE_POOL_SIZE> m_windows;                 /**< WindowDevice slots. */
+
+    // delete the copy constructor and assignment operator
+    DeviceRegistry(const DeviceRegistry &)             = delete;
+    DeviceRegistry & operator=(const DeviceRegistry &) = delete;
+};
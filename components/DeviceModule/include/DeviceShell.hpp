@@ -0,0 +1,25 @@
+#pragma once
+
+#include "DeviceRegistry.hpp"
+#include <esp_err.h>
+
+/**
+ * @brief `device` commands of the CHIP shell, for diagnosing a running bridge without a debug build.
+ *
+ *     matter device stats        prints the performance counters of every device
+ *     matter device lock-stats   prints the chip stack lock wait and hold histograms of every lock site
+ *     matter device reset-stats  clears both
+ *     matter device boot         prints when each boot phase ended, for this and the previous boot
+ *
+ * Only available with CONFIG_ENABLE_CHIP_SHELL; register the commands before esp_matter::console::init().
+ */
+class DeviceShell
+{
+public:
+    /**
+     * @brief Registers the `device` commands for the devices of a registry.
+     * @param registry Registry the commands act on, must outlive the shell.
+     * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED without CONFIG_ENABLE_CHIP_SHELL, or an error code on failure.
+     */
+    static esp_err_t registerCommands(DeviceRegistry * registry);
+};
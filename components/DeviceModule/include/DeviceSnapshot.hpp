@@ -0,0 +1,83 @@
+#pragma once
+
+#include "DeviceRegistry.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <esp_err.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Compact NVS snapshot of the actuator state of every device, applied to the accessories at boot.
+ *
+ * Without it every accessory waits for its device: the constructor reads the state back from the non-volatile
+ * attributes esp_matter loads while it creates the endpoint, so relays switch back only after node::create and
+ * every device endpoint. The snapshot keeps one 8-byte record per device in a single blob, read once by
+ * restore() and fanned out to the accessories of the descriptor table before the data model exists.
+ *
+ * The attributes stay the source of truth: the devices still apply them when they are created, which corrects
+ * a snapshot older than the last change. State is packed by BaseDeviceInterface::captureState():
+ * - Light, Plugin, Fan: bit 0 is the power state;
+ * - DoorLock: bit 0 is set if locked;
+ * - MultiPlugin: bit N is the power state of channel N;
+ * - Window: the current position of the blind accessory;
+ * - Button, TVLifter: no state, the records are skipped.
+ *
+ * With D_M_BOOT_SNAPSHOT disabled every function returns ESP_ERR_NOT_SUPPORTED. Not thread safe: restore at
+ * boot and save from one task.
+ */
+class DeviceSnapshot
+{
+public:
+    /**
+     * @brief Stored state of one device.
+     */
+    struct Record
+    {
+        uint16_t id;      /**< Application id of the device. */
+        uint8_t type;     /**< DeviceType of the device, a record only restores a descriptor of the same type. */
+        uint8_t reserved; /**< Always 0. */
+        uint32_t state;   /**< BaseDeviceInterface::captureState() of the device. */
+    };
+    static_assert(sizeof(Record) == 8, "Snapshot records are stored as 8-byte entries");
+
+    /**
+     * @brief Reads the snapshot and applies it to the accessories of a descriptor table.
+     *
+     * Call before the devices are created. Descriptors without a record of their id and type are left alone.
+     * @param descriptors Descriptor table the devices will be created from.
+     * @param count Number of descriptors.
+     * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no valid snapshot, or an error code on failure.
+     */
+    static esp_err_t restore(const DeviceDescriptor * descriptors, size_t count);
+
+    /**
+     * @brief Stores the records, unless they equal the last stored or restored ones.
+     * @param records Records sorted by id, as DeviceRegistry::saveSnapshot() captures them.
+     * @param count Number of records, at most DeviceRegistry::CAPACITY.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    static esp_err_t save(const Record * records, size_t count);
+
+    /**
+     * @brief Erases the stored snapshot, the next boot restores the accessories from the devices only.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    static esp_err_t erase();
+
+    /**
+     * @brief Returns the esp_timer time in microseconds at which restore() had applied the snapshot, 0 if it did not.
+     *
+     * esp_timer starts with the application, so this is the boot-to-relays-restored time without the bootloader.
+     */
+    static int64_t restoredAtUs();
+
+    /**
+     * @brief Returns the number of accessories the last restore() applied a record to.
+     */
+    static size_t restoredCount();
+
+    /**
+     * @brief Returns the number of blob writes save() made.
+     */
+    static uint32_t writeCount();
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include <atomic>
+#include <cstdint>
+#include <esp_matter.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Performance counters of one device, for diagnosing slow bridges in the field.
+ *
+ * Counters are bumped with relaxed atomic increments by whichever task drives the device (Matter task,
+ * actuation executor, report task) and read by the `matter device stats` shell command. With
+ * D_M_DEVICE_STATS disabled every record function compiles to nothing.
+ *
+ * With D_M_LATENCY_TRACING the device also keeps two latency histograms (`matter device latency`):
+ * - command: from the attribute write reaching app_attribute_cb (markCommand) to the call of the
+ *   accessory, including the time the write waited in the ActuationExecutor;
+ * - report: from the oldest unreported accessory state change (markReportRequested) to the attribute
+ *   report, including the time the change waited for the ReportDispatcher.
+ *
+ * nvsWrites and nvsDeferred count the changes of non-volatile attributes, written by a controller or by
+ * the accessory, by persistence (`matter device persistence`): each immediate one is a flash write,
+ * deferred ones cost at most one write per attribute and deferral window.
+ */
+struct DeviceStats
+{
+    std::atomic<uint32_t> updatesReceived{ 0 };    /**< Attribute writes dispatched to the device. */
+    std::atomic<uint32_t> updatesFiltered{ 0 };    /**< Writes without value or of attributes the device does not handle. */
+    std::atomic<uint32_t> reportsSent{ 0 };        /**< Attribute changes reported to subscribers. */
+    std::atomic<uint32_t> reportsSuppressed{ 0 };  /**< Reports skipped because subscribers already had the value. */
+    std::atomic<uint32_t> lockAcquisitions{ 0 };   /**< Chip stack locks taken by the device. */
+    std::atomic<uint32_t> lockFailures{ 0 };       /**< Chip stack locks that could not be taken. */
+    std::atomic<uint32_t> accessoryTimeUs{ 0 };    /**< Total time spent applying writes to the accessory. */
+    std::atomic<uint32_t> accessoryTimeMaxUs{ 0 }; /**< Longest time spent applying one write. */
+    std::atomic<uint32_t> nvsWrites{ 0 };          /**< Changes of non-volatile attributes written to NVS at once. */
+    std::atomic<uint32_t> nvsDeferred{ 0 };        /**< Changes of non-volatile attributes left to deferred persistence. */
+    std::atomic<uint32_t> actuationOverflows{ 0 }; /**< Writes run on the Matter task because the executor was full. */
+
+#if CONFIG_D_M_LATENCY_TRACING
+    LatencyHistogram commandLatency;             /**< Attribute write received until the accessory call. */
+    LatencyHistogram reportLatency;              /**< Accessory state change until the attribute report. */
+    std::atomic<uint32_t> pendingCommandAt{ 0 }; /**< Receive time of the write about to be applied, 0 if none. */
+    std::atomic<uint32_t> pendingReportAt{ 0 };  /**< Time of the oldest unreported change, 0 if none. */
+#endif
+
+    /**
+     * @brief Returns a wrapping microsecond timestamp, never 0, or 0 if counters are disabled.
+     */
+    static uint32_t now()
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        uint32_t timestamp = static_cast<uint32_t>(esp_timer_get_time());
+        return timestamp != 0 ? timestamp : 1;
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Stamps the write the next recordUpdate applies with the time it was received.
+     * @param receivedAtUs now() when the write reached app_attribute_cb.
+     */
+    void markCommand(uint32_t receivedAtUs)
+    {
+#if CONFIG_D_M_LATENCY_TRACING
+        pendingCommandAt.store(receivedAtUs, std::memory_order_relaxed);
+#else
+        (void) receivedAtUs;
+#endif
+    }
+
+    /**
+     * @brief Stamps an accessory state change, unless an older one is still unreported.
+     */
+    void markReportRequested()
+    {
+#if CONFIG_D_M_LATENCY_TRACING
+        uint32_t none = 0;
+        pendingReportAt.compare_exchange_strong(none, now(), std::memory_order_relaxed);
+#endif
+    }
+
+    /**
+     * @brief Records a write applied to the accessory.
+     * @param startUs now() before the accessory call.
+     * @param endUs now() after the accessory call.
+     */
+    void recordUpdate(uint32_t startUs, uint32_t endUs)
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        uint32_t timeUs = endUs - startUs;
+        updatesReceived.fetch_add(1, std::memory_order_relaxed);
+        accessoryTimeUs.fetch_add(timeUs, std::memory_order_relaxed);
+        if (timeUs > accessoryTimeMaxUs.load(std::memory_order_relaxed))
+        {
+            accessoryTimeMaxUs.store(timeUs, std::memory_order_relaxed);
+        }
+#else
+        (void) startUs;
+        (void) endUs;
+#endif
+#if CONFIG_D_M_LATENCY_TRACING
+        uint32_t receivedAt = pendingCommandAt.exchange(0, std::memory_order_relaxed);
+        if (receivedAt != 0)
+        {
+            commandLatency.record(startUs - receivedAt);
+        }
+#endif
+    }
+
+    /**
+     * @brief Records a write the device ignored.
+     */
+    void recordFilteredUpdate()
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        updatesReceived.fetch_add(1, std::memory_order_relaxed);
+        updatesFiltered.fetch_add(1, std::memory_order_relaxed);
+#endif
+#if CONFIG_D_M_LATENCY_TRACING
+        pendingCommandAt.store(0, std::memory_order_relaxed);
+#endif
+    }
+
+    /**
+     * @brief Records an attempt to take the chip stack lock.
+     * @param acquired false if the lock could not be taken.
+     */
+    void recordLock(bool acquired)
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        (acquired ? lockAcquisitions : lockFailures).fetch_add(1, std::memory_order_relaxed);
+#else
+        (void) acquired;
+#endif
+    }
+
+    /**
+     * @brief Records a change of an attribute, counted if esp_matter keeps the attribute in NVS.
+     * @param attributeFlags esp_matter::attribute::get_flags() of the attribute.
+     */
+    void recordPersistence(uint16_t attributeFlags)
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        if ((attributeFlags & esp_matter::ATTRIBUTE_FLAG_NONVOLATILE) == 0)
+        {
+            return;
+        }
+        ((attributeFlags & esp_matter::ATTRIBUTE_FLAG_DEFERRED) ? nvsDeferred : nvsWrites).fetch_add(1, std::memory_order_relaxed);
+#else
+        (void) attributeFlags;
+#endif
+    }
+
+    /**
+     * @brief Records a write the ActuationExecutor rejected, which the Matter task then applied itself.
+     */
+    void recordActuationOverflow()
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        actuationOverflows.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    /**
+     * @brief Records the outcome of a report, which ends the pending state change.
+     * @param sent Attribute changes reported to subscribers.
+     * @param suppressed Attribute reports skipped as unchanged.
+     */
+    void recordReports(uint32_t sent, uint32_t suppressed)
+    {
+#if CONFIG_D_M_DEVICE_STATS
+        if (sent != 0)
+        {
+            reportsSent.fetch_add(sent, std::memory_order_relaxed);
+        }
+        if (suppressed != 0)
+        {
+            reportsSuppressed.fetch_add(suppressed, std::memory_order_relaxed);
+        }
+#endif
+#if CONFIG_D_M_LATENCY_TRACING
+        if (sent == 0 && suppressed == 0)
+        {
+            return;
+        }
+
+        uint32_t changedAt = pendingReportAt.exchange(0, std::memory_order_relaxed);
+        if (sent != 0 && changedAt != 0)
+        {
+            reportLatency.record(now() - changedAt);
+        }
+#endif
+#if !CONFIG_D_M_DEVICE_STATS
+        (void) sent;
+        (void) suppressed;
+#endif
+    }
+
+    /**
+     * @brief Clears every counter and histogram.
+     */
+    void reset()
+    {
+        updatesReceived.store(0, std::memory_order_relaxed);
+        updatesFiltered.store(0, std::memory_order_relaxed);
+        reportsSent.store(0, std::memory_order_relaxed);
+        reportsSuppressed.store(0, std::memory_order_relaxed);
+        lockAcquisitions.store(0, std::memory_order_relaxed);
+        lockFailures.store(0, std::memory_order_relaxed);
+        accessoryTimeUs.store(0, std::memory_order_relaxed);
+        accessoryTimeMaxUs.store(0, std::memory_order_relaxed);
+        nvsWrites.store(0, std::memory_order_relaxed);
+        nvsDeferred.store(0, std::memory_order_relaxed);
+        actuationOverflows.store(0, std::memory_order_relaxed);
+#if CONFIG_D_M_LATENCY_TRACING
+        commandLatency.reset();
+        reportLatency.reset();
+#endif
+    }
+};
@@ -31,6 +31,12 @@ public:
      */
     esp_err_t updateAccessory(uint32_t attributeId) override;
 
+    /**
+     * @brief Updates the accessory state from the written value, without reading it back.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val) override;
+
     /**
      * @brief Reports the endpoint state.
      * @param onlySave If true, only save the endpoint state without reporting it.
@@ -44,9 +50,29 @@ public:
      */
     esp_err_t identify() override;
 
+    /**
+     * @brief Returns the actuator state for DeviceSnapshot, bit 0 is set if the lock is locked.
+     */
+    uint32_t captureState() const override;
+
+protected:
+    /**
+     * @brief Defers the persistence of the LockState attribute.
+     */
+    void deferStatePersistence() override;
+
 private:
-    esp_matter::endpoint_t * m_endpoint;      /**< Pointer to the esp_matter endpoint. */
-    DoorLockAccessoryInterface * m_accessory; /**< Pointer to the PluginAccessory instance. */
+    /**
+     * @brief Applies a written LockState value to the accessory.
+     * @param endpointId ID of the written endpoint.
+     * @param val The written value.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateLockState(uint16_t endpointId, esp_matter_attr_val_t * val);
+
+    esp_matter::endpoint_t * m_endpoint;            /**< Pointer to the esp_matter endpoint. */
+    esp_matter::attribute_t * m_lockStateAttribute; /**< Cached LockState attribute handle. */
+    DoorLockAccessoryInterface * m_accessory;       /**< Pointer to the PluginAccessory instance. */
 
     /**
      * @brief Retrieves the lock state of the endpoint.
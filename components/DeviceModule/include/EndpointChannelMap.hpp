@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sdkconfig.h>
+
+/**
+ * @brief Smallest power of two holding twice the channel capacity, so probing stays short.
+ */
+constexpr size_t endpointChannelSlotCount(size_t capacity)
+{
+    size_t count = 1;
+    while (count < capacity * 2)
+    {
+        count <<= 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Fixed-size map from endpoint IDs to the channel index of a multi-endpoint device.
+ *
+ * Devices that expose one endpoint per channel (relays, lifters) fill the map once at construction and
+ * route every write with find(), whose cost does not grow with the number of channels. The map is an
+ * open-addressed table twice the channel capacity; endpoint IDs are handed out sequentially, so the
+ * channels of one device land in distinct slots and a lookup is a single probe in practice.
+ */
+class EndpointChannelMap
+{
+public:
+    static constexpr uint8_t NO_CHANNEL = 0xFF; /**< Returned by find() for endpoints not in the map. */
+
+    /**
+     * @brief Constructor for EndpointChannelMap.
+     */
+    EndpointChannelMap();
+
+    /**
+     * @brief Maps an endpoint ID to a channel.
+     * @param endpointId ID of the channel endpoint.
+     * @param channel Channel index, lower than CONFIG_D_M_MAX_CHANNELS_PER_DEVICE.
+     * @return True on success, false if the channel is out of range or the map is full.
+     */
+    bool insert(uint16_t endpointId, uint8_t channel);
+
+    /**
+     * @brief Looks up the channel of an endpoint.
+     * @param endpointId ID of the endpoint.
+     * @return The channel index, or NO_CHANNEL if the endpoint is not mapped.
+     */
+    uint8_t find(uint16_t endpointId) const
+    {
+        size_t slot = endpointId & (SLOT_COUNT - 1);
+        for (size_t probe = 0; probe < SLOT_COUNT; probe++)
+        {
+            const Slot & entry = m_slots[slot];
+            if (entry.channel == NO_CHANNEL || entry.endpointId == endpointId)
+            {
+                return entry.channel;
+            }
+            slot = (slot + 1) & (SLOT_COUNT - 1);
+        }
+        return NO_CHANNEL;
+    }
+
+    /**
+     * @brief Removes every mapping.
+     */
+    void clear();
+
+private:
+    static constexpr size_t SLOT_COUNT = endpointChannelSlotCount(CONFIG_D_M_MAX_CHANNELS_PER_DEVICE); /**< Number of slots. */
+
+    /**
+     * @brief One mapping, free when channel is NO_CHANNEL.
+     */
+    struct Slot
+    {
+        uint16_t endpointId; /**< ID of the mapped endpoint. */
+        uint8_t channel;     /**< Channel of the endpoint. */
+    };
+
+    Slot m_slots[SLOT_COUNT]; /**< Open-addressed slots, indexed by endpoint ID. */
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Persisted map from device key to endpoint id, so bridged devices keep their endpoint ids across reboots.
+ *
+ * esp_matter hands out endpoint ids in creation order and only stores the lowest unused one. Reordering,
+ * adding or removing a descriptor in app_main therefore shifts the ids of the following devices, and every
+ * controller re-reads the PartsList, drops its bindings and subscriptions to the old ids and re-subscribes.
+ * The map stores the id of every bridged endpoint under the key (device id, device type, endpoint index
+ * within the device) in one NVS blob of 8-byte entries; at the next boot the endpoint is resumed with its
+ * stored id instead of created with the next free one. Devices without an entry get a new id, which
+ * esp_matter never gave out before.
+ *
+ * esp_matter only resumes ids below the stored lowest unused id, which it loads in esp_matter::start: devices
+ * created before the stack is started get plain creation-order ids and are not mapped. A device whose type
+ * changes is a new key and gets a new id, so controllers do not apply cached clusters of the old device.
+ * Entries of devices no longer created are kept until the map is full, a device that comes back keeps its id.
+ *
+ * DeviceRegistry brackets each device it creates with beginDevice() and endDevice() and saves the map after
+ * the table, under the chip stack lock. The map holds D_M_ENDPOINT_ID_MAP_ENTRIES endpoints.
+ */
+class EndpointIdMap
+{
+public:
+    /**
+     * @brief Stored endpoint id of one bridged endpoint.
+     */
+    struct Entry
+    {
+        uint16_t deviceId;   /**< Application id of the device. */
+        uint8_t type;        /**< DeviceType of the device. */
+        uint8_t index;       /**< Endpoint index within the device, the channel of multi-channel devices. */
+        uint16_t endpointId; /**< Endpoint id the endpoint is resumed with. */
+        uint16_t reserved;   /**< Always 0. */
+    };
+    static_assert(sizeof(Entry) == 8, "Endpoint id map entries are stored as 8-byte entries");
+
+    /**
+     * @brief Reads the stored map, dropping the one in memory.
+     *
+     * createBridgedNode() loads the map the first time it is needed, call this to read it again.
+     * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no valid map, or an error code on failure.
+     */
+    static esp_err_t load();
+
+    /**
+     * @brief Sets the device the following createBridgedNode() calls create endpoints for.
+     * @param deviceId Application id of the device.
+     * @param type DeviceType of the device.
+     */
+    static void beginDevice(uint16_t deviceId, uint8_t type);
+
+    /**
+     * @brief Ends the device set by beginDevice(), later endpoints are not mapped.
+     */
+    static void endDevice();
+
+    /**
+     * @brief Creates a bridged node endpoint, resuming the stored id of its key once the stack is started.
+     *
+     * The key is the current device and the number of endpoints created for it since beginDevice(). If
+     * esp_matter refuses the stored id the endpoint gets a new one and the entry is updated.
+     * @return The endpoint, or nullptr on failure.
+     */
+    static esp_matter::endpoint_t * createBridgedNode(esp_matter::node_t * node,
+                                                      esp_matter::endpoint::bridged_node::config_t * config, uint8_t flags,
+                                                      void * privData);
+
+    /**
+     * @brief Stores the map if an entry changed since it was loaded or last saved.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    static esp_err_t save();
+
+    /**
+     * @brief Erases the stored map and the one in memory, the next boot hands out new ids.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    static esp_err_t erase();
+
+    /**
+     * @brief Returns the number of endpoints resumed with their stored id since load().
+     */
+    static size_t resumedCount();
+
+    /**
+     * @brief Returns the number of endpoints that got a new id since load().
+     */
+    static size_t assignedCount();
+
+    /**
+     * @brief Returns the number of blob writes save() made.
+     */
+    static uint32_t writeCount();
+};
@@ -33,6 +33,12 @@ public:
      */
     esp_err_t updateAccessory(uint32_t attributeId) override;
 
+    /**
+     * @brief Updates the accessory state from the written value, without reading it back.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val) override;
+
     /**
      * @brief Reports the endpoint state.
      * @param onlySave If true, only save the endpoint state without reporting it.
@@ -46,9 +52,31 @@ public:
      */
     esp_err_t identify() override;
 
+    /**
+     * @brief Returns the actuator state for DeviceSnapshot, bit 0 is the power state of the fan.
+     */
+    uint32_t captureState() const override;
+
+protected:
+    /**
+     * @brief Defers the persistence of the FanMode and PercentSetting attributes.
+     */
+    void deferStatePersistence() override;
+
 private:
-    esp_matter::endpoint_t * m_endpoint; /**< Pointer to the esp_matter endpoint. */
-    FanAccessoryInterface * m_accessory; /**< Pointer to the FanAccessory instance. */
+    /**
+     * @brief Applies a written PercentSetting value to the accessory.
+     * @param endpointId ID of the written endpoint.
+     * @param val The written value.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updatePercentSetting(uint16_t endpointId, esp_matter_attr_val_t * val);
+
+    esp_matter::endpoint_t * m_endpoint;                 /**< Pointer to the esp_matter endpoint. */
+    esp_matter::attribute_t * m_fanModeAttribute;        /**< Cached FanMode attribute handle. */
+    esp_matter::attribute_t * m_percentSettingAttribute; /**< Cached PercentSetting attribute handle. */
+    esp_matter::attribute_t * m_percentCurrentAttribute; /**< Cached PercentCurrent attribute handle. */
+    FanAccessoryInterface * m_accessory;                 /**< Pointer to the FanAccessory instance. */
 
     /**
      * @brief Retrieves the power state of the endpoint.
@@ -58,6 +86,8 @@ private:
 
     /**
      * @brief Sets the power state of the endpoint.
+     *
+     * FanMode, PercentSetting and PercentCurrent are committed together under one chip stack lock.
      * @param powerState The new power state to set.
      */
     void setEndpointPowerState(bool powerState);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Fixed-size histogram of latencies in microseconds, for p50/p99/max at runtime.
+ *
+ * Below 4 us every microsecond has its own bucket; above, every power of two is split in two buckets,
+ * so a percentile, reported as the upper bound of its bucket, is at most 50% above the true value. The
+ * maximum is exact. The last bucket collects everything from about 0.8 s. 168 bytes of counters; a
+ * record is a few instructions and relaxed atomic increments, safe from any task.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @brief Number of buckets.
+     */
+    static constexpr uint8_t BUCKET_COUNT = 40;
+
+    /**
+     * @brief Records one latency.
+     */
+    void record(uint32_t latencyUs)
+    {
+        m_buckets[bucketOf(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        if (latencyUs > m_maxUs.load(std::memory_order_relaxed))
+        {
+            m_maxUs.store(latencyUs, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Returns the number of recorded latencies.
+     */
+    uint32_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the largest recorded latency.
+     */
+    uint32_t maxUs() const { return m_maxUs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the latency below which the given share of the recorded latencies fall.
+     * @param permille Share in thousandths, e.g. 500 for the median and 990 for p99.
+     * @return The upper bound of the bucket holding the percentile, at most maxUs(); 0 if empty.
+     */
+    uint32_t percentileUs(uint16_t permille) const;
+
+    /**
+     * @brief Clears the histogram.
+     */
+    void reset();
+
+private:
+    /**
+     * @brief Returns the bucket of a latency.
+     */
+    static uint8_t bucketOf(uint32_t latencyUs)
+    {
+        if (latencyUs < 4)
+        {
+            return static_cast<uint8_t>(latencyUs);
+        }
+
+        uint8_t msb    = static_cast<uint8_t>(31 - __builtin_clz(latencyUs));
+        uint8_t bucket = static_cast<uint8_t>(2 * msb + ((latencyUs >> (msb - 1)) & 1));
+        return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1;
+    }
+
+    /**
+     * @brief Returns the largest latency of a bucket.
+     */
+    static uint32_t upperBoundOf(uint8_t bucket);
+
+    std::atomic<uint32_t> m_buckets[BUCKET_COUNT] = {}; /**< Latencies per bucket. */
+    std::atomic<uint32_t> m_count{ 0 };                 /**< Recorded latencies. */
+    std::atomic<uint32_t> m_maxUs{ 0 };                 /**< Largest recorded latency. */
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "AttributeBatch.hpp"
+#include "BaseDeviceInterface.hpp"
+#include "EndpointChannelMap.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+static_assert(CONFIG_D_M_MAX_CHANNELS_PER_DEVICE <= 32, "Channel states are kept in 32-bit masks");
+static_assert(AttributeBatch::CAPACITY >= CONFIG_D_M_MAX_CHANNELS_PER_DEVICE, "A report of every channel is one batch");
+
+/**
+ * @brief Base class of devices that expose one on/off plug-in endpoint per channel.
+ *
+ * All channel endpoints are created in one pass and share one device object. Writes are routed to their
+ * channel through an EndpointChannelMap, and a report commits every channel in one batch under a single
+ * chip stack lock. The change mask of reportEndpoint(onlySave, changeMask) has one bit per channel.
+ *
+ * Derived classes only map channels to their accessory through applyChannelState and retrieveChannelState.
+ */
+class MultiChannelDevice : public BaseDeviceInterface
+{
+public:
+    /**
+     * @brief Destructor for MultiChannelDevice.
+     */
+    ~MultiChannelDevice();
+
+    /**
+     * @brief Updates the accessory of every channel from its endpoint in the data model.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint32_t attributeId) override;
+
+    /**
+     * @brief Updates the channel of the written endpoint, reading the value back from the data model.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint32_t attributeId, uint16_t endpointId) override;
+
+    /**
+     * @brief Updates the channel of the written endpoint from the written value.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val) override;
+
+    /**
+     * @brief Reports the state of every channel.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t reportEndpoint(bool onlySave = false) override;
+
+    /**
+     * @brief Reports the state of the changed channels.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Bit mask with bit N set if channel N changed.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t reportEndpoint(bool onlySave, uint32_t changeMask) override;
+
+    /**
+     * @brief Returns the number of channels of the device.
+     */
+    uint8_t getChannelCount() const { return m_channelCount; }
+
+    /**
+     * @brief Returns the actuator state for DeviceSnapshot, bit N is the state of channel N.
+     */
+    uint32_t captureState() const override;
+
+protected:
+    /**
+     * @brief Constructor for MultiChannelDevice.
+     * @param name Name of the device, channel endpoints are named "<name> <channel number>".
+     * @param channelNames Optional per-channel endpoint names, overriding the generated ones.
+     * @param channelCount Number of channels, at most CONFIG_D_M_MAX_CHANNELS_PER_DEVICE.
+     * @param endpointAggregator Pointer to the aggregator endpoint.
+     */
+    MultiChannelDevice(const char * name, const char * const * channelNames, uint8_t channelCount,
+                       esp_matter::endpoint_t * endpointAggregator);
+
+    /**
+     * @brief Applies a written on/off state to the accessory of a channel.
+     * @param channel Channel index.
+     * @param powerState The written state.
+     */
+    virtual void applyChannelState(uint8_t channel, bool powerState) = 0;
+
+    /**
+     * @brief Returns the current on/off state of the accessory of a channel.
+     * @param channel Channel index.
+     */
+    virtual bool retrieveChannelState(uint8_t channel) const = 0;
+
+    /**
+     * @brief Defers the persistence of the OnOff attribute of every channel.
+     */
+    void deferStatePersistence() override;
+
+private:
+    /**
+     * @brief Creates the endpoint of every channel.
+     */
+    void initializeChannels(const char * name, const char * const * channelNames, esp_matter::endpoint_t * endpointAggregator);
+
+    /**
+     * @brief Adds the on/off plug-in clusters to every channel endpoint and maps it to its channel.
+     */
+    void setupChannels();
+
+    /**
+     * @brief Applies a written OnOff value to the channel of the written endpoint.
+     * @param endpointId ID of the written endpoint.
+     * @param val The written value.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateOnOff(uint16_t endpointId, esp_matter_attr_val_t * val);
+
+    esp_matter::endpoint_t * m_endpoints[CONFIG_D_M_MAX_CHANNELS_PER_DEVICE];        /**< Endpoint of each channel. */
+    esp_matter::attribute_t * m_onOffAttributes[CONFIG_D_M_MAX_CHANNELS_PER_DEVICE]; /**< Cached OnOff handle of each channel. */
+    uint8_t m_channelCount;                                                           /**< Number of channels. */
+    EndpointChannelMap m_channelMap;                                                  /**< Endpoint ID to channel routing. */
+
+    // Delete the copy constructor and assignment operator
+    MultiChannelDevice(const MultiChannelDevice &)             = delete;
+    MultiChannelDevice & operator=(const MultiChannelDevice &) = delete;
+};
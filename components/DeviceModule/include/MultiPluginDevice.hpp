@@ -0,0 +1,56 @@
+#pragma once
+
+#include "MultiChannelDevice.hpp"
+#include "PluginAccessoryInterface.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Class representing a relay board, one plug-in accessory per channel.
+ */
+class MultiPluginDevice : public MultiChannelDevice
+{
+public:
+    /**
+     * @brief Constructor for MultiPluginDevice.
+     * @param name Optional name for the device, channel endpoints are named "<name> <channel number>".
+     * @param accessories Array of channelCount plug-in accessories, one per channel.
+     * @param channelCount Number of channels, at most CONFIG_D_M_MAX_CHANNELS_PER_DEVICE.
+     * @param endpointAggregator Pointer to the aggregator endpoint.
+     */
+    MultiPluginDevice(const char * name, PluginAccessoryInterface * const * accessories, uint8_t channelCount,
+                      esp_matter::endpoint_t * endpointAggregator = nullptr);
+
+    /**
+     * @brief Destructor for MultiPluginDevice.
+     */
+    ~MultiPluginDevice();
+
+    /**
+     * @brief Identifies the device.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t identify() override;
+
+protected:
+    void applyChannelState(uint8_t channel, bool powerState) override;
+    bool retrieveChannelState(uint8_t channel) const override;
+
+private:
+    /**
+     * @brief Report callback parameter of one channel accessory.
+     */
+    struct ChannelContext
+    {
+        MultiPluginDevice * device; /**< Device owning the channel. */
+        uint8_t channel;            /**< Channel of the accessory. */
+    };
+
+    PluginAccessoryInterface * m_accessories[CONFIG_D_M_MAX_CHANNELS_PER_DEVICE]; /**< Accessory of each channel. */
+    ChannelContext m_contexts[CONFIG_D_M_MAX_CHANNELS_PER_DEVICE];                /**< Report callback parameters. */
+
+    // delete the copy constructor and assignment operator
+    MultiPluginDevice(const MultiPluginDevice &)             = delete;
+    MultiPluginDevice & operator=(const MultiPluginDevice &) = delete;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Fixed-capacity pool of objects of one class, sized at compile time.
+ *
+ * Objects are placed into storage that is part of the pool, so a pool with static storage duration
+ * puts its whole capacity in .bss and the RAM it uses is known at link time. Releasing an object
+ * frees its slot for the next create() without touching the heap, so bridges that add and remove
+ * devices do not fragment the heap esp_matter allocates endpoints and sessions from.
+ */
+template <typename T, size_t Capacity>
+class ObjectPool
+{
+public:
+    ObjectPool() : m_inUse(), m_used(0), m_peak(0) {}
+
+    /**
+     * @brief Destroys the objects still in the pool.
+     */
+    ~ObjectPool()
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            if (m_inUse[i])
+            {
+                slot(i)->~T();
+            }
+        }
+    }
+
+    /**
+     * @brief Constructs an object in a free slot.
+     * @return The object, or nullptr if every slot is used.
+     */
+    template <typename... Args>
+    T * create(Args &&... args)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            if (!m_inUse[i])
+            {
+                m_inUse[i] = true;
+                m_used++;
+                m_peak = m_used > m_peak ? m_used : m_peak;
+                return new (m_storage[i]) T(std::forward<Args>(args)...);
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Destroys an object of the pool and frees its slot.
+     * @return false if the object does not belong to the pool.
+     */
+    bool destroy(T * object)
+    {
+        size_t index = indexOf(object);
+        if (index == Capacity)
+        {
+            return false;
+        }
+
+        object->~T();
+        m_inUse[index] = false;
+        m_used--;
+        return true;
+    }
+
+    /**
+     * @brief Returns true if the object lives in a used slot of the pool.
+     */
+    bool owns(const T * object) const { return indexOf(object) != Capacity; }
+
+    /**
+     * @brief Returns the number of used slots.
+     */
+    size_t used() const { return m_used; }
+
+    /**
+     * @brief Returns the highest number of slots used at once.
+     */
+    size_t peak() const { return m_peak; }
+
+    /**
+     * @brief Returns the number of slots.
+     */
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    T * slot(size_t index) { return reinterpret_cast<T *>(m_storage[index]); }
+
+    size_t indexOf(const T * object) const
+    {
+        const unsigned char * address = reinterpret_cast<const unsigned char *>(object);
+        if (address < m_storage[0] || address >= m_storage[0] + sizeof(m_storage))
+        {
+            return Capacity;
+        }
+
+        size_t index = static_cast<size_t>(address - m_storage[0]) / sizeof(T);
+        return m_inUse[index] ? index : Capacity;
+    }
+
+    alignas(T) unsigned char m_storage[Capacity][sizeof(T)]; /**< Object storage, one row per slot. */
+    bool m_inUse[Capacity];                                  /**< Slots holding a live object. */
+    size_t m_used;                                           /**< Number of used slots. */
+    size_t m_peak;                                           /**< Highest number of used slots. */
+
+    // delete the copy constructor and assignment operator
+    ObjectPool(const ObjectPool &)             = delete;
+    ObjectPool & operator=(const ObjectPool &) = delete;
+};
+
+/**
+ * @brief Pool of a device class that is configured out, creates nothing and takes no storage.
+ */
+template <typename T>
+class ObjectPool<T, 0>
+{
+public:
+    template <typename... Args>
+    T * create(Args &&...)
+    {
+        return nullptr;
+    }
+
+    bool destroy(T *) { return false; }
+    bool owns(const T *) const { return false; }
+
+    size_t used() const { return 0; }
+    size_t peak() const { return 0; }
+    static constexpr size_t capacity() { return 0; }
+};
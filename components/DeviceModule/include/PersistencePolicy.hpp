@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <sdkconfig.h>
+
+/**
+ * @brief How the non-volatile attributes holding the state of a device are written to NVS.
+ *
+ * esp_matter stores a non-volatile attribute on every change. Deferred attributes are stored once their
+ * value has not changed for CONFIG_ESP_MATTER_DEFERRED_ATTR_PERSISTENCE_TIME_MS, so a burst of toggles
+ * costs one flash write and a power loss inside the window loses at most the last changes of that window.
+ * Whether an attribute is non-volatile is fixed by esp_matter when the cluster is created. WindowDevice
+ * defers its current position attributes, which follow the motor, whatever the policy.
+ */
+enum class PersistencePolicy : uint8_t
+{
+    IMMEDIATE, /**< Every change is written to NVS at once, the esp_matter default. */
+    DEFERRED,  /**< Changes are written once the value settled for the esp_matter deferral window. */
+};
+
+/**
+ * @brief Policy of devices whose descriptor does not choose one, CONFIG_D_M_PERSISTENCE_DEFERRED.
+ */
+#if CONFIG_D_M_PERSISTENCE_DEFERRED
+constexpr PersistencePolicy DEFAULT_PERSISTENCE_POLICY = PersistencePolicy::DEFERRED;
+#else
+constexpr PersistencePolicy DEFAULT_PERSISTENCE_POLICY = PersistencePolicy::IMMEDIATE;
+#endif
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "BaseDeviceInterface.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Moves accessory reports off the accessory tasks onto one report task.
+ *
+ * Accessory callbacks call BaseDeviceInterface::requestReport, which for an attached device only ORs the
+ * change mask into the device's slot with an atomic operation and wakes the report task. The report
+ * task takes the chip stack lock once, reports every device with pending changes and releases it, so
+ * button and motor tasks never wait for the stack lock.
+ *
+ * Pending requests of a device coalesce: reportEndpoint reads the accessory state when it runs, so a
+ * burst of reports costs one report with the union of the change masks. A slot therefore never fills
+ * up and any number of accessory tasks may report the same device.
+ *
+ * Events (BaseDeviceInterface::requestEvent) carry a value that cannot be read back, such as the type of
+ * a switch press, so they do not coalesce: they go through a lock-free multi-producer ring of
+ * D_M_REPORT_EVENT_QUEUE_LENGTH records, emitted in order ahead of the state reports of the same batch.
+ * Events of a device detached meanwhile are dropped.
+ */
+static_assert((CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH & (CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH - 1)) == 0,
+              "The event queue length must be a power of two");
+
+class ReportDispatcher
+{
+public:
+    /**
+     * @brief Constructor for ReportDispatcher, the task is created by start().
+     */
+    ReportDispatcher();
+
+    /**
+     * @brief Destructor for ReportDispatcher, stops the task after the pending reports ran.
+     */
+    ~ReportDispatcher();
+
+    /**
+     * @brief Creates the report task.
+     * @return ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t start();
+
+    /**
+     * @brief Runs the pending reports, then stops the report task.
+     */
+    void stop();
+
+    /**
+     * @brief Routes the reports of a device through the dispatcher.
+     *
+     * Must be called with the chip stack lock held once the stack is started.
+     * @return ESP_OK on success, ESP_ERR_NO_MEM if every slot is used.
+     */
+    esp_err_t attach(BaseDeviceInterface * device);
+
+    /**
+     * @brief Stops routing the reports of a device and drops its pending reports.
+     *
+     * Must be called with the chip stack lock held once the stack is started, so no report of the device
+     * is running.
+     */
+    void detach(BaseDeviceInterface * device);
+
+    /**
+     * @brief Records a report request of an attached device and wakes the report task, without blocking.
+     * @param device Device to report.
+     * @param slot Slot of the device.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Device specific bit mask of the changed fields.
+     * @return false if the device is not attached or the task is not running, the caller reports itself.
+     */
+    bool post(BaseDeviceInterface * device, uint8_t slot, bool onlySave, uint32_t changeMask);
+
+    /**
+     * @brief Queues an event of an attached device and wakes the report task, without blocking.
+     * @param device Device raising the event.
+     * @param slot Slot of the device.
+     * @param event Device specific event, passed to reportEvent.
+     * @return false if the device is not attached, the task is not running or the queue is full, the caller
+     *         reports itself.
+     */
+    bool postEvent(BaseDeviceInterface * device, uint8_t slot, uint32_t event);
+
+    /**
+     * @brief Returns the number of report requests posted by accessories.
+     */
+    uint32_t posted() const { return m_posted.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of reportEndpoint calls made by the report task.
+     */
+    uint32_t reported() const { return m_reported.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of events the report task emitted.
+     */
+    uint32_t eventsReported() const { return m_eventsReported.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of events that found the queue full and were emitted by their accessory task.
+     */
+    uint32_t eventOverflows() const { return m_eventOverflows.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Pending requests of one device.
+     */
+    struct Slot
+    {
+        std::atomic<BaseDeviceInterface *> device; /**< Attached device, nullptr if free. */
+        std::atomic<uint32_t> reportMask;          /**< Changes to report. */
+        std::atomic<uint32_t> saveMask;            /**< Changes to only save. */
+        std::atomic<uint32_t> generation;          /**< Bumped by attach, tells queued events of a former device apart. */
+    };
+
+    /**
+     * @brief Queued event, a record of the event ring.
+     */
+    struct EventRecord
+    {
+        std::atomic<uint32_t> sequence; /**< Ring position the record is free or filled for. */
+        BaseDeviceInterface * device;   /**< Device that raised the event. */
+        uint32_t generation;            /**< Generation of the slot when the event was queued. */
+        uint32_t event;                 /**< Device specific event. */
+        uint8_t slot;                   /**< Slot of the device. */
+    };
+
+    /**
+     * @brief Entry point of the report task.
+     */
+    static void taskFunction(void * self);
+
+    /**
+     * @brief Reports every device with pending changes under one chip stack lock.
+     */
+    void drain();
+
+    /**
+     * @brief Emits the queued events, called by drain() with the chip stack lock held.
+     */
+    void drainEvents();
+
+    Slot m_slots[CONFIG_D_M_REPORT_DISPATCHER_SLOTS];                  /**< One slot per attached device. */
+    EventRecord m_events[CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH];        /**< Event ring. */
+    std::atomic<uint32_t> m_eventTail;                                 /**< Next ring position to fill, shared by producers. */
+    uint32_t m_eventHead;                                              /**< Next ring position to emit, report task only. */
+    SemaphoreHandle_t m_wake;                                          /**< Given when a request is posted. */
+    SemaphoreHandle_t m_stopped;                                       /**< Given by the task when it ends. */
+    std::atomic<bool> m_running;                                       /**< Cleared to end the task. */
+    std::atomic<uint32_t> m_posted;                                    /**< Requests posted. */
+    std::atomic<uint32_t> m_reported;                                  /**< reportEndpoint calls made. */
+    std::atomic<uint32_t> m_eventsReported;                            /**< reportEvent calls made. */
+    std::atomic<uint32_t> m_eventOverflows;                            /**< Events rejected with the ring full. */
+
+    // delete the copy constructor and assignment operator
+    ReportDispatcher(const ReportDispatcher &)             = delete;
+    ReportDispatcher & operator=(const ReportDispatcher &) = delete;
+};
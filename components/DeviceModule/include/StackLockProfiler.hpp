@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <esp_matter.h>
+#include <sdkconfig.h>
+
+/**
+ * @brief Takes the chip stack lock for the module and profiles how long each lock site waits for and holds it.
+ *
+ * Every lock site of the module goes through lock() and unlock() with its Site. With
+ * D_M_STACK_LOCK_PROFILER enabled, wait and hold times are measured with esp_timer_get_time(), which
+ * unlike the per-core cycle counter stays valid when a task migrates between cores, and counted in a
+ * fixed-bucket histogram per site, so a bridge where many accessories report at once shows whether the
+ * stack lock is the bottleneck (`matter device lock-stats`). Nested acquisitions (ALREADY_TAKEN) neither
+ * wait nor hold and are not recorded.
+ */
+class StackLockProfiler
+{
+public:
+    /**
+     * @brief Places in the module that take the chip stack lock.
+     */
+    enum Site : uint8_t
+    {
+        ATTRIBUTE_BATCH,   /**< AttributeBatch::commit, every device report. */
+        BUTTON_EVENT,      /**< ButtonDevice switch events. */
+        REPORT_DISPATCHER, /**< ReportDispatcher batches. */
+        DEVICE_REGISTRY,   /**< Adding and removing devices at runtime. */
+        SITE_COUNT,
+    };
+
+    /**
+     * @brief Number of histogram buckets, the last one is unbounded.
+     */
+    static constexpr uint8_t BUCKET_COUNT = 8;
+
+    /**
+     * @brief Exclusive upper bound in microseconds of every bucket but the last.
+     */
+    static constexpr uint32_t BUCKET_LIMITS_US[BUCKET_COUNT - 1] = { 10, 50, 100, 500, 1000, 5000, 10000 };
+
+    /**
+     * @brief Snapshot of the wait or hold times of one site.
+     */
+    struct Histogram
+    {
+        uint32_t buckets[BUCKET_COUNT]; /**< Number of times per bucket. */
+        uint32_t count;                 /**< Number of times recorded. */
+        uint32_t totalUs;               /**< Sum of the times. */
+        uint32_t maxUs;                 /**< Longest time. */
+    };
+
+    /**
+     * @brief Takes the chip stack lock, recording the wait.
+     * @param site Calling site.
+     * @return The chip_stack_lock result.
+     */
+    static esp_matter::lock::status_t lock(Site site);
+
+    /**
+     * @brief Releases the chip stack lock if lock() took it, recording the hold.
+     * @param site Calling site, the same as for lock().
+     * @param lockStatus Result of lock().
+     */
+    static void unlock(Site site, esp_matter::lock::status_t lockStatus);
+
+    /**
+     * @brief Returns the wait times of a site.
+     */
+    static Histogram waitTimes(Site site);
+
+    /**
+     * @brief Returns the hold times of a site.
+     */
+    static Histogram holdTimes(Site site);
+
+    /**
+     * @brief Prints the wait and hold histograms of every site to the console.
+     */
+    static void print();
+
+    /**
+     * @brief Clears every histogram.
+     */
+    static void reset();
+};
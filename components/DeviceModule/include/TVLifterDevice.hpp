@@ -1,14 +1,16 @@
 #pragma once
 
-#include "BaseDeviceInterface.hpp"
+#include "MultiChannelDevice.hpp"
 #include "TVLifterAccessoryInterface.hpp"
 #include <esp_err.h>
 #include <esp_matter.h>
 
 /**
  * @brief Class representing a TV lifter device.
+ *
+ * The lifter is exposed as three momentary on/off plug-in channels: up, down and stop.
  */
-class TVLifterDevice : public BaseDeviceInterface
+class TVLifterDevice : public MultiChannelDevice
 {
 public:
     /**
@@ -25,39 +27,31 @@ public:
      */
     ~TVLifterDevice();
 
-    /**
-     * @brief Updates the accessory state.
-     * @return ESP_OK on success, or an error code on failure.
-     */
-    esp_err_t updateAccessory(uint32_t attributeId) override;
-
-    esp_err_t updateAccessory(uint32_t attributeId, uint16_t endpointIּd) override;
-
-    /**
-     * @brief Reports the endpoint state.
-     * @param onlySave If true, only save the endpoint state without reporting it.
-     * @return ESP_OK on success, or an error code on failure.
-     */
-    esp_err_t reportEndpoint(bool onlySave = false) override;
-
     /**
      * @brief Identifies the device.
      * @return ESP_OK on success, or an error code on failure.
      */
     esp_err_t identify() override;
 
+protected:
+    void applyChannelState(uint8_t channel, bool powerState) override;
+    bool retrieveChannelState(uint8_t channel) const override;
+
 private:
     /**
-     * @brief Sets up the three plugins.
+     * @brief The three plugin channels.
      */
-    void setupThreePlugins();
+    enum Channel : uint8_t
+    {
+        CHANNEL_UP,    /**< Moves the TV up. */
+        CHANNEL_DOWN,  /**< Moves the TV down. */
+        CHANNEL_STOP,  /**< Stops the TV. */
+        CHANNEL_COUNT, /**< Number of channels. */
+    };
 
-    esp_matter::endpoint_t * m_endpointUp;    // Pointer to the up endpoint.
-    esp_matter::endpoint_t * m_endpointDown;  // Pointer to the down endpoint.
-    esp_matter::endpoint_t * m_endpointStop;  // Pointer to the stop endpoint.
-    TVLifterAccessoryInterface * m_accessory; /**< Pointer to the PluginAccessory instance. */
+    TVLifterAccessoryInterface * m_accessory; /**< Pointer to the TVLifterAccessory instance. */
 
     // delete the copy constructor and assignment operator
     TVLifterDevice(const TVLifterDevice &)             = delete;
     TVLifterDevice & operator=(const TVLifterDevice &) = delete;
-};
\ No newline at end of file
+};
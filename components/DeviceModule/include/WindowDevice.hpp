@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AttributeBatch.hpp"
 #include "BaseDeviceInterface.hpp"
 #include "BlindAccessoryInterface.hpp"
 #include <esp_err.h>
@@ -15,6 +16,15 @@
 class WindowDevice : public BaseDeviceInterface
 {
 public:
+    /**
+     * @brief Fields of the blind that can be passed in a report change mask.
+     */
+    enum ChangedField : uint32_t
+    {
+        CURRENT_POSITION = 1 << 0, /**< The current position changed. */
+        TARGET_POSITION  = 1 << 1, /**< The target position changed. */
+    };
+
     /**
      * @brief Construct a new WindowDevice object.
      *
@@ -38,6 +48,17 @@ public:
      */
     esp_err_t updateAccessory(uint32_t attributeId) override;
 
+    /**
+     * @brief Update the accessory state from the written value, without reading it back.
+     *
+     * @param endpointId The ID of the written endpoint.
+     * @param clusterId The ID of the written cluster.
+     * @param attributeId The ID of the written attribute.
+     * @param val The written value.
+     * @return esp_err_t Returns ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val) override;
+
     /**
      * @brief Report the state of the endpoint.
      * @param onlySave If true, only save the endpoint state without reporting it.
@@ -46,6 +67,15 @@ public:
      */
     esp_err_t reportEndpoint(bool onlySave) override;
 
+    /**
+     * @brief Report the attributes backed by the changed fields of the blind.
+     * @param onlySave If true, only save the endpoint state without reporting it.
+     * @param changeMask Bit mask of ChangedField values.
+     *
+     * @return esp_err_t Returns ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t reportEndpoint(bool onlySave, uint32_t changeMask) override;
+
     /**
      * @brief Identify the device.
      *
@@ -53,7 +83,21 @@ public:
      */
     esp_err_t identify() override;
 
+    /**
+     * @brief Returns the actuator state for DeviceSnapshot, the current position of the blind accessory.
+     */
+    uint32_t captureState() const override;
+
 private:
+    /**
+     * @brief Applies a written TargetPositionLiftPercent100ths value to the accessory.
+     *
+     * @param endpointId The ID of the written endpoint.
+     * @param val The written value.
+     * @return esp_err_t Returns ESP_OK on success, or an error code on failure.
+     */
+    esp_err_t updateTargetPosition(uint16_t endpointId, esp_matter_attr_val_t * val);
+
     /**
      * @brief Initializes the accessory.
      */
@@ -74,10 +118,15 @@ private:
 
     /**
      * @brief Sets deferred persistence for window covering attributes.
+     */
+    void setDeferredPersistenceForAttributes();
+
+    /**
+     * @brief Resolves and caches the window covering attribute handles used on the hot paths.
      *
      * @param windowCoveringCluster The window covering cluster.
      */
-    void setDeferredPersistenceForAttributes(esp_matter::cluster_t * windowCoveringCluster);
+    void resolveAttributeHandles(esp_matter::cluster_t * windowCoveringCluster);
 
     /**
      * @brief Sets up the window covering configuration.
@@ -86,20 +135,20 @@ private:
 
     /**
      * @brief Updates the current and target positions of the window covering.
+     *
+     * The changed position attributes and the operational status are committed together under one chip stack lock.
+     *
+     * @param onlySave If true, only save the attributes without reporting them.
+     * @param changeMask Bit mask of ChangedField values.
      */
-    void updateCurrentAndTargetPositions(bool onlySave);
+    void updateCurrentAndTargetPositions(bool onlySave, uint32_t changeMask);
 
     /**
      * @brief Updates the accessory position.
-     */
-    void updateAccessoryPosition();
-
-    /**
-     * @brief Gets the target position of the endpoint.
      *
-     * @return uint16_t The target position of the endpoint.
+     * @param targetPosition100ths The TargetPositionLiftPercent100ths value written to the endpoint.
      */
-    uint16_t getEndpointTargetPosition() const;
+    void updateAccessoryPosition(uint16_t targetPosition100ths);
 
     /**
      * @brief Gets the current position of the endpoint.
@@ -111,50 +160,49 @@ private:
     /**
      * @brief Gets the value of an attribute as a uint8_t.
      *
-     * @param attributeId The ID of the attribute to get the value from.
+     * @param attribute The cached handle of the attribute to get the value from.
      * @return uint8_t The value of the attribute.
      */
-    uint8_t getAttributeUint8Value(uint32_t attributeId) const;
+    uint8_t getAttributeUint8Value(esp_matter::attribute_t * attribute) const;
 
     /**
      * @brief Gets the value of an attribute as a uint16_t.
      *
-     * @param attributeId The ID of the attribute to get the value from.
+     * @param attribute The cached handle of the attribute to get the value from.
      * @return uint16_t The value of the attribute.
      */
-    uint16_t getAttributeUint16Value(uint32_t attributeId) const;
+    uint16_t getAttributeUint16Value(esp_matter::attribute_t * attribute) const;
 
     /**
-     * @brief Sets the target position of the endpoint.
+     * @brief Stages the target position of the endpoint.
      *
+     * @param batch The batch to stage the value in.
      * @param position The new target position to set.
      */
-    void setEndpointTargetPosition(uint16_t position, bool onlySave);
+    void setEndpointTargetPosition(AttributeBatch & batch, uint16_t position);
 
     /**
-     * @brief Sets the current position of the endpoint.
+     * @brief Stages the current position of the endpoint, in percent and in 100ths.
      *
+     * @param batch The batch to stage the values in.
      * @param position The new current position to set.
      */
-    void setEndpointCurrentPosition(uint16_t position, bool onlySave);
+    void setEndpointCurrentPosition(AttributeBatch & batch, uint16_t position);
 
     /**
-     * @brief Sets the operational status of the endpoint.
+     * @brief Stages the operational status of the endpoint.
      *
+     * @param batch The batch to stage the value in.
      * @param status The new operational status to set (bit mask).
      */
-    void setEndpointOperationalStatus(uint8_t status, bool onlySave);
-
-    /**
-     * @brief Reports the value of an attribute.
-     *
-     * @param attributeId The ID of the attribute to report.
-     * @param value The value of the attribute to report.
-     */
-    void reportAttribute(uint32_t attributeId, esp_matter_attr_val_t value, bool onlySave);
+    void setEndpointOperationalStatus(AttributeBatch & batch, uint8_t status);
 
-    esp_matter::endpoint_t * m_endpoint;   /**< Pointer to the ESP-Matter endpoint. */
-    BlindAccessoryInterface * m_accessory; /**< Pointer to the blind accessory interface. */
+    esp_matter::endpoint_t * m_endpoint;                            /**< Pointer to the ESP-Matter endpoint. */
+    esp_matter::attribute_t * m_currentPositionPercentageAttribute; /**< Cached CurrentPositionLiftPercentage handle. */
+    esp_matter::attribute_t * m_currentPosition100thsAttribute;     /**< Cached CurrentPositionLiftPercent100ths handle. */
+    esp_matter::attribute_t * m_targetPosition100thsAttribute;      /**< Cached TargetPositionLiftPercent100ths handle. */
+    esp_matter::attribute_t * m_operationalStatusAttribute;         /**< Cached OperationalStatus handle. */
+    BlindAccessoryInterface * m_accessory;                          /**< Pointer to the blind accessory interface. */
 
     // Delete the copy constructor and assignment operator
     WindowDevice(const WindowDevice &)             = delete;
@@ -0,0 +1,283 @@
+#include "ActuationExecutor.hpp"
+#include "DeviceLog.hpp"
+#include <esp_err.h>
+#include <freertos/task.h>
+
+static const char * TAG = "ActuationExecutor";
+
+ActuationExecutor::ActuationExecutor() :
+    m_queue(nullptr), m_mailboxLock(nullptr), m_runDone(nullptr), m_mailboxes(), m_running(nullptr), m_cancelWaiting(false),
+    m_executed(0), m_coalesced(0), m_overflows(0), m_cancelled(0)
+{}
+
+ActuationExecutor::~ActuationExecutor()
+{
+    stop();
+}
+
+esp_err_t ActuationExecutor::start()
+{
+    if (m_queue != nullptr)
+    {
+        return ESP_OK;
+    }
+
+    m_mailboxLock = xSemaphoreCreateMutex();
+    m_runDone     = xSemaphoreCreateBinary();
+    if (m_mailboxLock == nullptr || m_runDone == nullptr)
+    {
+        DM_LOGE(TAG, "Failed to create mailbox lock");
+        deleteSemaphores();
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_queue = xQueueCreate(CONFIG_D_M_ACTUATION_QUEUE_LENGTH, sizeof(Work));
+    if (m_queue == nullptr)
+    {
+        DM_LOGE(TAG, "Failed to create actuation queue");
+        deleteSemaphores();
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t core = CONFIG_D_M_ACTUATION_TASK_CORE < 0 ? tskNO_AFFINITY : CONFIG_D_M_ACTUATION_TASK_CORE;
+    if (xTaskCreatePinnedToCore(taskFunction, "actuation", CONFIG_D_M_ACTUATION_TASK_STACK_SIZE, this,
+                                CONFIG_D_M_ACTUATION_TASK_PRIORITY, nullptr, core) != pdPASS)
+    {
+        DM_LOGE(TAG, "Failed to create actuation task");
+        vQueueDelete(m_queue);
+        m_queue = nullptr;
+        deleteSemaphores();
+        return ESP_ERR_NO_MEM;
+    }
+
+    DM_LOGI(TAG, "Actuation executor started, %d slots, core %d", CONFIG_D_M_ACTUATION_QUEUE_LENGTH,
+            CONFIG_D_M_ACTUATION_TASK_CORE);
+    return ESP_OK;
+}
+
+void ActuationExecutor::stop()
+{
+    if (m_queue == nullptr)
+    {
+        return;
+    }
+
+    postAndWait(Work::STOP);
+    vQueueDelete(m_queue);
+    m_queue = nullptr;
+    deleteSemaphores();
+}
+
+esp_err_t ActuationExecutor::submit(BaseDeviceInterface * device, uint16_t endpointId, uint32_t clusterId, uint32_t attributeId,
+                                    const esp_matter_attr_val_t * val)
+{
+    if (m_queue == nullptr)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (device == nullptr || val == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!isScalar(*val))
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(m_mailboxLock, portMAX_DELAY);
+
+    // Latest wins: a pending write of the same attribute takes the new value and keeps its queue position
+    uint8_t freeMailbox = CONFIG_D_M_ACTUATION_QUEUE_LENGTH;
+    for (uint8_t i = 0; i < CONFIG_D_M_ACTUATION_QUEUE_LENGTH; i++)
+    {
+        Mailbox & mailbox = m_mailboxes[i];
+        if (mailbox.device == device && mailbox.endpointId == endpointId && mailbox.clusterId == clusterId &&
+            mailbox.attributeId == attributeId)
+        {
+            mailbox.val = *val;
+            xSemaphoreGive(m_mailboxLock);
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return ESP_OK;
+        }
+        if (mailbox.device == nullptr && freeMailbox == CONFIG_D_M_ACTUATION_QUEUE_LENGTH)
+        {
+            freeMailbox = i;
+        }
+    }
+
+    // Never block the Matter task, no free mailbox means the burst outran the accessories
+    if (freeMailbox == CONFIG_D_M_ACTUATION_QUEUE_LENGTH)
+    {
+        xSemaphoreGive(m_mailboxLock);
+        m_overflows.fetch_add(1, std::memory_order_relaxed);
+        DM_LOGW(TAG, "Actuation mailboxes full, write to endpoint %u rejected", endpointId);
+        return ESP_ERR_NO_MEM;
+    }
+
+    Mailbox & mailbox    = m_mailboxes[freeMailbox];
+    mailbox.device       = device;
+    mailbox.endpointId   = endpointId;
+    mailbox.clusterId    = clusterId;
+    mailbox.attributeId  = attributeId;
+    mailbox.val          = *val;
+    mailbox.receivedAtUs = DeviceStats::now();
+
+    Work work    = {};
+    work.kind    = Work::UPDATE;
+    work.mailbox = freeMailbox;
+
+    // A pending FLUSH or STOP may hold the last queue item
+    if (xQueueSend(m_queue, &work, 0) != pdPASS)
+    {
+        mailbox.device = nullptr;
+        xSemaphoreGive(m_mailboxLock);
+        m_overflows.fetch_add(1, std::memory_order_relaxed);
+        DM_LOGW(TAG, "Actuation queue full, write to endpoint %u rejected", endpointId);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreGive(m_mailboxLock);
+    return ESP_OK;
+}
+
+esp_err_t ActuationExecutor::flush()
+{
+    if (m_queue == nullptr)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return postAndWait(Work::FLUSH);
+}
+
+void ActuationExecutor::cancel(BaseDeviceInterface * device)
+{
+    if (m_queue == nullptr || device == nullptr)
+    {
+        return;
+    }
+
+    xSemaphoreTake(m_mailboxLock, portMAX_DELAY);
+
+    // The queued UPDATE items stay, runMailbox skips the freed mailboxes
+    uint32_t cancelled = 0;
+    for (Mailbox & mailbox : m_mailboxes)
+    {
+        if (mailbox.device == device)
+        {
+            mailbox.device = nullptr;
+            cancelled++;
+        }
+    }
+
+    // A write copied out of its mailbox still calls into the device
+    bool running    = m_running == device;
+    m_cancelWaiting = running;
+    xSemaphoreGive(m_mailboxLock);
+
+    if (running)
+    {
+        xSemaphoreTake(m_runDone, portMAX_DELAY);
+    }
+    if (cancelled > 0)
+    {
+        m_cancelled.fetch_add(cancelled, std::memory_order_relaxed);
+        DM_LOGD(TAG, "Dropped %u pending writes", (unsigned) cancelled);
+    }
+}
+
+bool ActuationExecutor::isScalar(const esp_matter_attr_val_t & val)
+{
+    int type = val.type & ~ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS;
+    return type == ESP_MATTER_VAL_TYPE_BOOLEAN || type == ESP_MATTER_VAL_TYPE_INTEGER || type == ESP_MATTER_VAL_TYPE_FLOAT ||
+        (type >= ESP_MATTER_VAL_TYPE_INT8 && type <= ESP_MATTER_VAL_TYPE_ENUM16);
+}
+
+void ActuationExecutor::taskFunction(void * self)
+{
+    ActuationExecutor * executor = static_cast<ActuationExecutor *>(self);
+    QueueHandle_t queue          = executor->m_queue;
+
+    Work work;
+    while (true)
+    {
+        if (xQueueReceive(queue, &work, portMAX_DELAY) != pdPASS)
+        {
+            continue;
+        }
+
+        if (work.kind == Work::UPDATE)
+        {
+            executor->runMailbox(work.mailbox);
+            continue;
+        }
+
+        bool stopping = work.kind == Work::STOP;
+        xSemaphoreGive(work.done);
+        if (stopping)
+        {
+            break;
+        }
+    }
+
+    vTaskDelete(nullptr);
+}
+
+void ActuationExecutor::runMailbox(uint8_t index)
+{
+    // Copy the write out and free the mailbox first, so writes arriving meanwhile queue a new run
+    xSemaphoreTake(m_mailboxLock, portMAX_DELAY);
+    Mailbox mailbox           = m_mailboxes[index];
+    m_mailboxes[index].device = nullptr;
+    m_running                 = mailbox.device;
+    xSemaphoreGive(m_mailboxLock);
+
+    // Dropped by cancel(), or already run by the UPDATE of a mailbox reused after a cancel
+    if (mailbox.device == nullptr)
+    {
+        return;
+    }
+
+    mailbox.device->getStats().markCommand(mailbox.receivedAtUs);
+    mailbox.device->updateAccessory(mailbox.endpointId, mailbox.clusterId, mailbox.attributeId, &mailbox.val);
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+
+    xSemaphoreTake(m_mailboxLock, portMAX_DELAY);
+    m_running = nullptr;
+    if (m_cancelWaiting)
+    {
+        m_cancelWaiting = false;
+        xSemaphoreGive(m_runDone);
+    }
+    xSemaphoreGive(m_mailboxLock);
+}
+
+void ActuationExecutor::deleteSemaphores()
+{
+    if (m_mailboxLock != nullptr)
+    {
+        vSemaphoreDelete(m_mailboxLock);
+        m_mailboxLock = nullptr;
+    }
+    if (m_runDone != nullptr)
+    {
+        vSemaphoreDelete(m_runDone);
+        m_runDone = nullptr;
+    }
+}
+
+esp_err_t ActuationExecutor::postAndWait(Work::Kind kind)
+{
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    if (done == nullptr)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    Work work = {};
+    work.kind = kind;
+    work.done = done;
+    xQueueSend(m_queue, &work, portMAX_DELAY);
+    xSemaphoreTake(done, portMAX_DELAY);
+    vSemaphoreDelete(done);
+    return ESP_OK;
+}
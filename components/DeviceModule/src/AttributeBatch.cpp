@@ -0,0 +1,138 @@
+#include "AttributeBatch.hpp"
+#include "DeviceLog.hpp"
+#include "StackLockProfiler.hpp"
+#include <app/reporting/reporting.h>
+#include <esp_err.h>
+#include <esp_matter.h>
+
+static const char * TAG = "AttributeBatch";
+
+AttributeBatch::AttributeBatch(DeviceStats * stats) : m_entries(), m_count(0), m_stats(stats) {}
+
+esp_err_t AttributeBatch::stage(uint16_t endpointId, uint32_t clusterId, esp_matter::attribute_t * attribute,
+                                esp_matter_attr_val_t value)
+{
+    if (attribute == nullptr)
+    {
+        DM_LOGE(TAG, "Attribute is null");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (m_count >= CAPACITY)
+    {
+        DM_LOGE(TAG, "Batch is full, dropping attribute 0x%08x", (unsigned) esp_matter::attribute::get_id(attribute));
+        return ESP_ERR_NO_MEM;
+    }
+
+    Entry & entry    = m_entries[m_count++];
+    entry.attribute  = attribute;
+    entry.value      = value;
+    entry.clusterId  = clusterId;
+    entry.endpointId = endpointId;
+    return ESP_OK;
+}
+
+esp_err_t AttributeBatch::commit(bool onlySave)
+{
+    if (m_count == 0)
+    {
+        return ESP_OK;
+    }
+
+    esp_matter::lock::status_t lockStatus = StackLockProfiler::lock(StackLockProfiler::ATTRIBUTE_BATCH);
+    if (m_stats != nullptr && lockStatus != esp_matter::lock::status::ALREADY_TAKEN)
+    {
+        m_stats->recordLock(lockStatus == esp_matter::lock::status::SUCCESS);
+    }
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        m_count = 0;
+        return ESP_FAIL;
+    }
+
+    esp_err_t result    = ESP_OK;
+    uint32_t sent       = 0;
+    uint32_t suppressed = 0;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        Entry & entry = m_entries[i];
+
+        // Subscribers already have what the data model holds, controller writes included
+        esp_matter_attr_val_t current;
+        if (esp_matter::attribute::get_val(entry.attribute, &current) == ESP_OK && isSameValue(current, entry.value))
+        {
+            if (!onlySave)
+            {
+                suppressed++;
+            }
+            continue;
+        }
+
+        if (esp_matter::attribute::set_val(entry.attribute, &entry.value) != ESP_OK)
+        {
+            DM_LOGE(TAG, "Failed to set attribute 0x%08x", (unsigned) esp_matter::attribute::get_id(entry.attribute));
+            result = ESP_FAIL;
+            continue;
+        }
+        if (m_stats != nullptr)
+        {
+            m_stats->recordPersistence(esp_matter::attribute::get_flags(entry.attribute));
+        }
+
+        if (onlySave)
+        {
+            continue;
+        }
+
+        MatterReportingAttributeChangeCallback(entry.endpointId, entry.clusterId, esp_matter::attribute::get_id(entry.attribute));
+        sent++;
+    }
+
+    StackLockProfiler::unlock(StackLockProfiler::ATTRIBUTE_BATCH, lockStatus);
+
+    if (m_stats != nullptr)
+    {
+        m_stats->recordReports(sent, suppressed);
+    }
+
+    m_count = 0;
+    return result;
+}
+
+bool AttributeBatch::isSameValue(const esp_matter_attr_val_t & lhs, const esp_matter_attr_val_t & rhs)
+{
+    if (lhs.type != rhs.type)
+    {
+        return false;
+    }
+
+    switch (lhs.type & ~ESP_MATTER_VAL_TYPE_NULLABLE_ATTRIBUTE_FLAGS)
+    {
+    case ESP_MATTER_VAL_TYPE_BOOLEAN:
+        return lhs.val.b == rhs.val.b;
+    case ESP_MATTER_VAL_TYPE_INT8:
+    case ESP_MATTER_VAL_TYPE_UINT8:
+    case ESP_MATTER_VAL_TYPE_ENUM8:
+    case ESP_MATTER_VAL_TYPE_BITMAP8:
+        return lhs.val.u8 == rhs.val.u8;
+    case ESP_MATTER_VAL_TYPE_INT16:
+    case ESP_MATTER_VAL_TYPE_UINT16:
+    case ESP_MATTER_VAL_TYPE_ENUM16:
+    case ESP_MATTER_VAL_TYPE_BITMAP16:
+        return lhs.val.u16 == rhs.val.u16;
+    case ESP_MATTER_VAL_TYPE_INTEGER:
+        return lhs.val.i == rhs.val.i;
+    case ESP_MATTER_VAL_TYPE_FLOAT:
+        return lhs.val.f == rhs.val.f;
+    case ESP_MATTER_VAL_TYPE_INT32:
+    case ESP_MATTER_VAL_TYPE_UINT32:
+    case ESP_MATTER_VAL_TYPE_BITMAP32:
+        return lhs.val.u32 == rhs.val.u32;
+    case ESP_MATTER_VAL_TYPE_INT64:
+    case ESP_MATTER_VAL_TYPE_UINT64:
+        return lhs.val.u64 == rhs.val.u64;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,73 @@
+#include "BaseDeviceInterface.hpp"
+#include "ReportDispatcher.hpp"
+#include <esp_err.h>
+
+static const char * TAG = "BaseDeviceInterface";
+
+BaseDeviceInterface::~BaseDeviceInterface()
+{
+    ReportDispatcher * dispatcher = m_reportDispatcher.load(std::memory_order_acquire);
+    if (dispatcher != nullptr)
+    {
+        dispatcher->detach(this);
+    }
+}
+
+esp_err_t BaseDeviceInterface::requestReport(bool onlySave, uint32_t changeMask)
+{
+    if (!onlySave)
+    {
+        m_stats.markReportRequested();
+    }
+
+    ReportDispatcher * dispatcher = m_reportDispatcher.load(std::memory_order_acquire);
+    if (dispatcher != nullptr && dispatcher->post(this, m_reportSlot, onlySave, changeMask))
+    {
+        return ESP_OK;
+    }
+
+    return reportEndpoint(onlySave, changeMask);
+}
+
+esp_err_t BaseDeviceInterface::requestEvent(uint32_t event)
+{
+    m_stats.markReportRequested();
+
+    ReportDispatcher * dispatcher = m_reportDispatcher.load(std::memory_order_acquire);
+    if (dispatcher != nullptr && dispatcher->postEvent(this, m_reportSlot, event))
+    {
+        return ESP_OK;
+    }
+
+    return reportEvent(event);
+}
+
+void BaseDeviceInterface::applyPersistencePolicy(PersistencePolicy policy)
+{
+    m_persistencePolicy = policy;
+    if (policy == PersistencePolicy::DEFERRED)
+    {
+        deferStatePersistence();
+    }
+}
+
+void BaseDeviceInterface::deferPersistence(esp_matter::attribute_t * attribute)
+{
+    if (attribute == nullptr)
+    {
+        return;
+    }
+
+    if (esp_matter::attribute::set_deferred_persistence(attribute) != ESP_OK)
+    {
+        DM_LOGW(TAG, "Attribute 0x%08x is not stored in NVS", (unsigned) esp_matter::attribute::get_id(attribute));
+    }
+}
+
+void BaseDeviceInterface::recordPersistence(esp_matter::attribute_t * attribute)
+{
+    if (attribute != nullptr)
+    {
+        m_stats.recordPersistence(esp_matter::attribute::get_flags(attribute));
+    }
+}
@@ -0,0 +1,177 @@
+#include "BootProfiler.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+
+static const char * const PHASE_NAMES[BootProfiler::PHASE_COUNT] = {
+    "AppStart",      "NvsInit",        "SnapshotRestored", "NodeCreated", "AggregatorCreated",
+    "DeviceCreated", "DevicesCreated", "MatterStarted",    "ServerReady", "Commissionable",
+};
+
+#if CONFIG_D_M_BOOT_PROFILER
+static_assert(BootProfiler::PHASE_COUNT <= 32, "Recorded phases are kept in a 32-bit mask");
+
+/* "BOOT", tells retained records from the random RTC memory content after a power cut */
+static constexpr uint32_t RETAINED_MAGIC = 0x544F4F42;
+
+/**
+ * @brief Records kept across resets.
+ */
+struct RetainedProfile
+{
+    uint32_t magic;                                                /**< RETAINED_MAGIC once begin() ran. */
+    BootProfiler::Record records[CONFIG_D_M_BOOT_PROFILER_RECORDS]; /**< Records in the order they were claimed. */
+};
+
+static RTC_NOINIT_ATTR RetainedProfile s_retained;
+static RetainedProfile s_previous;
+
+/* Slots are claimed with an atomic counter in internal RAM, RTC memory is only written with plain stores */
+static std::atomic<uint32_t> s_nextSlot{ 0 };
+static std::atomic<uint32_t> s_markedPhases{ 0 };
+static bool s_begun = false;
+
+static size_t copyValid(const RetainedProfile & profile, BootProfiler::Record * records, size_t capacity)
+{
+    if (profile.magic != RETAINED_MAGIC || records == nullptr)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (const BootProfiler::Record & record : profile.records)
+    {
+        if (count == capacity)
+        {
+            break;
+        }
+        if (record.valid == 1 && record.phase < BootProfiler::PHASE_COUNT)
+        {
+            records[count++] = record;
+        }
+    }
+    return count;
+}
+
+static void printProfile(const char * title, const RetainedProfile & profile)
+{
+    BootProfiler::Record records[CONFIG_D_M_BOOT_PROFILER_RECORDS];
+    size_t count = copyValid(profile, records, CONFIG_D_M_BOOT_PROFILER_RECORDS);
+    if (count == 0)
+    {
+        return;
+    }
+
+    printf("%s, %u records\n", title, (unsigned) count);
+    printf("%-18s %6s %10s %10s\n", "phase", "id", "atUs", "deltaUs");
+    uint32_t previousUs = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const BootProfiler::Record & record = records[i];
+        char id[8]                          = "";
+        if (record.phase == BootProfiler::DEVICE_CREATED)
+        {
+            snprintf(id, sizeof(id), "%u", (unsigned) record.id);
+        }
+        printf("%-18s %6s %10u %10u\n", PHASE_NAMES[record.phase], id, (unsigned) record.timeUs,
+               (unsigned) (record.timeUs - previousUs));
+        previousUs = record.timeUs;
+    }
+}
+
+void BootProfiler::begin()
+{
+    // Keep the previous boot before this one overwrites it
+    s_previous = s_retained;
+
+    memset(s_retained.records, 0, sizeof(s_retained.records));
+    s_retained.magic = RETAINED_MAGIC;
+    s_nextSlot.store(0, std::memory_order_relaxed);
+    s_markedPhases.store(0, std::memory_order_relaxed);
+    s_begun = true;
+}
+
+void BootProfiler::mark(Phase phase, uint16_t id)
+{
+    if (!s_begun || phase >= PHASE_COUNT)
+    {
+        return;
+    }
+
+    uint32_t timeUs = static_cast<uint32_t>(esp_timer_get_time());
+    if (phase == DEVICE_CREATED && (s_markedPhases.load(std::memory_order_relaxed) & (1u << DEVICES_CREATED)) != 0)
+    {
+        return;
+    }
+    if (phase != DEVICE_CREATED && (s_markedPhases.fetch_or(1u << phase, std::memory_order_relaxed) & (1u << phase)) != 0)
+    {
+        return;
+    }
+
+    uint32_t slot = s_nextSlot.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= CONFIG_D_M_BOOT_PROFILER_RECORDS)
+    {
+        return;
+    }
+
+    Record & record = s_retained.records[slot];
+    record.timeUs   = timeUs;
+    record.id       = id;
+    record.phase    = phase;
+    record.valid    = 1;
+}
+
+size_t BootProfiler::records(Record * records, size_t capacity)
+{
+    return copyValid(s_retained, records, capacity);
+}
+
+size_t BootProfiler::previousRecords(Record * records, size_t capacity)
+{
+    return copyValid(s_previous, records, capacity);
+}
+
+void BootProfiler::print()
+{
+    printProfile("Boot profile", s_retained);
+    printProfile("\nPrevious boot", s_previous);
+}
+
+#else
+
+void BootProfiler::begin() {}
+
+void BootProfiler::mark(Phase phase, uint16_t id)
+{
+    (void) phase;
+    (void) id;
+}
+
+size_t BootProfiler::records(Record * records, size_t capacity)
+{
+    (void) records;
+    (void) capacity;
+    return 0;
+}
+
+size_t BootProfiler::previousRecords(Record * records, size_t capacity)
+{
+    (void) records;
+    (void) capacity;
+    return 0;
+}
+
+void BootProfiler::print()
+{
+    printf("Boot profiler is disabled, enable CONFIG_D_M_BOOT_PROFILER\n");
+}
+
+#endif
+
+const char * BootProfiler::phaseName(uint8_t phase)
+{
+    return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
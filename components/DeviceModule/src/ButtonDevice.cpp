@@ -1,24 +1,33 @@
 #include "ButtonDevice.hpp"
+#include "AttributeBatch.hpp"
+#include "DeviceLog.hpp"
+#include "StackLockProfiler.hpp"
 #include <esp_err.h>
-#include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_endpoint.h>
 
 static const char * TAG = "ButtonDevice";
 
 ButtonDevice::ButtonDevice(char * name, StatelessButtonAccessoryInterface * accessory,
-                           esp_matter::endpoint_t * endpointAggregator) : m_endpoint(nullptr), m_accessory(accessory)
+                           esp_matter::endpoint_t * endpointAggregator) :
+    m_endpoint(nullptr), m_currentPositionAttribute(nullptr), m_accessory(accessory)
 {
-    ESP_LOGI(TAG, "Creating ButtonDevice");
+    DM_LOGI(TAG, "Creating ButtonDevice");
 
     if (m_accessory != nullptr)
     {
+        // Each callback is one press, capture its type now as the next press overwrites it
         m_accessory->setReportCallback(
-            [](void * self, bool onlySave) { static_cast<ButtonDevice *>(self)->reportEndpoint(onlySave); }, this);
+            [](void * self, bool onlySave) {
+                ButtonDevice * device = static_cast<ButtonDevice *>(self);
+                (void) onlySave;
+                device->requestEvent(static_cast<uint32_t>(device->m_accessory->getLastPressType()));
+            },
+            this);
     }
     else
     {
-        ESP_LOGW(TAG, "ButtonAccessory is null");
+        DM_LOGW(TAG, "ButtonAccessory is null");
     }
 
     if (endpointAggregator != nullptr)
@@ -26,48 +35,52 @@ ButtonDevice::ButtonDevice(char * name, StatelessButtonAccessoryInterface * acce
         m_endpoint = initializeBridgedNode(name, endpointAggregator, this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize bridged node");
+            DM_LOGE(TAG, "Failed to initialize bridged node");
         }
     }
     else
     {
-        ESP_LOGI(TAG, "Creating ButtonDevice standalone endpoint");
+        DM_LOGI(TAG, "Creating ButtonDevice standalone endpoint");
         m_endpoint = initializeStandaloneNode(this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize standalone node");
+            DM_LOGE(TAG, "Failed to initialize standalone node");
         }
     }
 
     initializeButton();
+    enableEndpoint(m_endpoint);
 }
 
 ButtonDevice::~ButtonDevice()
 {
-    ESP_LOGI(TAG, "Destroying ButtonDevice");
-    // Clean up resources if needed
-    // Example: If m_endpoint or m_accessory needs explicit deallocation, do it here
+    DM_LOGI(TAG, "Destroying ButtonDevice");
+    if (m_accessory != nullptr)
+    {
+        m_accessory->setReportCallback(nullptr, nullptr);
+    }
+    releaseEndpoint(m_endpoint);
 }
 
 void ButtonDevice::initializeButton()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
     esp_matter::endpoint::generic_switch::config_t genericSwitchConfig;
     if (esp_matter::endpoint::generic_switch::add(m_endpoint, &genericSwitchConfig) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add generic switch configuration");
+        DM_LOGE(TAG, "Failed to add generic switch configuration");
         return;
     }
 
     esp_matter::cluster_t * switchCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::Switch::Id);
     if (switchCluster == nullptr)
     {
-        ESP_LOGE(TAG, "Switch cluster is null");
+        DM_LOGE(TAG, "Switch cluster is null");
         return;
     }
 
@@ -75,7 +88,7 @@ void ButtonDevice::initializeButton()
         esp_matter::cluster::switch_cluster::feature::momentary_switch_release::add(switchCluster) != ESP_OK ||
         esp_matter::cluster::switch_cluster::feature::momentary_switch_long_press::add(switchCluster) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add switch features");
+        DM_LOGE(TAG, "Failed to add switch features");
         return;
     }
 
@@ -83,20 +96,23 @@ void ButtonDevice::initializeButton()
     if (esp_matter::cluster::switch_cluster::feature::momentary_switch_multi_press::add(switchCluster, &doublePressConfig) !=
         ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add multi-press feature");
+        DM_LOGE(TAG, "Failed to add multi-press feature");
     }
+
+    m_currentPositionAttribute = resolveAttribute(m_endpoint, chip::app::Clusters::Switch::Id,
+                                                  chip::app::Clusters::Switch::Attributes::CurrentPosition::Id);
 }
 
 esp_err_t ButtonDevice::updateAccessory(uint32_t attributeId)
 {
-    ESP_LOGI(TAG, "Updating accessory state");
+    DM_LOGD(TAG, "Updating accessory state");
     // Implement specific accessory update logic here.
     return ESP_OK;
 }
 
 esp_err_t ButtonDevice::reportEndpoint(bool onlySave)
 {
-    ESP_LOGI(TAG, "Reporting endpoint state");
+    DM_LOGD(TAG, "Reporting endpoint state");
 
     if (m_accessory != nullptr)
     {
@@ -105,23 +121,30 @@ esp_err_t ButtonDevice::reportEndpoint(bool onlySave)
     }
     else
     {
-        ESP_LOGE(TAG, "ButtonAccessory is null during report");
+        DM_LOGE(TAG, "ButtonAccessory is null during report");
     }
 
     return ESP_OK;
 }
 
+esp_err_t ButtonDevice::reportEvent(uint32_t event)
+{
+    DM_LOGD(TAG, "Reporting press event");
+    setEndpointSwitchPressEvent(static_cast<StatelessButtonAccessoryInterface::PressType>(event));
+    return ESP_OK;
+}
+
 esp_err_t ButtonDevice::identify()
 {
-    ESP_LOGI(TAG, "Identifying device");
+    DM_LOGI(TAG, "Identifying device");
     if (m_accessory != nullptr)
     {
         m_accessory->identify();
-        ESP_LOGD(TAG, "Identified accessory");
+        DM_LOGD(TAG, "Identified accessory");
     }
     else
     {
-        ESP_LOGE(TAG, "ButtonAccessory is null during identify");
+        DM_LOGE(TAG, "ButtonAccessory is null during identify");
     }
     return ESP_OK;
 }
@@ -130,40 +153,53 @@ void ButtonDevice::setEndpointSwitchPressEvent(StatelessButtonAccessoryInterface
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
-    uint16_t endpointId           = esp_matter::endpoint::get_id(m_endpoint);
-    esp_matter_attr_val_t attrVal = esp_matter_uint8(0);
-
-    esp_matter::attribute::report(endpointId, chip::app::Clusters::Switch::Id,
-                                  chip::app::Clusters::Switch::Attributes::CurrentPosition::Id, &attrVal);
+    uint16_t endpointId = esp_matter::endpoint::get_id(m_endpoint);
 
-    if (esp_matter::lock::chip_stack_lock(portMAX_DELAY) != esp_matter::lock::status::FAILED)
+    // The report task may already hold the lock for its whole batch, only release it if taken here
+    esp_matter::lock::status_t lockStatus = StackLockProfiler::lock(StackLockProfiler::BUTTON_EVENT);
+    if (lockStatus != esp_matter::lock::status::ALREADY_TAKEN)
+    {
+        getStats().recordLock(lockStatus == esp_matter::lock::status::SUCCESS);
+    }
+    if (lockStatus != esp_matter::lock::status::FAILED)
     {
+        // Momentary switch, back at rest once pressed; the batch commits under the lock taken above
+        if (m_currentPositionAttribute != nullptr)
+        {
+            AttributeBatch batch(&getStats());
+            batch.stage(endpointId, chip::app::Clusters::Switch::Id, m_currentPositionAttribute, esp_matter_uint8(0));
+            batch.commit();
+        }
+
         switch (pressType)
         {
         case StatelessButtonAccessoryInterface::PressType::SinglePress:
-            ESP_LOGW(TAG, "SinglePress");
+            DM_LOGD(TAG, "SinglePress");
             esp_matter::cluster::switch_cluster::event::send_multi_press_complete(endpointId, 0, 1);
+            getStats().recordReports(1, 0);
             break;
         case StatelessButtonAccessoryInterface::PressType::LongPress:
-            ESP_LOGW(TAG, "LongPress");
+            DM_LOGD(TAG, "LongPress");
             esp_matter::cluster::switch_cluster::event::send_long_press(endpointId, 0);
+            getStats().recordReports(1, 0);
             break;
         case StatelessButtonAccessoryInterface::PressType::DoublePress:
-            ESP_LOGW(TAG, "DoublePress");
+            DM_LOGD(TAG, "DoublePress");
             esp_matter::cluster::switch_cluster::event::send_multi_press_complete(endpointId, 0, 2);
+            getStats().recordReports(1, 0);
             break;
         default:
-            ESP_LOGE(TAG, "Unknown PressType");
+            DM_LOGE(TAG, "Unknown PressType");
             break;
         }
-        esp_matter::lock::chip_stack_unlock();
+        StackLockProfiler::unlock(StackLockProfiler::BUTTON_EVENT, lockStatus);
     }
     else
     {
-        ESP_LOGE(TAG, "Failed to lock chip stack");
+        DM_LOGE(TAG, "Failed to lock chip stack");
     }
 }
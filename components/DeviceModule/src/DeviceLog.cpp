@@ -0,0 +1,124 @@
+#include "DeviceLog.hpp"
+#include <atomic>
+#include <cstdio>
+#include <esp_timer.h>
+
+#if CONFIG_D_M_LOG_TOKENIZED
+
+/* One ring entry, sequence is the write index + 1 once the record is complete and 0 while it is written */
+struct Slot
+{
+    std::atomic<uint32_t> sequence;
+    DeviceLog::Record record;
+};
+
+static Slot s_ring[CONFIG_D_M_LOG_RING_RECORDS];
+static std::atomic<uint32_t> s_next{ 0 };
+
+void DeviceLog::writeRecord(uint32_t token, uint8_t level, const uint32_t * args, uint8_t argCount)
+{
+    uint32_t index = s_next.fetch_add(1, std::memory_order_relaxed);
+    Slot & slot    = s_ring[index % CONFIG_D_M_LOG_RING_RECORDS];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record.token       = token;
+    slot.record.timestampUs = static_cast<uint32_t>(esp_timer_get_time());
+    slot.record.level       = level;
+    slot.record.argCount    = argCount;
+    for (uint8_t i = 0; i < MAX_ARGS; i++)
+    {
+        slot.record.args[i] = args[i];
+    }
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+/* Copies the record of a write index, false if it was overwritten or is still being written */
+static bool readRecord(uint32_t index, DeviceLog::Record & record)
+{
+    const Slot & slot = s_ring[index % CONFIG_D_M_LOG_RING_RECORDS];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+    {
+        return false;
+    }
+    record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+/* Write index of the oldest record the ring still holds */
+static uint32_t oldestIndex(uint32_t next)
+{
+    return next > CONFIG_D_M_LOG_RING_RECORDS ? next - CONFIG_D_M_LOG_RING_RECORDS : 0;
+}
+
+size_t DeviceLog::snapshot(Record * records, size_t capacity)
+{
+    uint32_t next = s_next.load(std::memory_order_acquire);
+    size_t count  = 0;
+    for (uint32_t index = oldestIndex(next); index != next && count < capacity; index++)
+    {
+        if (readRecord(index, records[count]))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void DeviceLog::print()
+{
+    uint32_t next  = s_next.load(std::memory_order_acquire);
+    unsigned count = 0;
+    for (uint32_t index = oldestIndex(next); index != next; index++)
+    {
+        Record record;
+        if (!readRecord(index, record))
+        {
+            continue;
+        }
+
+        printf("DMLOG %u %u %08x", (unsigned) record.timestampUs, record.level, (unsigned) record.token);
+        for (uint8_t arg = 0; arg < record.argCount; arg++)
+        {
+            printf(" %08x", (unsigned) record.args[arg]);
+        }
+        printf("\n");
+        count++;
+    }
+    printf("%u tokenized messages, decode with tools/decode_device_log.py\n", count);
+}
+
+void DeviceLog::clear()
+{
+    for (Slot & slot : s_ring)
+    {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+#else
+
+void DeviceLog::writeRecord(uint32_t token, uint8_t level, const uint32_t * args, uint8_t argCount)
+{
+    (void) token;
+    (void) level;
+    (void) args;
+    (void) argCount;
+}
+
+size_t DeviceLog::snapshot(Record * records, size_t capacity)
+{
+    (void) records;
+    (void) capacity;
+    return 0;
+}
+
+void DeviceLog::print()
+{
+    printf("Tokenized logging is disabled, enable CONFIG_D_M_LOG_TOKENIZED\n");
+}
+
+void DeviceLog::clear() {}
+
+#endif
@@ -0,0 +1,462 @@
+#include "DeviceRegistry.hpp"
+#include "BootProfiler.hpp"
+#include "DeviceLog.hpp"
+#include "DeviceSnapshot.hpp"
+#include "EndpointIdMap.hpp"
+#include "StackLockProfiler.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <cstdio>
+
+static const char * TAG = "DeviceRegistry";
+
+static const char * typeName(DeviceType type)
+{
+    static const char * const TYPE_NAMES[] = {
+        "Button", "DoorLock", "Fan", "Light", "MultiPlugin", "Plugin", "TVLifter", "Window",
+    };
+    return TYPE_NAMES[static_cast<uint8_t>(type)];
+}
+
+template <typename T, size_t Capacity>
+static DevicePoolUsage usageOf(const ObjectPool<T, Capacity> & pool)
+{
+    return { pool.used(), pool.peak(), pool.capacity(), sizeof(T) };
+}
+
+DeviceRegistry::DeviceRegistry(esp_matter::endpoint_t * endpointAggregator) :
+    m_endpointAggregator(endpointAggregator), m_entries(), m_count(0), m_reportDispatcher(nullptr), m_actuationExecutor(nullptr)
+{}
+
+DeviceRegistry::~DeviceRegistry()
+{
+    DM_LOGI(TAG, "Destroying DeviceRegistry");
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack, destroying devices without it");
+    }
+
+    for (size_t i = 0; i < m_count; i++)
+    {
+        destroyDevice(m_entries[i].type, m_entries[i].device);
+    }
+    m_count = 0;
+    unlockStack(lockStatus);
+}
+
+esp_err_t DeviceRegistry::createDevices(const DeviceDescriptor * descriptors, size_t count)
+{
+    if (descriptors == nullptr && count > 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return ESP_FAIL;
+    }
+
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < count; i++)
+    {
+        const DeviceDescriptor & descriptor = descriptors[i];
+
+        size_t index = lowerBound(descriptor.id);
+        if (index < m_count && m_entries[index].id == descriptor.id)
+        {
+            DM_LOGE(TAG, "Duplicate device id %u", descriptor.id);
+            result = ESP_ERR_INVALID_ARG;
+            continue;
+        }
+
+        EndpointIdMap::beginDevice(descriptor.id, static_cast<uint8_t>(descriptor.type));
+        BaseDeviceInterface * device = createDevice(descriptor);
+        EndpointIdMap::endDevice();
+        if (device == nullptr)
+        {
+            result = ESP_ERR_NO_MEM;
+            continue;
+        }
+        device->applyPersistencePolicy(descriptor.persistence);
+        if (m_reportDispatcher != nullptr && m_reportDispatcher->attach(device) != ESP_OK)
+        {
+            result = ESP_ERR_NO_MEM;
+        }
+
+        for (size_t j = m_count; j > index; j--)
+        {
+            m_entries[j] = m_entries[j - 1];
+        }
+        m_entries[index] = { descriptor.id, descriptor.type, device };
+        m_count++;
+
+        // Ignored once app_main marked DEVICES_CREATED, devices added to a running bridge are not part of the boot
+        BootProfiler::mark(BootProfiler::DEVICE_CREATED, descriptor.id);
+    }
+
+    // One blob write for the table, only if a device got a new endpoint id
+    EndpointIdMap::save();
+    unlockStack(lockStatus);
+
+    DM_LOGI(TAG, "Created %u devices", (unsigned) m_count);
+    return result;
+}
+
+esp_err_t DeviceRegistry::addDevice(const DeviceDescriptor & descriptor)
+{
+    return createDevices(&descriptor, 1);
+}
+
+esp_err_t DeviceRegistry::removeDevice(uint16_t id)
+{
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return ESP_FAIL;
+    }
+
+    // saveSnapshot and the shell dumps walk the entries under the lock, so the entry goes with the device
+    size_t index = lowerBound(id);
+    if (index == m_count || m_entries[index].id != id)
+    {
+        unlockStack(lockStatus);
+        DM_LOGE(TAG, "No device with id %u", id);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    destroyDevice(m_entries[index].type, m_entries[index].device);
+    for (size_t i = index + 1; i < m_count; i++)
+    {
+        m_entries[i - 1] = m_entries[i];
+    }
+    m_count--;
+
+    unlockStack(lockStatus);
+    return ESP_OK;
+}
+
+esp_err_t DeviceRegistry::setReportDispatcher(ReportDispatcher * dispatcher)
+{
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return ESP_FAIL;
+    }
+
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        if (m_reportDispatcher != nullptr)
+        {
+            m_reportDispatcher->detach(m_entries[i].device);
+        }
+        if (dispatcher != nullptr && dispatcher->attach(m_entries[i].device) != ESP_OK)
+        {
+            result = ESP_ERR_NO_MEM;
+        }
+    }
+    m_reportDispatcher = dispatcher;
+
+    unlockStack(lockStatus);
+    return result;
+}
+
+void DeviceRegistry::setActuationExecutor(ActuationExecutor * executor)
+{
+    esp_matter::lock::status_t lockStatus = lockStack();
+    m_actuationExecutor                   = executor;
+    unlockStack(lockStatus);
+}
+
+BaseDeviceInterface * DeviceRegistry::find(uint16_t id) const
+{
+    size_t index = lowerBound(id);
+    if (index == m_count || m_entries[index].id != id)
+    {
+        return nullptr;
+    }
+    return m_entries[index].device;
+}
+
+BaseDeviceInterface * DeviceRegistry::createDevice(const DeviceDescriptor & descriptor)
+{
+    char * name                  = const_cast<char *>(descriptor.name);
+    BaseDeviceInterface * device = nullptr;
+    switch (descriptor.type)
+    {
+    case DeviceType::BUTTON:
+        device = m_buttons.create(name, static_cast<StatelessButtonAccessoryInterface *>(descriptor.accessory),
+                                  m_endpointAggregator);
+        break;
+    case DeviceType::DOOR_LOCK:
+        device = m_doorLocks.create(name, static_cast<DoorLockAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    case DeviceType::FAN:
+        device = m_fans.create(descriptor.name, static_cast<FanAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    case DeviceType::LIGHT:
+        device = m_lights.create(name, static_cast<LightAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    case DeviceType::MULTI_PLUGIN: {
+        PluginAccessoryInterface * accessories[CONFIG_D_M_MAX_CHANNELS_PER_DEVICE] = {};
+        uint8_t channelCount = descriptor.channelCount < CONFIG_D_M_MAX_CHANNELS_PER_DEVICE ? descriptor.channelCount
+                                                                                             : CONFIG_D_M_MAX_CHANNELS_PER_DEVICE;
+        if (descriptor.channelAccessories != nullptr)
+        {
+            for (uint8_t channel = 0; channel < channelCount; channel++)
+            {
+                accessories[channel] = static_cast<PluginAccessoryInterface *>(descriptor.channelAccessories[channel]);
+            }
+        }
+        device = m_multiPlugins.create(descriptor.name, accessories, channelCount, m_endpointAggregator);
+        break;
+    }
+    case DeviceType::PLUGIN:
+        device = m_plugins.create(name, static_cast<PluginAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    case DeviceType::TV_LIFTER:
+        device = m_tvLifters.create(name, static_cast<TVLifterAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    case DeviceType::WINDOW:
+        device =
+            m_windows.create(descriptor.name, static_cast<BlindAccessoryInterface *>(descriptor.accessory), m_endpointAggregator);
+        break;
+    default:
+        DM_LOGE(TAG, "Unknown device type %d of device %u", static_cast<int>(descriptor.type), descriptor.id);
+        return nullptr;
+    }
+
+    if (device == nullptr)
+    {
+        DM_LOGE(TAG, "Device pool of type %d is full, device %u not created", static_cast<int>(descriptor.type), descriptor.id);
+    }
+    return device;
+}
+
+void DeviceRegistry::destroyDevice(DeviceType type, BaseDeviceInterface * device)
+{
+    // Callers hold the stack lock, so no write of the device can be submitted after this
+    if (m_actuationExecutor != nullptr)
+    {
+        m_actuationExecutor->cancel(device);
+    }
+
+    switch (type)
+    {
+    case DeviceType::BUTTON:
+        m_buttons.destroy(static_cast<ButtonDevice *>(device));
+        break;
+    case DeviceType::DOOR_LOCK:
+        m_doorLocks.destroy(static_cast<DoorLockDevice *>(device));
+        break;
+    case DeviceType::FAN:
+        m_fans.destroy(static_cast<FanDevice *>(device));
+        break;
+    case DeviceType::LIGHT:
+        m_lights.destroy(static_cast<LightDevice *>(device));
+        break;
+    case DeviceType::MULTI_PLUGIN:
+        m_multiPlugins.destroy(static_cast<MultiPluginDevice *>(device));
+        break;
+    case DeviceType::PLUGIN:
+        m_plugins.destroy(static_cast<PluginDevice *>(device));
+        break;
+    case DeviceType::TV_LIFTER:
+        m_tvLifters.destroy(static_cast<TVLifterDevice *>(device));
+        break;
+    case DeviceType::WINDOW:
+        m_windows.destroy(static_cast<WindowDevice *>(device));
+        break;
+    }
+}
+
+DevicePoolUsage DeviceRegistry::poolUsage(DeviceType type) const
+{
+    switch (type)
+    {
+    case DeviceType::BUTTON:
+        return usageOf(m_buttons);
+    case DeviceType::DOOR_LOCK:
+        return usageOf(m_doorLocks);
+    case DeviceType::FAN:
+        return usageOf(m_fans);
+    case DeviceType::LIGHT:
+        return usageOf(m_lights);
+    case DeviceType::MULTI_PLUGIN:
+        return usageOf(m_multiPlugins);
+    case DeviceType::PLUGIN:
+        return usageOf(m_plugins);
+    case DeviceType::TV_LIFTER:
+        return usageOf(m_tvLifters);
+    case DeviceType::WINDOW:
+        return usageOf(m_windows);
+    }
+    return { 0, 0, 0, 0 };
+}
+
+void DeviceRegistry::logPoolUsage() const
+{
+    size_t totalBytes = 0;
+    for (uint8_t type = 0; type <= static_cast<uint8_t>(DeviceType::WINDOW); type++)
+    {
+        DevicePoolUsage usage = poolUsage(static_cast<DeviceType>(type));
+        totalBytes += usage.capacity * usage.slotSize;
+        // Explicitly requested report with a name argument, printed as text even with tokenized logs
+        ESP_LOGI(TAG, "%-12s %u/%u slots used, peak %u, %u bytes per slot", typeName(static_cast<DeviceType>(type)),
+                 (unsigned) usage.used, (unsigned) usage.capacity, (unsigned) usage.peak, (unsigned) usage.slotSize);
+    }
+    ESP_LOGI(TAG, "Device pools reserve %u bytes", (unsigned) totalBytes);
+}
+
+void DeviceRegistry::printStats() const
+{
+    // Devices are added and removed under the stack lock
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        printf("Failed to lock chip stack\n");
+        return;
+    }
+
+    printf("%5s %-12s %8s %8s %8s %10s %8s %10s %12s %10s %10s\n", "id", "type", "updates", "filtered", "reports",
+           "suppressed", "locks", "lockfails", "accessoryUs", "maxUs", "overflows");
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const DeviceStats & stats = m_entries[i].device->getStats();
+        printf("%5u %-12s %8u %8u %8u %10u %8u %10u %12u %10u %10u\n", m_entries[i].id, typeName(m_entries[i].type),
+               (unsigned) stats.updatesReceived.load(), (unsigned) stats.updatesFiltered.load(),
+               (unsigned) stats.reportsSent.load(), (unsigned) stats.reportsSuppressed.load(),
+               (unsigned) stats.lockAcquisitions.load(), (unsigned) stats.lockFailures.load(),
+               (unsigned) stats.accessoryTimeUs.load(), (unsigned) stats.accessoryTimeMaxUs.load(),
+               (unsigned) stats.actuationOverflows.load());
+    }
+    unlockStack(lockStatus);
+}
+
+void DeviceRegistry::printLatency() const
+{
+#if CONFIG_D_M_LATENCY_TRACING
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        printf("Failed to lock chip stack\n");
+        return;
+    }
+
+    printf("%5s %-12s %8s %8s %8s %8s %8s %8s %8s %8s\n", "id", "type", "commands", "p50Us", "p99Us", "maxUs", "reports",
+           "p50Us", "p99Us", "maxUs");
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const DeviceStats & stats = m_entries[i].device->getStats();
+        printf("%5u %-12s %8u %8u %8u %8u %8u %8u %8u %8u\n", m_entries[i].id, typeName(m_entries[i].type),
+               (unsigned) stats.commandLatency.count(), (unsigned) stats.commandLatency.percentileUs(500),
+               (unsigned) stats.commandLatency.percentileUs(990), (unsigned) stats.commandLatency.maxUs(),
+               (unsigned) stats.reportLatency.count(), (unsigned) stats.reportLatency.percentileUs(500),
+               (unsigned) stats.reportLatency.percentileUs(990), (unsigned) stats.reportLatency.maxUs());
+    }
+    unlockStack(lockStatus);
+#else
+    printf("Latency tracing is disabled, enable CONFIG_D_M_LATENCY_TRACING\n");
+#endif
+}
+
+void DeviceRegistry::printPersistence() const
+{
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        printf("Failed to lock chip stack\n");
+        return;
+    }
+
+    printf("%5s %-12s %-10s %10s %10s\n", "id", "type", "policy", "nvsWrites", "deferred");
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const BaseDeviceInterface * device = m_entries[i].device;
+        const DeviceStats & stats          = device->getStats();
+        printf("%5u %-12s %-10s %10u %10u\n", m_entries[i].id, typeName(m_entries[i].type),
+               device->getPersistencePolicy() == PersistencePolicy::DEFERRED ? "deferred" : "immediate",
+               (unsigned) stats.nvsWrites.load(), (unsigned) stats.nvsDeferred.load());
+    }
+    unlockStack(lockStatus);
+}
+
+void DeviceRegistry::resetStats()
+{
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return;
+    }
+
+    for (size_t i = 0; i < m_count; i++)
+    {
+        m_entries[i].device->getStats().reset();
+    }
+    unlockStack(lockStatus);
+}
+
+esp_err_t DeviceRegistry::saveSnapshot() const
+{
+#if CONFIG_D_M_BOOT_SNAPSHOT
+    DeviceSnapshot::Record records[CAPACITY];
+
+    esp_matter::lock::status_t lockStatus = lockStack();
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return ESP_FAIL;
+    }
+
+    size_t count = m_count;
+    for (size_t i = 0; i < count; i++)
+    {
+        records[i] = { m_entries[i].id, static_cast<uint8_t>(m_entries[i].type), 0, m_entries[i].device->captureState() };
+    }
+    unlockStack(lockStatus);
+
+    return DeviceSnapshot::save(records, count);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_matter::lock::status_t DeviceRegistry::lockStack()
+{
+    // Before esp_matter::start the stack lock does not exist yet and nothing else touches the data model
+    if (!esp_matter::is_started())
+    {
+        return esp_matter::lock::status::ALREADY_TAKEN;
+    }
+    return StackLockProfiler::lock(StackLockProfiler::DEVICE_REGISTRY);
+}
+
+void DeviceRegistry::unlockStack(esp_matter::lock::status_t lockStatus)
+{
+    StackLockProfiler::unlock(StackLockProfiler::DEVICE_REGISTRY, lockStatus);
+}
+
+size_t DeviceRegistry::lowerBound(uint16_t id) const
+{
+    size_t low  = 0;
+    size_t high = m_count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (m_entries[middle].id < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,121 @@
+#include "DeviceShell.hpp"
+#include "BootProfiler.hpp"
+#include "DeviceLog.hpp"
+#include "StackLockProfiler.hpp"
+#include <cstdio>
+#include <esp_err.h>
+#include <sdkconfig.h>
+
+#if CONFIG_ENABLE_CHIP_SHELL
+#include <esp_matter_console.h>
+
+static const char * TAG = "DeviceShell";
+
+static DeviceRegistry * s_registry = nullptr;
+static esp_matter::console::engine s_deviceConsole;
+
+static esp_err_t printStatsHandler(int, char **)
+{
+    s_registry->printStats();
+    return ESP_OK;
+}
+
+static esp_err_t printLatencyHandler(int, char **)
+{
+    s_registry->printLatency();
+    return ESP_OK;
+}
+
+static esp_err_t printPersistenceHandler(int, char **)
+{
+    s_registry->printPersistence();
+    return ESP_OK;
+}
+
+static esp_err_t printLogHandler(int, char **)
+{
+    DeviceLog::print();
+    return ESP_OK;
+}
+
+static esp_err_t printBootHandler(int, char **)
+{
+    BootProfiler::print();
+    return ESP_OK;
+}
+
+static esp_err_t lockStatsHandler(int, char **)
+{
+    StackLockProfiler::print();
+    return ESP_OK;
+}
+
+static esp_err_t resetStatsHandler(int, char **)
+{
+    s_registry->resetStats();
+    StackLockProfiler::reset();
+    printf("Device stats, latencies and lock times cleared\n");
+    return ESP_OK;
+}
+
+static esp_err_t printDescription(const esp_matter::console::command_t * command, void *)
+{
+    printf("\t%s: %s\n", command->name, command->description);
+    return ESP_OK;
+}
+
+static esp_err_t dispatch(int argc, char ** argv)
+{
+    if (argc <= 0)
+    {
+        s_deviceConsole.for_each_command(printDescription, nullptr);
+        return ESP_OK;
+    }
+    return s_deviceConsole.exec_command(argc, argv);
+}
+
+esp_err_t DeviceShell::registerCommands(DeviceRegistry * registry)
+{
+    if (registry == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_registry != nullptr)
+    {
+        DM_LOGW(TAG, "Device commands already registered");
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_registry = registry;
+
+    static const esp_matter::console::command_t deviceCommands[] = {
+        { "stats", "Print the performance counters of every device. Usage: matter device stats", printStatsHandler },
+        { "latency", "Print command and report latency percentiles of every device. Usage: matter device latency",
+          printLatencyHandler },
+        { "persistence", "Print the persistence policy and NVS writes of every device. Usage: matter device persistence",
+          printPersistenceHandler },
+        { "log", "Print the tokenized log ring for tools/decode_device_log.py. Usage: matter device log", printLogHandler },
+        { "lock-stats", "Print chip stack lock wait and hold times per lock site. Usage: matter device lock-stats",
+          lockStatsHandler },
+        { "boot", "Print the boot phase profile of this and the previous boot. Usage: matter device boot", printBootHandler },
+        { "reset-stats", "Clear the device counters, latencies and lock times. Usage: matter device reset-stats",
+          resetStatsHandler },
+    };
+    s_deviceConsole.register_commands(deviceCommands, sizeof(deviceCommands) / sizeof(deviceCommands[0]));
+
+    static const esp_matter::console::command_t command = {
+        "device",
+        "Bridged device diagnostics. Usage: matter device <stats|latency|persistence|log|lock-stats|boot|reset-stats>",
+        dispatch,
+    };
+    return esp_matter::console::add_commands(&command, 1);
+}
+
+#else
+
+esp_err_t DeviceShell::registerCommands(DeviceRegistry * registry)
+{
+    (void) registry;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
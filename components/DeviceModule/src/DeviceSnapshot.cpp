@@ -0,0 +1,289 @@
+#include "DeviceSnapshot.hpp"
+#include "DeviceLog.hpp"
+#include <cstddef>
+#include <cstring>
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <sdkconfig.h>
+
+#if CONFIG_D_M_BOOT_SNAPSHOT
+#include <nvs.h>
+
+static const char * TAG = "DeviceSnapshot";
+
+static const char * NVS_NAMESPACE = "dm_snapshot";
+static const char * NVS_KEY       = "devices";
+
+/* Version in the low byte, bump it when the record layout or a state encoding changes */
+static constexpr uint16_t SNAPSHOT_MAGIC = 0xD501;
+
+/**
+ * @brief Stored blob, the header followed by count records.
+ */
+struct Blob
+{
+    uint16_t magic;                                           /**< SNAPSHOT_MAGIC. */
+    uint16_t count;                                           /**< Number of records. */
+    DeviceSnapshot::Record records[DeviceRegistry::CAPACITY]; /**< Records sorted by id. */
+};
+
+static Blob s_stored          = {};    /* Last blob stored or restored, save() skips equal ones */
+static bool s_storedValid     = false; /* s_stored matches NVS */
+static int64_t s_restoredAtUs = 0;
+static size_t s_restoredCount = 0;
+static uint32_t s_writeCount  = 0;
+
+static size_t blobSize(size_t count)
+{
+    return offsetof(Blob, records) + count * sizeof(DeviceSnapshot::Record);
+}
+
+static const DeviceSnapshot::Record * findRecord(const Blob & blob, uint16_t id)
+{
+    size_t low  = 0;
+    size_t high = blob.count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (blob.records[middle].id < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low < blob.count && blob.records[low].id == id ? &blob.records[low] : nullptr;
+}
+
+/* Applies the state of a record to the accessories of its descriptor, returns false if it has none */
+static bool applyState(const DeviceDescriptor & descriptor, uint32_t state)
+{
+    switch (descriptor.type)
+    {
+    case DeviceType::DOOR_LOCK:
+        if (descriptor.accessory == nullptr)
+        {
+            return false;
+        }
+        static_cast<DoorLockAccessoryInterface *>(descriptor.accessory)
+            ->setState((state & 1) ? DoorLockAccessoryInterface::DoorLockState::LOCKED
+                                   : DoorLockAccessoryInterface::DoorLockState::UNLOCKED);
+        return true;
+    case DeviceType::FAN:
+        if (descriptor.accessory == nullptr)
+        {
+            return false;
+        }
+        static_cast<FanAccessoryInterface *>(descriptor.accessory)->setPower(state & 1);
+        return true;
+    case DeviceType::LIGHT:
+        if (descriptor.accessory == nullptr)
+        {
+            return false;
+        }
+        static_cast<LightAccessoryInterface *>(descriptor.accessory)->setPowerState(state & 1);
+        return true;
+    case DeviceType::MULTI_PLUGIN: {
+        if (descriptor.channelAccessories == nullptr)
+        {
+            return false;
+        }
+        uint8_t channelCount = descriptor.channelCount < CONFIG_D_M_MAX_CHANNELS_PER_DEVICE ? descriptor.channelCount
+                                                                                             : CONFIG_D_M_MAX_CHANNELS_PER_DEVICE;
+        for (uint8_t channel = 0; channel < channelCount; channel++)
+        {
+            if (descriptor.channelAccessories[channel] != nullptr)
+            {
+                static_cast<PluginAccessoryInterface *>(descriptor.channelAccessories[channel])->setPower((state >> channel) & 1);
+            }
+        }
+        return true;
+    }
+    case DeviceType::PLUGIN:
+        if (descriptor.accessory == nullptr)
+        {
+            return false;
+        }
+        static_cast<PluginAccessoryInterface *>(descriptor.accessory)->setPower(state & 1);
+        return true;
+    case DeviceType::WINDOW:
+        if (descriptor.accessory == nullptr)
+        {
+            return false;
+        }
+        static_cast<BlindAccessoryInterface *>(descriptor.accessory)->setDefaultPosition(static_cast<uint8_t>(state));
+        return true;
+    default:
+        return false;
+    }
+}
+
+esp_err_t DeviceSnapshot::restore(const DeviceDescriptor * descriptors, size_t count)
+{
+    if (descriptors == nullptr && count > 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        DM_LOGI(TAG, "No snapshot stored");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    size_t size = sizeof(s_stored);
+    err         = nvs_get_blob(handle, NVS_KEY, &s_stored, &size);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        DM_LOGI(TAG, "No snapshot stored");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err != ESP_OK || size < offsetof(Blob, records) || s_stored.magic != SNAPSHOT_MAGIC ||
+        s_stored.count > DeviceRegistry::CAPACITY || size != blobSize(s_stored.count))
+    {
+        DM_LOGW(TAG, "Ignoring invalid snapshot of %u bytes", (unsigned) size);
+        s_storedValid = false;
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_storedValid = true;
+
+    size_t restored = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Record * record = findRecord(s_stored, descriptors[i].id);
+        if (record != nullptr && record->type == static_cast<uint8_t>(descriptors[i].type) &&
+            applyState(descriptors[i], record->state))
+        {
+            restored++;
+        }
+    }
+
+    s_restoredCount = restored;
+    s_restoredAtUs  = esp_timer_get_time();
+    DM_LOGI(TAG, "Restored %u accessories %u us after boot", (unsigned) restored, (unsigned) s_restoredAtUs);
+    return ESP_OK;
+}
+
+esp_err_t DeviceSnapshot::save(const Record * records, size_t count)
+{
+    if ((records == nullptr && count > 0) || count > DeviceRegistry::CAPACITY)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_storedValid && s_stored.count == count && memcmp(s_stored.records, records, count * sizeof(Record)) == 0)
+    {
+        return ESP_OK;
+    }
+
+    s_stored.magic = SNAPSHOT_MAGIC;
+    s_stored.count = static_cast<uint16_t>(count);
+    memcpy(s_stored.records, records, count * sizeof(Record));
+    s_storedValid = false;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(handle, NVS_KEY, &s_stored, blobSize(count));
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to store snapshot: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    s_storedValid = true;
+    s_writeCount++;
+    return ESP_OK;
+}
+
+esp_err_t DeviceSnapshot::erase()
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    err = nvs_erase_key(handle, NVS_KEY);
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    s_storedValid = false;
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+}
+
+int64_t DeviceSnapshot::restoredAtUs()
+{
+    return s_restoredAtUs;
+}
+
+size_t DeviceSnapshot::restoredCount()
+{
+    return s_restoredCount;
+}
+
+uint32_t DeviceSnapshot::writeCount()
+{
+    return s_writeCount;
+}
+
+#else
+
+esp_err_t DeviceSnapshot::restore(const DeviceDescriptor * descriptors, size_t count)
+{
+    (void) descriptors;
+    (void) count;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t DeviceSnapshot::save(const Record * records, size_t count)
+{
+    (void) records;
+    (void) count;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t DeviceSnapshot::erase()
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+int64_t DeviceSnapshot::restoredAtUs()
+{
+    return 0;
+}
+
+size_t DeviceSnapshot::restoredCount()
+{
+    return 0;
+}
+
+uint32_t DeviceSnapshot::writeCount()
+{
+    return 0;
+}
+
+#endif
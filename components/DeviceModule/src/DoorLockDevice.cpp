@@ -27,22 +27,25 @@ bool emberAfPluginDoorLockOnDoorUnlockCommand(chip::EndpointId endpointId,
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "DoorLockDevice.hpp"
+#include "AttributeBatch.hpp"
+#include "AttributeDispatchTable.hpp"
+#include "DeviceLog.hpp"
 
 static const char * TAG = "DoorLockDevice";
 
 DoorLockDevice::DoorLockDevice(char * name, DoorLockAccessoryInterface * accessory, esp_matter::endpoint_t * endpointAggregator) :
-    m_endpoint(nullptr), m_accessory(accessory)
+    m_endpoint(nullptr), m_lockStateAttribute(nullptr), m_accessory(accessory)
 {
-    ESP_LOGI(TAG, "Creating DoorLockDevice");
+    DM_LOGI(TAG, "Creating DoorLockDevice");
 
     if (m_accessory != nullptr)
     {
         m_accessory->setReportCallback(
-            [](void * self, bool onlySave) { static_cast<DoorLockDevice *>(self)->reportEndpoint(onlySave); }, this);
+            [](void * self, bool onlySave) { static_cast<DoorLockDevice *>(self)->requestReport(onlySave); }, this);
     }
     else
     {
-        ESP_LOGW(TAG, "DoorLockAccessory is null");
+        DM_LOGW(TAG, "DoorLockAccessory is null");
     }
 
     if (endpointAggregator != nullptr)
@@ -50,20 +53,21 @@ DoorLockDevice::DoorLockDevice(char * name, DoorLockAccessoryInterface * accesso
         m_endpoint = initializeBridgedNode(name, endpointAggregator, this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize bridged node");
+            DM_LOGE(TAG, "Failed to initialize bridged node");
         }
     }
     else
     {
-        ESP_LOGW(TAG, "Aggregator is null, creating standalone endpoint");
+        DM_LOGW(TAG, "Aggregator is null, creating standalone endpoint");
         m_endpoint = initializeStandaloneNode(this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize standalone node");
+            DM_LOGE(TAG, "Failed to initialize standalone node");
         }
     }
 
     setupDoorLock();
+    enableEndpoint(m_endpoint);
 
     // Set initial values (closed)
     updateEndpointLockState(true);
@@ -77,9 +81,12 @@ DoorLockDevice::DoorLockDevice(char * name, DoorLockAccessoryInterface * accesso
 
 DoorLockDevice::~DoorLockDevice()
 {
-    ESP_LOGI(TAG, "Destroying DoorLockDevice");
-    // Clean up resources if needed
-    // Example: If m_endpoint or m_accessory needs explicit deallocation, do it here
+    DM_LOGI(TAG, "Destroying DoorLockDevice");
+    if (m_accessory != nullptr)
+    {
+        m_accessory->setReportCallback(nullptr, nullptr);
+    }
+    releaseEndpoint(m_endpoint);
 }
 
 void DoorLockDevice::setupDoorLock()
@@ -87,40 +94,45 @@ void DoorLockDevice::setupDoorLock()
     esp_matter::endpoint::door_lock::config_t doorLockConfig;
     if (esp_matter::endpoint::door_lock::add(m_endpoint, &doorLockConfig) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add door lock to endpoint");
+        DM_LOGE(TAG, "Failed to add door lock to endpoint");
+        return;
     }
+
+    m_lockStateAttribute = resolveAttribute(m_endpoint, chip::app::Clusters::DoorLock::Id,
+                                            chip::app::Clusters::DoorLock::Attributes::LockState::Id);
+}
+
+uint32_t DoorLockDevice::captureState() const
+{
+    return m_accessory != nullptr && m_accessory->getState() == DoorLockAccessoryInterface::DoorLockState::LOCKED ? 1 : 0;
+}
+
+void DoorLockDevice::deferStatePersistence()
+{
+    deferPersistence(m_lockStateAttribute);
 }
 
 bool DoorLockDevice::retrieveEndpointLockState()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
-        return false;
-    }
-
-    esp_matter::cluster_t * doorCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::DoorLock::Id);
-    if (doorCluster == nullptr)
-    {
-        ESP_LOGE(TAG, "Failed to get door lock cluster");
+        DM_LOGE(TAG, "Endpoint is null");
         return false;
     }
 
-    esp_matter::attribute_t * lockStateAttribute =
-        esp_matter::attribute::get(doorCluster, chip::app::Clusters::DoorLock::Attributes::LockState::Id);
-    if (lockStateAttribute == nullptr)
+    if (m_lockStateAttribute == nullptr)
     {
-        ESP_LOGE(TAG, "Failed to get lock state attribute");
+        DM_LOGE(TAG, "Failed to get lock state attribute");
         return false;
     }
 
     esp_matter_attr_val_t attrVal;
-    if (esp_matter::attribute::get_val(lockStateAttribute, &attrVal) != ESP_OK)
+    if (esp_matter::attribute::get_val(m_lockStateAttribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to read lock state attribute");
+        DM_LOGE(TAG, "Failed to read lock state attribute");
         return false;
     }
-    ESP_LOGD(TAG, "Lock state: %d", attrVal.val.u8);
+    DM_LOGD(TAG, "Lock state: %d", attrVal.val.u8);
 
     return (attrVal.val.u8 == (uint8_t) chip::app::Clusters::DoorLock::DlLockState::kLocked);
 }
@@ -129,42 +141,66 @@ void DoorLockDevice::updateEndpointLockState(bool lockState)
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
     esp_matter_attr_val_t attrVal =
-        esp_matter_nullable_uint8((uint8_t) ((lockState == true) ? chip::app::Clusters::DoorLock::DlLockState::kLocked
+        esp_matter_nullable_enum8((uint8_t) ((lockState == true) ? chip::app::Clusters::DoorLock::DlLockState::kLocked
                                                                  : chip::app::Clusters::DoorLock::DlLockState::kUnlocked));
 
-    if (esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::DoorLock::Id,
-                                      chip::app::Clusters::DoorLock::Attributes::LockState::Id, &attrVal) != ESP_OK)
+    AttributeBatch batch(&getStats());
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::DoorLock::Id, m_lockStateAttribute, attrVal);
+    if (batch.commit() != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to set lock state to %d", lockState);
+        DM_LOGE(TAG, "Failed to set lock state to %d", lockState);
     }
     else
     {
-        ESP_LOGD(TAG, "Set lock state to %d", lockState);
+        DM_LOGD(TAG, "Set lock state to %d", lockState);
     }
 }
 
 esp_err_t DoorLockDevice::updateAccessory(uint32_t attributeId)
 {
-    ESP_LOGI(TAG, "Updating accessory state");
-
     if (attributeId != chip::app::Clusters::DoorLock::Attributes::LockState::Id)
     {
-        ESP_LOGW(TAG, "Unknown attribute ID: %d", (int) attributeId);
+        DM_LOGW(TAG, "Unknown attribute ID: %d", (int) attributeId);
         return ESP_OK;
     }
 
+    esp_matter_attr_val_t attrVal =
+        esp_matter_nullable_enum8((uint8_t) (retrieveEndpointLockState() ? chip::app::Clusters::DoorLock::DlLockState::kLocked
+                                                                         : chip::app::Clusters::DoorLock::DlLockState::kUnlocked));
+    return updateAccessory(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::DoorLock::Id, attributeId, &attrVal);
+}
+
+esp_err_t DoorLockDevice::updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId,
+                                          esp_matter_attr_val_t * val)
+{
+    static constexpr AttributeHandler<DoorLockDevice> handlers[] = {
+        { chip::app::Clusters::DoorLock::Id, chip::app::Clusters::DoorLock::Attributes::LockState::Id,
+          &DoorLockDevice::updateLockState },
+    };
+    static constexpr AttributeDispatchTable<DoorLockDevice, 1> table(handlers);
+    static_assert(table.isValid(), "Duplicate attribute handler");
+
+    return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+}
+
+esp_err_t DoorLockDevice::updateLockState(uint16_t endpointId, esp_matter_attr_val_t * val)
+{
+    DM_LOGD(TAG, "Updating accessory state");
+
     if (m_accessory == nullptr)
     {
-        ESP_LOGW(TAG, "DoorLockAccessory is null during update");
+        DM_LOGW(TAG, "DoorLockAccessory is null during update");
         return ESP_OK;
     }
 
-    DoorLockAccessoryInterface::DoorLockState state = retrieveEndpointLockState()
+    recordPersistence(m_lockStateAttribute);
+    DoorLockAccessoryInterface::DoorLockState state =
+        (val->val.u8 == (uint8_t) chip::app::Clusters::DoorLock::DlLockState::kLocked)
         ? DoorLockAccessoryInterface::DoorLockState::LOCKED
         : DoorLockAccessoryInterface::DoorLockState::UNLOCKED;
     m_accessory->setState(state);
@@ -174,11 +210,11 @@ esp_err_t DoorLockDevice::updateAccessory(uint32_t attributeId)
 
 esp_err_t DoorLockDevice::reportEndpoint(bool onlySave)
 {
-    ESP_LOGI(TAG, "Reporting endpoint state");
+    DM_LOGD(TAG, "Reporting endpoint state");
 
     if (m_accessory == nullptr)
     {
-        ESP_LOGW(TAG, "DoorLockAccessory is null during report");
+        DM_LOGW(TAG, "DoorLockAccessory is null during report");
         return ESP_OK;
     }
 
@@ -189,7 +225,7 @@ esp_err_t DoorLockDevice::reportEndpoint(bool onlySave)
 
 esp_err_t DoorLockDevice::identify()
 {
-    ESP_LOGI(TAG, "Identifying device");
+    DM_LOGI(TAG, "Identifying device");
 
     if (m_accessory != nullptr)
     {
@@ -197,7 +233,7 @@ esp_err_t DoorLockDevice::identify()
     }
     else
     {
-        ESP_LOGW(TAG, "DoorLockAccessory is null during identify");
+        DM_LOGW(TAG, "DoorLockAccessory is null during identify");
     }
 
     return ESP_OK;
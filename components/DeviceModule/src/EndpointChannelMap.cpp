@@ -0,0 +1,43 @@
+#include "EndpointChannelMap.hpp"
+#include "DeviceLog.hpp"
+
+static const char * TAG = "EndpointChannelMap";
+
+EndpointChannelMap::EndpointChannelMap()
+{
+    clear();
+}
+
+bool EndpointChannelMap::insert(uint16_t endpointId, uint8_t channel)
+{
+    if (channel >= CONFIG_D_M_MAX_CHANNELS_PER_DEVICE)
+    {
+        DM_LOGE(TAG, "Channel %d out of range", channel);
+        return false;
+    }
+
+    size_t slot = endpointId & (SLOT_COUNT - 1);
+    for (size_t probe = 0; probe < SLOT_COUNT; probe++)
+    {
+        Slot & entry = m_slots[slot];
+        if (entry.channel == NO_CHANNEL || entry.endpointId == endpointId)
+        {
+            entry.endpointId = endpointId;
+            entry.channel    = channel;
+            return true;
+        }
+        slot = (slot + 1) & (SLOT_COUNT - 1);
+    }
+
+    DM_LOGE(TAG, "Map is full, endpoint 0x%04x not mapped", endpointId);
+    return false;
+}
+
+void EndpointChannelMap::clear()
+{
+    for (Slot & entry : m_slots)
+    {
+        entry.endpointId = 0;
+        entry.channel    = NO_CHANNEL;
+    }
+}
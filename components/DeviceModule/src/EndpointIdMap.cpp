@@ -0,0 +1,252 @@
+#include "EndpointIdMap.hpp"
+#include "DeviceLog.hpp"
+#include <cstddef>
+#include <cstring>
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <nvs.h>
+#include <sdkconfig.h>
+
+static const char * TAG = "EndpointIdMap";
+
+static const char * NVS_NAMESPACE = "dm_endpoints";
+static const char * NVS_KEY       = "map";
+
+/* Version in the low byte, bump it when the entry layout changes */
+static constexpr uint16_t MAP_MAGIC = 0xE501;
+
+/**
+ * @brief Stored blob, the header followed by count entries.
+ */
+struct Blob
+{
+    uint16_t magic;                                                   /**< MAP_MAGIC. */
+    uint16_t count;                                                   /**< Number of entries. */
+    EndpointIdMap::Entry entries[CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES]; /**< Entries in the order they were added. */
+};
+
+static Blob s_map                                      = {};    /* Map in memory, stored by save() */
+static bool s_used[CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES] = {};    /* Entry used since load(), never evicted */
+static bool s_loaded                                   = false;
+static bool s_dirty                                    = false; /* s_map differs from NVS */
+static bool s_active                                   = false; /* Between beginDevice() and endDevice() */
+static uint16_t s_activeDeviceId                       = 0;
+static uint8_t s_activeType                            = 0;
+static uint8_t s_activeIndex                           = 0;     /* Endpoints created for the active device */
+static size_t s_resumedCount                           = 0;
+static size_t s_assignedCount                          = 0;
+static uint32_t s_writeCount                           = 0;
+
+static size_t blobSize(size_t count)
+{
+    return offsetof(Blob, entries) + count * sizeof(EndpointIdMap::Entry);
+}
+
+static EndpointIdMap::Entry * findEntry(uint16_t deviceId, uint8_t type, uint8_t index)
+{
+    for (size_t i = 0; i < s_map.count; i++)
+    {
+        EndpointIdMap::Entry & entry = s_map.entries[i];
+        if (entry.deviceId == deviceId && entry.type == type && entry.index == index)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/* Returns a free entry, or the first one not used since load() if the map is full */
+static EndpointIdMap::Entry * allocateEntry()
+{
+    if (s_map.count < CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES)
+    {
+        return &s_map.entries[s_map.count++];
+    }
+    for (size_t i = 0; i < s_map.count; i++)
+    {
+        if (!s_used[i])
+        {
+            DM_LOGW(TAG, "Map full, dropping endpoint %u of device %u", s_map.entries[i].endpointId, s_map.entries[i].deviceId);
+            return &s_map.entries[i];
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t EndpointIdMap::load()
+{
+    memset(&s_map, 0, sizeof(s_map));
+    memset(s_used, 0, sizeof(s_used));
+    s_loaded        = true;
+    s_dirty         = false;
+    s_resumedCount  = 0;
+    s_assignedCount = 0;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        DM_LOGI(TAG, "No endpoint id map stored");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    size_t size = sizeof(s_map);
+    err         = nvs_get_blob(handle, NVS_KEY, &s_map, &size);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND)
+    {
+        DM_LOGI(TAG, "No endpoint id map stored");
+        memset(&s_map, 0, sizeof(s_map));
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err != ESP_OK || size < offsetof(Blob, entries) || s_map.magic != MAP_MAGIC ||
+        s_map.count > CONFIG_D_M_ENDPOINT_ID_MAP_ENTRIES || size != blobSize(s_map.count))
+    {
+        DM_LOGW(TAG, "Ignoring invalid endpoint id map of %u bytes", (unsigned) size);
+        memset(&s_map, 0, sizeof(s_map));
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    DM_LOGI(TAG, "Loaded %u endpoint ids", s_map.count);
+    return ESP_OK;
+}
+
+void EndpointIdMap::beginDevice(uint16_t deviceId, uint8_t type)
+{
+    s_active         = true;
+    s_activeDeviceId = deviceId;
+    s_activeType     = type;
+    s_activeIndex    = 0;
+}
+
+void EndpointIdMap::endDevice()
+{
+    s_active = false;
+}
+
+esp_matter::endpoint_t * EndpointIdMap::createBridgedNode(esp_matter::node_t * node,
+                                                          esp_matter::endpoint::bridged_node::config_t * config, uint8_t flags,
+                                                          void * privData)
+{
+    // Before esp_matter::start the stored lowest unused id is not loaded and no id can be resumed
+    if (!s_active || !esp_matter::is_started())
+    {
+        return esp_matter::endpoint::bridged_node::create(node, config, flags, privData);
+    }
+    if (!s_loaded)
+    {
+        load();
+    }
+
+    uint8_t index                     = s_activeIndex++;
+    EndpointIdMap::Entry * entry      = findEntry(s_activeDeviceId, s_activeType, index);
+    esp_matter::endpoint_t * endpoint = nullptr;
+    if (entry != nullptr)
+    {
+        endpoint = esp_matter::endpoint::bridged_node::resume(node, config, flags, entry->endpointId, privData);
+        if (endpoint != nullptr)
+        {
+            s_used[entry - s_map.entries] = true;
+            s_resumedCount++;
+            return endpoint;
+        }
+        DM_LOGW(TAG, "Could not resume endpoint %u of device %u, assigning a new id", entry->endpointId, s_activeDeviceId);
+    }
+
+    endpoint = esp_matter::endpoint::bridged_node::create(node, config, flags, privData);
+    if (endpoint == nullptr)
+    {
+        return nullptr;
+    }
+    s_assignedCount++;
+
+    if (entry == nullptr)
+    {
+        entry = allocateEntry();
+        if (entry == nullptr)
+        {
+            DM_LOGW(TAG, "Map full, endpoint %u of device %u is not kept", esp_matter::endpoint::get_id(endpoint),
+                    s_activeDeviceId);
+            return endpoint;
+        }
+    }
+    *entry                        = { s_activeDeviceId, s_activeType, index, esp_matter::endpoint::get_id(endpoint), 0 };
+    s_used[entry - s_map.entries] = true;
+    s_dirty                       = true;
+    return endpoint;
+}
+
+esp_err_t EndpointIdMap::save()
+{
+    if (!s_dirty)
+    {
+        return ESP_OK;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    s_map.magic = MAP_MAGIC;
+    err         = nvs_set_blob(handle, NVS_KEY, &s_map, blobSize(s_map.count));
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to store endpoint id map: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    s_dirty = false;
+    s_writeCount++;
+    return ESP_OK;
+}
+
+esp_err_t EndpointIdMap::erase()
+{
+    memset(&s_map, 0, sizeof(s_map));
+    memset(s_used, 0, sizeof(s_used));
+    s_dirty = false;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    err = nvs_erase_key(handle, NVS_KEY);
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+}
+
+size_t EndpointIdMap::resumedCount()
+{
+    return s_resumedCount;
+}
+
+size_t EndpointIdMap::assignedCount()
+{
+    return s_assignedCount;
+}
+
+uint32_t EndpointIdMap::writeCount()
+{
+    return s_writeCount;
+}
@@ -1,24 +1,28 @@
 #include "FanDevice.hpp"
+#include "AttributeBatch.hpp"
+#include "AttributeDispatchTable.hpp"
+#include "DeviceLog.hpp"
 
 #include <esp_err.h>
-#include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_endpoint.h>
 
 static const char * TAG = "FanDevice";
 
 FanDevice::FanDevice(const char * name, FanAccessoryInterface * accessory, esp_matter::endpoint_t * endpointAggregator) :
-    m_endpoint(nullptr), m_accessory(accessory)
+    m_endpoint(nullptr), m_fanModeAttribute(nullptr), m_percentSettingAttribute(nullptr), m_percentCurrentAttribute(nullptr),
+    m_accessory(accessory)
 {
-    ESP_LOGI(TAG, "Creating FanDevice");
+    DM_LOGI(TAG, "Creating FanDevice");
 
     if (m_accessory != nullptr)
     {
-        m_accessory->setReportCallback([](void * self, bool onlySave) { static_cast<FanDevice *>(self)->reportEndpoint(onlySave); }, this);
+        m_accessory->setReportCallback(
+            [](void * self, bool onlySave) { static_cast<FanDevice *>(self)->requestReport(onlySave); }, this);
     }
     else
     {
-        ESP_LOGW(TAG, "FanAccessory is null");
+        DM_LOGW(TAG, "FanAccessory is null");
     }
 
     if (endpointAggregator != nullptr)
@@ -26,42 +30,34 @@ FanDevice::FanDevice(const char * name, FanAccessoryInterface * accessory, esp_m
         m_endpoint = initializeBridgedNode(const_cast<char *>(name), endpointAggregator, this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize bridged node");
+            DM_LOGE(TAG, "Failed to initialize bridged node");
         }
     }
     else
     {
-        ESP_LOGI(TAG, "Creating FanDevice standalone endpoint");
+        DM_LOGI(TAG, "Creating FanDevice standalone endpoint");
         m_endpoint = initializeStandaloneNode(this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize standalone node");
+            DM_LOGE(TAG, "Failed to initialize standalone node");
         }
     }
 
     setupFan();
+    enableEndpoint(m_endpoint);
 
     if (m_accessory != nullptr)
     {
-        esp_matter::cluster_t * fanCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::FanControl::Id);
-        if (fanCluster == nullptr)
+        if (m_percentCurrentAttribute == nullptr)
         {
-            ESP_LOGE(TAG, "FanControl cluster is null");
-            return;
-        }
-
-        esp_matter::attribute_t * percentCurrentAttr =
-            esp_matter::attribute::get(fanCluster, chip::app::Clusters::FanControl::Attributes::PercentCurrent::Id);
-        if (percentCurrentAttr == nullptr)
-        {
-            ESP_LOGE(TAG, "PercentCurrent attribute is null");
+            DM_LOGE(TAG, "PercentCurrent attribute is null");
             return;
         }
 
         esp_matter_attr_val_t attrVal = esp_matter_uint8(0); // default value for percent current
-        if (esp_matter::attribute::get_val(percentCurrentAttr, &attrVal) != ESP_OK)
+        if (esp_matter::attribute::get_val(m_percentCurrentAttribute, &attrVal) != ESP_OK)
         {
-            ESP_LOGE(TAG, "Failed to get percent current attribute");
+            DM_LOGE(TAG, "Failed to get percent current attribute");
         }
         else
         {
@@ -72,16 +68,19 @@ FanDevice::FanDevice(const char * name, FanAccessoryInterface * accessory, esp_m
 
 FanDevice::~FanDevice()
 {
-    ESP_LOGI(TAG, "Destroying FanDevice");
-    // Clean up resources if needed
-    // Example: If m_endpoint or m_accessory needs explicit deallocation, do it here
+    DM_LOGI(TAG, "Destroying FanDevice");
+    if (m_accessory != nullptr)
+    {
+        m_accessory->setReportCallback(nullptr, nullptr);
+    }
+    releaseEndpoint(m_endpoint);
 }
 
 void FanDevice::setupFan()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
@@ -89,8 +88,27 @@ void FanDevice::setupFan()
     fanConfig.fan_control.fan_mode_sequence = 5;
     if (esp_matter::endpoint::fan::add(m_endpoint, &fanConfig) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add fan configuration");
+        DM_LOGE(TAG, "Failed to add fan configuration");
+        return;
     }
+
+    m_fanModeAttribute =
+        resolveAttribute(m_endpoint, chip::app::Clusters::FanControl::Id, chip::app::Clusters::FanControl::Attributes::FanMode::Id);
+    m_percentSettingAttribute = resolveAttribute(m_endpoint, chip::app::Clusters::FanControl::Id,
+                                                 chip::app::Clusters::FanControl::Attributes::PercentSetting::Id);
+    m_percentCurrentAttribute = resolveAttribute(m_endpoint, chip::app::Clusters::FanControl::Id,
+                                                 chip::app::Clusters::FanControl::Attributes::PercentCurrent::Id);
+}
+
+uint32_t FanDevice::captureState() const
+{
+    return m_accessory != nullptr && m_accessory->getPower() ? 1 : 0;
+}
+
+void FanDevice::deferStatePersistence()
+{
+    deferPersistence(m_fanModeAttribute);
+    deferPersistence(m_percentSettingAttribute);
 }
 
 esp_err_t FanDevice::updateAccessory(uint32_t attributeId)
@@ -100,48 +118,68 @@ esp_err_t FanDevice::updateAccessory(uint32_t attributeId)
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "Updating accessory state");
-    bool powerState = getEndpointPowerState();
+    esp_matter_attr_val_t attrVal = esp_matter_nullable_uint8(getEndpointPowerState() ? 100 : 0);
+    return updateAccessory(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::FanControl::Id, attributeId, &attrVal);
+}
+
+esp_err_t FanDevice::updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val)
+{
+    static constexpr AttributeHandler<FanDevice> handlers[] = {
+        { chip::app::Clusters::FanControl::Id, chip::app::Clusters::FanControl::Attributes::PercentSetting::Id,
+          &FanDevice::updatePercentSetting },
+    };
+    static constexpr AttributeDispatchTable<FanDevice, 1> table(handlers);
+    static_assert(table.isValid(), "Duplicate attribute handler");
+
+    return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+}
+
+esp_err_t FanDevice::updatePercentSetting(uint16_t endpointId, esp_matter_attr_val_t * val)
+{
+    DM_LOGD(TAG, "Updating accessory state");
+    recordPersistence(m_percentSettingAttribute);
+    bool powerState = (val->val.u8 > 0);
     if (m_accessory != nullptr)
     {
         m_accessory->setPower(powerState);
-        ESP_LOGD(TAG, "Set accessory power state to %d", powerState);
-        setEndpointPowerState(powerState); // because it should update other attributes
+        DM_LOGD(TAG, "Set accessory power state to %d", powerState);
+        // FanMode and PercentCurrent follow through a report, the executor task must not take the stack lock
+        requestReport(false);
     }
     else
     {
-        ESP_LOGE(TAG, "FanAccessory is null during update");
+        DM_LOGE(TAG, "FanAccessory is null during update");
     }
     return ESP_OK;
 }
 
 esp_err_t FanDevice::reportEndpoint(bool onlySave)
 {
-    ESP_LOGI(TAG, "Reporting endpoint state");
+    DM_LOGD(TAG, "Reporting endpoint state");
     if (m_accessory != nullptr)
     {
         bool powerState = m_accessory->getPower();
         setEndpointPowerState(powerState);
-        ESP_LOGD(TAG, "Reported endpoint power state as %d", powerState);
+        DM_LOGD(TAG, "Reported endpoint power state as %d", powerState);
     }
     else
     {
-        ESP_LOGE(TAG, "FanAccessory is null during report");
+        DM_LOGE(TAG, "FanAccessory is null during report");
     }
     return ESP_OK;
 }
 
 esp_err_t FanDevice::identify()
 {
-    ESP_LOGI(TAG, "Identifying device");
+    DM_LOGI(TAG, "Identifying device");
     if (m_accessory != nullptr)
     {
         m_accessory->identify();
-        ESP_LOGD(TAG, "Identified accessory");
+        DM_LOGD(TAG, "Identified accessory");
     }
     else
     {
-        ESP_LOGE(TAG, "FanAccessory is null during identify");
+        DM_LOGE(TAG, "FanAccessory is null during identify");
     }
     return ESP_OK;
 }
@@ -150,33 +188,24 @@ bool FanDevice::getEndpointPowerState()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
-        return false;
-    }
-
-    esp_matter::cluster_t * fanCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::FanControl::Id);
-    if (fanCluster == nullptr)
-    {
-        ESP_LOGE(TAG, "FanControl cluster is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return false;
     }
 
-    esp_matter::attribute_t * percentSettingAttr =
-        esp_matter::attribute::get(fanCluster, chip::app::Clusters::FanControl::Attributes::PercentSetting::Id);
-    if (percentSettingAttr == nullptr)
+    if (m_percentSettingAttribute == nullptr)
     {
-        ESP_LOGE(TAG, "PercentSetting attribute is null");
+        DM_LOGE(TAG, "PercentSetting attribute is null");
         return false;
     }
 
     esp_matter_attr_val_t attrVal;
-    if (esp_matter::attribute::get_val(percentSettingAttr, &attrVal) != ESP_OK)
+    if (esp_matter::attribute::get_val(m_percentSettingAttribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to get endpoint power state");
+        DM_LOGE(TAG, "Failed to get endpoint power state");
         return false;
     }
 
-    ESP_LOGD(TAG, "Got endpoint power state: %s", attrVal.val.u8 != 0 ? "true" : "false");
+    DM_LOGD(TAG, "Got endpoint power state: %d", attrVal.val.u8 != 0);
     return (attrVal.val.u8 > 0);
 }
 
@@ -184,26 +213,22 @@ void FanDevice::setEndpointPowerState(bool powerState)
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
-    esp_matter_attr_val_t valFanMode        = esp_matter_enum8(powerState ? 3 : 0);
-    esp_matter_attr_val_t valPercentSetting = esp_matter_nullable_uint8(powerState ? 100 : 0);
-    esp_matter_attr_val_t valPercentCurrent = esp_matter_uint8(powerState ? 100 : 0);
-    if (esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::FanControl::Id,
-                                      chip::app::Clusters::FanControl::Attributes::FanMode::Id, &valFanMode) != ESP_OK ||
-        esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::FanControl::Id,
-                                      chip::app::Clusters::FanControl::Attributes::PercentSetting::Id,
-                                      &valPercentSetting) != ESP_OK ||
-        esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::FanControl::Id,
-                                      chip::app::Clusters::FanControl::Attributes::PercentCurrent::Id,
-                                      &valPercentCurrent) != ESP_OK)
+    uint16_t endpointId = esp_matter::endpoint::get_id(m_endpoint);
+    AttributeBatch batch(&getStats());
+    batch.stage(endpointId, chip::app::Clusters::FanControl::Id, m_fanModeAttribute, esp_matter_enum8(powerState ? 3 : 0));
+    batch.stage(endpointId, chip::app::Clusters::FanControl::Id, m_percentSettingAttribute,
+                esp_matter_nullable_uint8(powerState ? 100 : 0));
+    batch.stage(endpointId, chip::app::Clusters::FanControl::Id, m_percentCurrentAttribute, esp_matter_uint8(powerState ? 100 : 0));
+    if (batch.commit() != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to set endpoint power state to %d", powerState);
+        DM_LOGE(TAG, "Failed to set endpoint power state to %d", powerState);
     }
     else
     {
-        ESP_LOGD(TAG, "Set endpoint power state to %d", powerState);
+        DM_LOGD(TAG, "Set endpoint power state to %d", powerState);
     }
 }
@@ -0,0 +1,52 @@
+#include "LatencyHistogram.hpp"
+
+uint32_t LatencyHistogram::percentileUs(uint16_t permille) const
+{
+    uint32_t count = m_count.load(std::memory_order_relaxed);
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the percentile, rounded up so p100 is the last latency
+    uint64_t rank       = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+    uint64_t cumulative = 0;
+    uint32_t maxUs      = m_maxUs.load(std::memory_order_relaxed);
+    for (uint8_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+    {
+        cumulative += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (cumulative >= rank && cumulative > 0)
+        {
+            uint32_t upperBound = upperBoundOf(bucket);
+            return upperBound < maxUs ? upperBound : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<uint32_t> & bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_maxUs.store(0, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::upperBoundOf(uint8_t bucket)
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+    if (bucket == BUCKET_COUNT - 1)
+    {
+        return UINT32_MAX;
+    }
+
+    // Bucket 2 * msb + half covers [2^msb + half * 2^(msb - 1), 2^msb + (half + 1) * 2^(msb - 1))
+    uint8_t msb  = bucket / 2;
+    uint8_t half = bucket % 2;
+    return (1u << msb) + (half + 1) * (1u << (msb - 1)) - 1;
+}
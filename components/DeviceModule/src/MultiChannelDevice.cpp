@@ -0,0 +1,203 @@
+#include "MultiChannelDevice.hpp"
+#include "AttributeBatch.hpp"
+#include "AttributeDispatchTable.hpp"
+#include "DeviceLog.hpp"
+#include <cstdio>
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <esp_matter_endpoint.h>
+
+static const char * TAG = "MultiChannelDevice";
+
+MultiChannelDevice::MultiChannelDevice(const char * name, const char * const * channelNames, uint8_t channelCount,
+                                       esp_matter::endpoint_t * endpointAggregator) :
+    m_endpoints(), m_onOffAttributes(), m_channelCount(channelCount)
+{
+    DM_LOGI(TAG, "Creating MultiChannelDevice with %d channels", channelCount);
+
+    if (m_channelCount > CONFIG_D_M_MAX_CHANNELS_PER_DEVICE)
+    {
+        DM_LOGE(TAG, "Too many channels, limiting to %d", CONFIG_D_M_MAX_CHANNELS_PER_DEVICE);
+        m_channelCount = CONFIG_D_M_MAX_CHANNELS_PER_DEVICE;
+    }
+
+    initializeChannels(name, channelNames, endpointAggregator);
+    setupChannels();
+}
+
+MultiChannelDevice::~MultiChannelDevice()
+{
+    DM_LOGI(TAG, "Destroying MultiChannelDevice");
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        releaseEndpoint(m_endpoints[channel]);
+    }
+}
+
+void MultiChannelDevice::initializeChannels(const char * name, const char * const * channelNames,
+                                            esp_matter::endpoint_t * endpointAggregator)
+{
+    char channelName[CONFIG_D_M_MAX_DEVICE_NAME_LEN];
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        if (endpointAggregator != nullptr)
+        {
+            if (channelNames != nullptr && channelNames[channel] != nullptr)
+            {
+                snprintf(channelName, sizeof(channelName), "%s", channelNames[channel]);
+            }
+            else
+            {
+                snprintf(channelName, sizeof(channelName), "%s %d", name != nullptr ? name : "Channel", channel + 1);
+            }
+            m_endpoints[channel] = initializeBridgedNode(channelName, endpointAggregator, this);
+        }
+        else
+        {
+            m_endpoints[channel] = initializeStandaloneNode(this);
+        }
+
+        if (m_endpoints[channel] == nullptr)
+        {
+            DM_LOGE(TAG, "Failed to initialize endpoint of channel %d", channel);
+        }
+    }
+}
+
+void MultiChannelDevice::setupChannels()
+{
+    esp_matter::endpoint::on_off_plugin_unit::config_t pluginConfig;
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        if (m_endpoints[channel] == nullptr)
+        {
+            continue;
+        }
+
+        if (esp_matter::endpoint::on_off_plugin_unit::add(m_endpoints[channel], &pluginConfig) != ESP_OK)
+        {
+            DM_LOGE(TAG, "Failed to add on/off plugin configuration to channel %d", channel);
+            continue;
+        }
+
+        m_onOffAttributes[channel] = resolveAttribute(m_endpoints[channel], chip::app::Clusters::OnOff::Id,
+                                                      chip::app::Clusters::OnOff::Attributes::OnOff::Id);
+        m_channelMap.insert(esp_matter::endpoint::get_id(m_endpoints[channel]), channel);
+        enableEndpoint(m_endpoints[channel]);
+    }
+}
+
+uint32_t MultiChannelDevice::captureState() const
+{
+    uint32_t states = 0;
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        if (retrieveChannelState(channel))
+        {
+            states |= 1u << channel;
+        }
+    }
+    return states;
+}
+
+void MultiChannelDevice::deferStatePersistence()
+{
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        deferPersistence(m_onOffAttributes[channel]);
+    }
+}
+
+esp_err_t MultiChannelDevice::updateAccessory(uint32_t attributeId)
+{
+    esp_err_t result = ESP_OK;
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        if (m_endpoints[channel] != nullptr &&
+            updateAccessory(attributeId, esp_matter::endpoint::get_id(m_endpoints[channel])) != ESP_OK)
+        {
+            result = ESP_FAIL;
+        }
+    }
+    return result;
+}
+
+esp_err_t MultiChannelDevice::updateAccessory(uint32_t attributeId, uint16_t endpointId)
+{
+    if (attributeId != chip::app::Clusters::OnOff::Attributes::OnOff::Id)
+    {
+        return ESP_OK;
+    }
+
+    uint8_t channel = m_channelMap.find(endpointId);
+    if (channel == EndpointChannelMap::NO_CHANNEL)
+    {
+        DM_LOGE(TAG, "Invalid endpoint ID");
+        return ESP_FAIL;
+    }
+
+    esp_matter_attr_val_t attrVal;
+    if (esp_matter::attribute::get_val(m_onOffAttributes[channel], &attrVal) != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to get OnOff attribute value");
+        return ESP_FAIL;
+    }
+
+    return updateAccessory(endpointId, chip::app::Clusters::OnOff::Id, attributeId, &attrVal);
+}
+
+esp_err_t MultiChannelDevice::updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId,
+                                              esp_matter_attr_val_t * val)
+{
+    static constexpr AttributeHandler<MultiChannelDevice> handlers[] = {
+        { chip::app::Clusters::OnOff::Id, chip::app::Clusters::OnOff::Attributes::OnOff::Id, &MultiChannelDevice::updateOnOff },
+    };
+    static constexpr AttributeDispatchTable<MultiChannelDevice, 1> table(handlers);
+    static_assert(table.isValid(), "Duplicate attribute handler");
+
+    return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+}
+
+esp_err_t MultiChannelDevice::updateOnOff(uint16_t endpointId, esp_matter_attr_val_t * val)
+{
+    uint8_t channel = m_channelMap.find(endpointId);
+    if (channel == EndpointChannelMap::NO_CHANNEL)
+    {
+        DM_LOGE(TAG, "Invalid endpoint ID");
+        return ESP_FAIL;
+    }
+
+    recordPersistence(m_onOffAttributes[channel]);
+
+    DM_LOGD(TAG, "Updating channel %d to %d", channel, val->val.b);
+    applyChannelState(channel, val->val.b);
+    return ESP_OK;
+}
+
+esp_err_t MultiChannelDevice::reportEndpoint(bool onlySave)
+{
+    return reportEndpoint(onlySave, CHANGED_ALL);
+}
+
+esp_err_t MultiChannelDevice::reportEndpoint(bool onlySave, uint32_t changeMask)
+{
+    // The batch skips channels whose data model value already matches, controller writes included
+    AttributeBatch batch(&getStats());
+    for (uint8_t channel = 0; channel < m_channelCount; channel++)
+    {
+        if ((changeMask & (1u << channel)) == 0 || m_onOffAttributes[channel] == nullptr)
+        {
+            continue;
+        }
+
+        batch.stage(esp_matter::endpoint::get_id(m_endpoints[channel]), chip::app::Clusters::OnOff::Id,
+                    m_onOffAttributes[channel], esp_matter_bool(retrieveChannelState(channel)));
+    }
+
+    if (batch.commit(onlySave) != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to report channel states");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,73 @@
+#include "MultiPluginDevice.hpp"
+#include "DeviceLog.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+
+static const char * TAG = "MultiPluginDevice";
+
+MultiPluginDevice::MultiPluginDevice(const char * name, PluginAccessoryInterface * const * accessories, uint8_t channelCount,
+                                     esp_matter::endpoint_t * endpointAggregator) :
+    MultiChannelDevice(name, nullptr, channelCount, endpointAggregator), m_accessories(), m_contexts()
+{
+    DM_LOGI(TAG, "Creating MultiPluginDevice");
+
+    for (uint8_t channel = 0; channel < getChannelCount(); channel++)
+    {
+        m_accessories[channel] = accessories != nullptr ? accessories[channel] : nullptr;
+        m_contexts[channel]    = { this, channel };
+        if (m_accessories[channel] == nullptr)
+        {
+            DM_LOGW(TAG, "PluginAccessory of channel %d is null", channel);
+            continue;
+        }
+
+        // Each accessory only reports its own channel
+        m_accessories[channel]->setReportCallback(
+            [](void * context, bool onlySave) {
+                ChannelContext * channelContext = static_cast<ChannelContext *>(context);
+                channelContext->device->requestReport(onlySave, 1u << channelContext->channel);
+            },
+            &m_contexts[channel]);
+    }
+}
+
+MultiPluginDevice::~MultiPluginDevice()
+{
+    DM_LOGI(TAG, "Destroying MultiPluginDevice");
+    for (uint8_t channel = 0; channel < getChannelCount(); channel++)
+    {
+        if (m_accessories[channel] != nullptr)
+        {
+            m_accessories[channel]->setReportCallback(nullptr, nullptr);
+        }
+    }
+}
+
+void MultiPluginDevice::applyChannelState(uint8_t channel, bool powerState)
+{
+    if (m_accessories[channel] == nullptr)
+    {
+        DM_LOGE(TAG, "PluginAccessory of channel %d is null", channel);
+        return;
+    }
+
+    m_accessories[channel]->setPower(powerState);
+}
+
+bool MultiPluginDevice::retrieveChannelState(uint8_t channel) const
+{
+    return m_accessories[channel] != nullptr ? m_accessories[channel]->getPower() : false;
+}
+
+esp_err_t MultiPluginDevice::identify()
+{
+    for (uint8_t channel = 0; channel < getChannelCount(); channel++)
+    {
+        if (m_accessories[channel] != nullptr)
+        {
+            m_accessories[channel]->identify();
+        }
+    }
+
+    return ESP_OK;
+}
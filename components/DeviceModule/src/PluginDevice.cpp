@@ -1,24 +1,26 @@
 #include "PluginDevice.hpp"
+#include "AttributeBatch.hpp"
+#include "AttributeDispatchTable.hpp"
+#include "DeviceLog.hpp"
 #include <esp_err.h>
-#include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_endpoint.h>
 
 static const char * TAG = "PluginDevice";
 
 PluginDevice::PluginDevice(char * name, PluginAccessoryInterface * accessory, esp_matter::endpoint_t * endpointAggregator) :
-    m_endpoint(nullptr), m_accessory(accessory)
+    m_endpoint(nullptr), m_onOffAttribute(nullptr), m_accessory(accessory)
 {
-    ESP_LOGI(TAG, "Creating PluginDevice");
+    DM_LOGI(TAG, "Creating PluginDevice");
 
     if (m_accessory != nullptr)
     {
         m_accessory->setReportCallback(
-            [](void * self, bool onlySave) { static_cast<PluginDevice *>(self)->reportEndpoint(onlySave); }, this);
+            [](void * self, bool onlySave) { static_cast<PluginDevice *>(self)->requestReport(onlySave); }, this);
     }
     else
     {
-        ESP_LOGW(TAG, "PluginAccessory is null");
+        DM_LOGW(TAG, "PluginAccessory is null");
     }
 
     if (endpointAggregator != nullptr)
@@ -26,20 +28,21 @@ PluginDevice::PluginDevice(char * name, PluginAccessoryInterface * accessory, es
         m_endpoint = initializeBridgedNode(name, endpointAggregator, this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize bridged node");
+            DM_LOGE(TAG, "Failed to initialize bridged node");
         }
     }
     else
     {
-        ESP_LOGI(TAG, "Creating PluginDevice standalone endpoint");
+        DM_LOGI(TAG, "Creating PluginDevice standalone endpoint");
         m_endpoint = initializeStandaloneNode(this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize standalone node");
+            DM_LOGE(TAG, "Failed to initialize standalone node");
         }
     }
 
     setupOnOffPlugin();
+    enableEndpoint(m_endpoint);
 
     if (m_accessory != nullptr)
     {
@@ -49,16 +52,19 @@ PluginDevice::PluginDevice(char * name, PluginAccessoryInterface * accessory, es
 
 PluginDevice::~PluginDevice()
 {
-    ESP_LOGI(TAG, "Destroying PluginDevice");
-    // Clean up resources if needed
-    // Example: If m_endpoint or m_accessory needs explicit deallocation, do it here
+    DM_LOGI(TAG, "Destroying PluginDevice");
+    if (m_accessory != nullptr)
+    {
+        m_accessory->setReportCallback(nullptr, nullptr);
+    }
+    releaseEndpoint(m_endpoint);
 }
 
 void PluginDevice::setupOnOffPlugin()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
@@ -66,8 +72,22 @@ void PluginDevice::setupOnOffPlugin()
     pluginConfig.on_off.lighting.start_up_on_off = nullptr;
     if (esp_matter::endpoint::on_off_plugin_unit::add(m_endpoint, &pluginConfig) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add on/off plugin configuration");
+        DM_LOGE(TAG, "Failed to add on/off plugin configuration");
+        return;
     }
+
+    m_onOffAttribute =
+        resolveAttribute(m_endpoint, chip::app::Clusters::OnOff::Id, chip::app::Clusters::OnOff::Attributes::OnOff::Id);
+}
+
+uint32_t PluginDevice::captureState() const
+{
+    return m_accessory != nullptr && m_accessory->getPower() ? 1 : 0;
+}
+
+void PluginDevice::deferStatePersistence()
+{
+    deferPersistence(m_onOffAttribute);
 }
 
 esp_err_t PluginDevice::updateAccessory(uint32_t attributeId)
@@ -77,47 +97,65 @@ esp_err_t PluginDevice::updateAccessory(uint32_t attributeId)
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "Updating accessory state");
-    bool powerState = retrieveEndpointPowerState();
+    esp_matter_attr_val_t attrVal = esp_matter_bool(retrieveEndpointPowerState());
+    return updateAccessory(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::OnOff::Id, attributeId, &attrVal);
+}
+
+esp_err_t PluginDevice::updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val)
+{
+    static constexpr AttributeHandler<PluginDevice> handlers[] = {
+        { chip::app::Clusters::OnOff::Id, chip::app::Clusters::OnOff::Attributes::OnOff::Id, &PluginDevice::updateOnOff },
+    };
+    static constexpr AttributeDispatchTable<PluginDevice, 1> table(handlers);
+    static_assert(table.isValid(), "Duplicate attribute handler");
+
+    return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+}
+
+esp_err_t PluginDevice::updateOnOff(uint16_t endpointId, esp_matter_attr_val_t * val)
+{
+    DM_LOGD(TAG, "Updating accessory state");
+    recordPersistence(m_onOffAttribute);
+    bool powerState = val->val.b;
     if (m_accessory != nullptr)
     {
         m_accessory->setPower(powerState);
-        ESP_LOGD(TAG, "Set accessory power state to %d", powerState);
+        DM_LOGD(TAG, "Set accessory power state to %d", powerState);
     }
     else
     {
-        ESP_LOGE(TAG, "PluginAccessory is null during update");
+        DM_LOGE(TAG, "PluginAccessory is null during update");
     }
     return ESP_OK;
 }
 
 esp_err_t PluginDevice::reportEndpoint(bool onlySave)
 {
-    ESP_LOGI(TAG, "Reporting endpoint state");
+    DM_LOGD(TAG, "Reporting endpoint state");
     if (m_accessory != nullptr)
     {
         bool powerState = m_accessory->getPower();
         updateEndpointPowerState(powerState);
-        ESP_LOGD(TAG, "Reported endpoint state");
+        DM_LOGD(TAG, "Reported endpoint state");
     }
     else
     {
-        ESP_LOGE(TAG, "PluginAccessory is null during report");
+        DM_LOGE(TAG, "PluginAccessory is null during report");
     }
     return ESP_OK;
 }
 
 esp_err_t PluginDevice::identify()
 {
-    ESP_LOGI(TAG, "Identifying device");
+    DM_LOGI(TAG, "Identifying device");
     if (m_accessory != nullptr)
     {
         m_accessory->identify();
-        ESP_LOGD(TAG, "Identified accessory");
+        DM_LOGD(TAG, "Identified accessory");
     }
     else
     {
-        ESP_LOGE(TAG, "PluginAccessory is null during identify");
+        DM_LOGE(TAG, "PluginAccessory is null during identify");
     }
     return ESP_OK;
 }
@@ -126,32 +164,23 @@ bool PluginDevice::retrieveEndpointPowerState()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
-        return false;
-    }
-
-    esp_matter::cluster_t * onOffCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::OnOff::Id);
-    if (onOffCluster == nullptr)
-    {
-        ESP_LOGE(TAG, "OnOff cluster is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return false;
     }
 
-    esp_matter::attribute_t * onOffAttribute =
-        esp_matter::attribute::get(onOffCluster, chip::app::Clusters::OnOff::Attributes::OnOff::Id);
-    if (onOffAttribute == nullptr)
+    if (m_onOffAttribute == nullptr)
     {
-        ESP_LOGE(TAG, "OnOff attribute is null");
+        DM_LOGE(TAG, "OnOff attribute is null");
         return false;
     }
 
     esp_matter_attr_val_t attrVal;
-    if (esp_matter::attribute::get_val(onOffAttribute, &attrVal) != ESP_OK)
+    if (esp_matter::attribute::get_val(m_onOffAttribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to get endpoint power state");
+        DM_LOGE(TAG, "Failed to get endpoint power state");
         return false;
     }
-    ESP_LOGD(TAG, "Got endpoint power state: %d", attrVal.val.b);
+    DM_LOGD(TAG, "Got endpoint power state: %d", attrVal.val.b);
     return attrVal.val.b;
 }
 
@@ -159,18 +188,19 @@ void PluginDevice::updateEndpointPowerState(bool powerState)
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
-    esp_matter_attr_val_t attrVal = esp_matter_bool(powerState);
-    if (esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::OnOff::Id,
-                                      chip::app::Clusters::OnOff::Attributes::OnOff::Id, &attrVal) != ESP_OK)
+    AttributeBatch batch(&getStats());
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::OnOff::Id, m_onOffAttribute,
+                esp_matter_bool(powerState));
+    if (batch.commit() != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to set endpoint power state to %d", powerState);
+        DM_LOGE(TAG, "Failed to set endpoint power state to %d", powerState);
     }
     else
     {
-        ESP_LOGD(TAG, "Set endpoint power state to %d", powerState);
+        DM_LOGD(TAG, "Set endpoint power state to %d", powerState);
     }
 }
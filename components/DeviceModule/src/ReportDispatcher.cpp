@@ -0,0 +1,262 @@
+#include "ReportDispatcher.hpp"
+#include "DeviceLog.hpp"
+#include "StackLockProfiler.hpp"
+#include <esp_err.h>
+#include <esp_matter.h>
+#include <freertos/task.h>
+
+static const char * TAG = "ReportDispatcher";
+
+static constexpr uint32_t EVENT_INDEX_MASK = CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH - 1;
+
+ReportDispatcher::ReportDispatcher() :
+    m_slots(), m_events(), m_eventTail(0), m_eventHead(0), m_wake(nullptr), m_stopped(nullptr), m_running(false), m_posted(0),
+    m_reported(0), m_eventsReported(0), m_eventOverflows(0)
+{
+    // A record is free for the ring position equal to its sequence, and filled once the sequence is one past it
+    for (uint32_t i = 0; i < CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH; i++)
+    {
+        m_events[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+ReportDispatcher::~ReportDispatcher()
+{
+    stop();
+    for (Slot & slot : m_slots)
+    {
+        BaseDeviceInterface * device = slot.device.load(std::memory_order_relaxed);
+        if (device != nullptr)
+        {
+            device->m_reportDispatcher.store(nullptr, std::memory_order_release);
+        }
+    }
+}
+
+esp_err_t ReportDispatcher::start()
+{
+    if (m_running.load())
+    {
+        return ESP_OK;
+    }
+
+    m_wake    = xSemaphoreCreateBinary();
+    m_stopped = xSemaphoreCreateBinary();
+    if (m_wake == nullptr || m_stopped == nullptr)
+    {
+        DM_LOGE(TAG, "Failed to create report semaphores");
+        stop();
+        return ESP_ERR_NO_MEM;
+    }
+
+    m_running.store(true);
+    if (xTaskCreate(taskFunction, "report", CONFIG_D_M_REPORT_TASK_STACK_SIZE, this, CONFIG_D_M_REPORT_TASK_PRIORITY, nullptr) !=
+        pdPASS)
+    {
+        DM_LOGE(TAG, "Failed to create report task");
+        m_running.store(false);
+        stop();
+        return ESP_ERR_NO_MEM;
+    }
+
+    DM_LOGI(TAG, "Report dispatcher started, %d slots", CONFIG_D_M_REPORT_DISPATCHER_SLOTS);
+    return ESP_OK;
+}
+
+void ReportDispatcher::stop()
+{
+    if (m_running.exchange(false))
+    {
+        // Wake the task so it drains what is pending and ends
+        xSemaphoreGive(m_wake);
+        xSemaphoreTake(m_stopped, portMAX_DELAY);
+    }
+
+    if (m_wake != nullptr)
+    {
+        vSemaphoreDelete(m_wake);
+        m_wake = nullptr;
+    }
+    if (m_stopped != nullptr)
+    {
+        vSemaphoreDelete(m_stopped);
+        m_stopped = nullptr;
+    }
+}
+
+esp_err_t ReportDispatcher::attach(BaseDeviceInterface * device)
+{
+    if (device == nullptr)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (device->m_reportDispatcher.load() == this)
+    {
+        return ESP_OK;
+    }
+
+    for (uint8_t i = 0; i < CONFIG_D_M_REPORT_DISPATCHER_SLOTS; i++)
+    {
+        Slot & slot = m_slots[i];
+        if (slot.device.load() != nullptr)
+        {
+            continue;
+        }
+
+        slot.reportMask.store(0);
+        slot.saveMask.store(0);
+        slot.generation.fetch_add(1);
+        slot.device.store(device, std::memory_order_release);
+        device->m_reportSlot = i;
+        device->m_reportDispatcher.store(this, std::memory_order_release);
+        return ESP_OK;
+    }
+
+    DM_LOGE(TAG, "No free report slot");
+    return ESP_ERR_NO_MEM;
+}
+
+void ReportDispatcher::detach(BaseDeviceInterface * device)
+{
+    if (device == nullptr || device->m_reportDispatcher.load() != this)
+    {
+        return;
+    }
+
+    device->m_reportDispatcher.store(nullptr, std::memory_order_release);
+    m_slots[device->m_reportSlot].device.store(nullptr, std::memory_order_release);
+}
+
+bool ReportDispatcher::post(BaseDeviceInterface * device, uint8_t slot, bool onlySave, uint32_t changeMask)
+{
+    if (!m_running.load(std::memory_order_acquire) || m_slots[slot].device.load(std::memory_order_acquire) != device)
+    {
+        return false;
+    }
+
+    std::atomic<uint32_t> & mask = onlySave ? m_slots[slot].saveMask : m_slots[slot].reportMask;
+    mask.fetch_or(changeMask, std::memory_order_release);
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+    xSemaphoreGive(m_wake);
+    return true;
+}
+
+bool ReportDispatcher::postEvent(BaseDeviceInterface * device, uint8_t slot, uint32_t event)
+{
+    if (!m_running.load(std::memory_order_acquire) || m_slots[slot].device.load(std::memory_order_acquire) != device)
+    {
+        return false;
+    }
+
+    EventRecord * record = nullptr;
+    uint32_t position    = m_eventTail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        record           = &m_events[position & EVENT_INDEX_MASK];
+        int32_t distance = static_cast<int32_t>(record->sequence.load(std::memory_order_acquire) - position);
+        if (distance == 0)
+        {
+            if (m_eventTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (distance < 0)
+        {
+            // The report task has not emitted the record a full ring ago yet
+            m_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = m_eventTail.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->device     = device;
+    record->slot       = slot;
+    record->generation = m_slots[slot].generation.load(std::memory_order_relaxed);
+    record->event      = event;
+    record->sequence.store(position + 1, std::memory_order_release);
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+    xSemaphoreGive(m_wake);
+    return true;
+}
+
+void ReportDispatcher::taskFunction(void * self)
+{
+    ReportDispatcher * dispatcher = static_cast<ReportDispatcher *>(self);
+    while (true)
+    {
+        xSemaphoreTake(dispatcher->m_wake, portMAX_DELAY);
+        bool running = dispatcher->m_running.load(std::memory_order_acquire);
+        dispatcher->drain();
+        if (!running)
+        {
+            break;
+        }
+    }
+
+    xSemaphoreGive(dispatcher->m_stopped);
+    vTaskDelete(nullptr);
+}
+
+void ReportDispatcher::drain()
+{
+    esp_matter::lock::status_t lockStatus = StackLockProfiler::lock(StackLockProfiler::REPORT_DISPATCHER);
+    if (lockStatus == esp_matter::lock::status::FAILED)
+    {
+        DM_LOGE(TAG, "Failed to lock chip stack");
+        return;
+    }
+
+    drainEvents();
+    for (Slot & slot : m_slots)
+    {
+        BaseDeviceInterface * device = slot.device.load(std::memory_order_acquire);
+        if (device == nullptr)
+        {
+            continue;
+        }
+
+        uint32_t reportMask = slot.reportMask.exchange(0, std::memory_order_acquire);
+        uint32_t saveMask   = slot.saveMask.exchange(0, std::memory_order_acquire) & ~reportMask;
+        if (reportMask != 0)
+        {
+            device->reportEndpoint(false, reportMask);
+            m_reported.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (saveMask != 0)
+        {
+            device->reportEndpoint(true, saveMask);
+            m_reported.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    StackLockProfiler::unlock(StackLockProfiler::REPORT_DISPATCHER, lockStatus);
+}
+
+void ReportDispatcher::drainEvents()
+{
+    while (true)
+    {
+        EventRecord & record = m_events[m_eventHead & EVENT_INDEX_MASK];
+        if (static_cast<int32_t>(record.sequence.load(std::memory_order_acquire) - (m_eventHead + 1)) < 0)
+        {
+            // Empty, or the next record is still being filled and its producer wakes the task again
+            break;
+        }
+
+        // Detach runs under the chip stack lock too, so a matching slot means the device is still alive
+        const Slot & slot = m_slots[record.slot];
+        if (slot.device.load(std::memory_order_acquire) == record.device &&
+            slot.generation.load(std::memory_order_relaxed) == record.generation)
+        {
+            record.device->reportEvent(record.event);
+            m_eventsReported.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        record.sequence.store(m_eventHead + CONFIG_D_M_REPORT_EVENT_QUEUE_LENGTH, std::memory_order_release);
+        m_eventHead++;
+    }
+}
@@ -0,0 +1,159 @@
+#include "StackLockProfiler.hpp"
+#include <atomic>
+#include <cstdio>
+#include <esp_matter.h>
+#include <esp_timer.h>
+
+/* Wait or hold times of one site, updated from any task */
+struct AtomicHistogram
+{
+    std::atomic<uint32_t> buckets[StackLockProfiler::BUCKET_COUNT];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> totalUs;
+    std::atomic<uint32_t> maxUs;
+};
+
+static const char * const SITE_NAMES[StackLockProfiler::SITE_COUNT] = {
+    "AttributeBatch", "ButtonEvent", "ReportDispatcher", "DeviceRegistry",
+};
+
+static AtomicHistogram s_waitTimes[StackLockProfiler::SITE_COUNT];
+static AtomicHistogram s_holdTimes[StackLockProfiler::SITE_COUNT];
+
+#if CONFIG_D_M_STACK_LOCK_PROFILER
+/* nowUs() when the lock was taken, only the lock holder writes it and the lock orders the accesses */
+static uint32_t s_acquiredAt = 0;
+
+static uint32_t nowUs()
+{
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+static uint32_t elapsedUs(uint32_t startUs)
+{
+    // Unsigned subtraction is correct across one wrap
+    return nowUs() - startUs;
+}
+
+static void record(AtomicHistogram & histogram, uint32_t timeUs)
+{
+    uint8_t bucket = 0;
+    while (bucket < StackLockProfiler::BUCKET_COUNT - 1 && timeUs >= StackLockProfiler::BUCKET_LIMITS_US[bucket])
+    {
+        bucket++;
+    }
+
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.totalUs.fetch_add(timeUs, std::memory_order_relaxed);
+    if (timeUs > histogram.maxUs.load(std::memory_order_relaxed))
+    {
+        histogram.maxUs.store(timeUs, std::memory_order_relaxed);
+    }
+}
+#endif
+
+static StackLockProfiler::Histogram snapshot(const AtomicHistogram & histogram)
+{
+    StackLockProfiler::Histogram result = {};
+    for (uint8_t bucket = 0; bucket < StackLockProfiler::BUCKET_COUNT; bucket++)
+    {
+        result.buckets[bucket] = histogram.buckets[bucket].load(std::memory_order_relaxed);
+    }
+    result.count   = histogram.count.load(std::memory_order_relaxed);
+    result.totalUs = histogram.totalUs.load(std::memory_order_relaxed);
+    result.maxUs   = histogram.maxUs.load(std::memory_order_relaxed);
+    return result;
+}
+
+static void clear(AtomicHistogram & histogram)
+{
+    for (std::atomic<uint32_t> & bucket : histogram.buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    histogram.count.store(0, std::memory_order_relaxed);
+    histogram.totalUs.store(0, std::memory_order_relaxed);
+    histogram.maxUs.store(0, std::memory_order_relaxed);
+}
+
+static void printHistogram(const char * site, const char * kind, const StackLockProfiler::Histogram & histogram)
+{
+    printf("%-17s %-4s %8u %8u %8u", site, kind, (unsigned) histogram.count,
+           (unsigned) (histogram.count == 0 ? 0 : histogram.totalUs / histogram.count), (unsigned) histogram.maxUs);
+    for (uint32_t count : histogram.buckets)
+    {
+        printf(" %7u", (unsigned) count);
+    }
+    printf("\n");
+}
+
+esp_matter::lock::status_t StackLockProfiler::lock(Site site)
+{
+#if CONFIG_D_M_STACK_LOCK_PROFILER
+    uint32_t start                        = nowUs();
+    esp_matter::lock::status_t lockStatus = esp_matter::lock::chip_stack_lock(portMAX_DELAY);
+    if (lockStatus == esp_matter::lock::status::SUCCESS)
+    {
+        record(s_waitTimes[site], elapsedUs(start));
+        s_acquiredAt = nowUs();
+    }
+    return lockStatus;
+#else
+    (void) site;
+    return esp_matter::lock::chip_stack_lock(portMAX_DELAY);
+#endif
+}
+
+void StackLockProfiler::unlock(Site site, esp_matter::lock::status_t lockStatus)
+{
+    if (lockStatus != esp_matter::lock::status::SUCCESS)
+    {
+        return;
+    }
+
+#if CONFIG_D_M_STACK_LOCK_PROFILER
+    record(s_holdTimes[site], elapsedUs(s_acquiredAt));
+#else
+    (void) site;
+#endif
+    esp_matter::lock::chip_stack_unlock();
+}
+
+StackLockProfiler::Histogram StackLockProfiler::waitTimes(Site site)
+{
+    return snapshot(s_waitTimes[site]);
+}
+
+StackLockProfiler::Histogram StackLockProfiler::holdTimes(Site site)
+{
+    return snapshot(s_holdTimes[site]);
+}
+
+void StackLockProfiler::print()
+{
+    char label[12];
+    printf("%-17s %-4s %8s %8s %8s", "site", "", "count", "meanUs", "maxUs");
+    for (uint32_t limit : BUCKET_LIMITS_US)
+    {
+        snprintf(label, sizeof(label), "<%u", (unsigned) limit);
+        printf(" %7s", label);
+    }
+    snprintf(label, sizeof(label), ">=%u", (unsigned) BUCKET_LIMITS_US[BUCKET_COUNT - 2]);
+    printf(" %7s\n", label);
+
+    for (uint8_t site = 0; site < SITE_COUNT; site++)
+    {
+        printHistogram(SITE_NAMES[site], "wait", waitTimes(static_cast<Site>(site)));
+        printHistogram(SITE_NAMES[site], "hold", holdTimes(static_cast<Site>(site)));
+    }
+}
+
+void StackLockProfiler::reset()
+{
+    for (uint8_t site = 0; site < SITE_COUNT; site++)
+    {
+        clear(s_waitTimes[site]);
+        clear(s_holdTimes[site]);
+    }
+}
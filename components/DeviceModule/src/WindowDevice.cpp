@@ -1,26 +1,32 @@
 #include "WindowDevice.hpp"
+#include "AttributeDispatchTable.hpp"
+#include "DeviceLog.hpp"
 #include <esp_err.h>
-#include <esp_log.h>
 #include <esp_matter.h>
 #include <esp_matter_endpoint.h>
 
 static const char * TAG = "WindowDevice";
 
 WindowDevice::WindowDevice(const char * name, BlindAccessoryInterface * accessory, esp_matter::endpoint_t * endpointAggregator) :
-    m_endpoint(nullptr), m_accessory(accessory)
+    m_endpoint(nullptr), m_currentPositionPercentageAttribute(nullptr), m_currentPosition100thsAttribute(nullptr),
+    m_targetPosition100thsAttribute(nullptr), m_operationalStatusAttribute(nullptr), m_accessory(accessory)
 {
-    ESP_LOGI(TAG, "Creating WindowDevice");
+    DM_LOGI(TAG, "Creating WindowDevice");
     initializeAccessory();
     initializeEndpoint(name, endpointAggregator);
     setupWindowCovering();
+    enableEndpoint(m_endpoint);
     configureAccessoryDefaultPosition();
 }
 
 WindowDevice::~WindowDevice()
 {
-    ESP_LOGI(TAG, "Destroying WindowDevice");
-    // Clean up resources if needed
-    // Example: If m_endpoint or m_accessory needs explicit deallocation, do it here
+    DM_LOGI(TAG, "Destroying WindowDevice");
+    if (m_accessory != nullptr)
+    {
+        m_accessory->setReportCallback(nullptr, nullptr);
+    }
+    releaseEndpoint(m_endpoint);
 }
 
 void WindowDevice::initializeAccessory()
@@ -28,11 +34,11 @@ void WindowDevice::initializeAccessory()
     if (m_accessory != nullptr)
     {
         m_accessory->setReportCallback(
-            [](void * self, bool onlySave) { static_cast<WindowDevice *>(self)->reportEndpoint(onlySave); }, this);
+            [](void * self, bool onlySave) { static_cast<WindowDevice *>(self)->requestReport(onlySave); }, this);
     }
     else
     {
-        ESP_LOGW(TAG, "BlindAccessory is null");
+        DM_LOGW(TAG, "BlindAccessory is null");
     }
 }
 
@@ -43,16 +49,16 @@ void WindowDevice::initializeEndpoint(const char * name, esp_matter::endpoint_t
         m_endpoint = initializeBridgedNode(const_cast<char *>(name), endpointAggregator, this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize bridged node");
+            DM_LOGE(TAG, "Failed to initialize bridged node");
         }
     }
     else
     {
-        ESP_LOGI(TAG, "Creating WindowDevice standalone endpoint");
+        DM_LOGI(TAG, "Creating WindowDevice standalone endpoint");
         m_endpoint = initializeStandaloneNode(this);
         if (m_endpoint == nullptr)
         {
-            ESP_LOGE(TAG, "Failed to initialize standalone node");
+            DM_LOGE(TAG, "Failed to initialize standalone node");
         }
     }
 }
@@ -65,33 +71,43 @@ void WindowDevice::configureAccessoryDefaultPosition()
     }
 }
 
-void WindowDevice::setDeferredPersistenceForAttributes(esp_matter::cluster_t * windowCoveringCluster)
+void WindowDevice::setDeferredPersistenceForAttributes()
+{
+    esp_matter::attribute::set_deferred_persistence(m_currentPositionPercentageAttribute);
+    esp_matter::attribute::set_deferred_persistence(m_currentPosition100thsAttribute);
+}
+
+void WindowDevice::resolveAttributeHandles(esp_matter::cluster_t * windowCoveringCluster)
 {
-    esp_matter::attribute::set_deferred_persistence(esp_matter::attribute::get(
-        windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercentage::Id));
-    esp_matter::attribute::set_deferred_persistence(esp_matter::attribute::get(
-        windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercent100ths::Id));
+    m_currentPositionPercentageAttribute = esp_matter::attribute::get(
+        windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercentage::Id);
+    m_currentPosition100thsAttribute = esp_matter::attribute::get(
+        windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercent100ths::Id);
+    m_targetPosition100thsAttribute = esp_matter::attribute::get(
+        windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id);
+    m_operationalStatusAttribute =
+        esp_matter::attribute::get(windowCoveringCluster, chip::app::Clusters::WindowCovering::Attributes::OperationalStatus::Id);
 }
 
 void WindowDevice::setupWindowCovering()
 {
     if (m_endpoint == nullptr)
     {
-        ESP_LOGE(TAG, "Endpoint is null");
+        DM_LOGE(TAG, "Endpoint is null");
         return;
     }
 
     esp_matter::endpoint::window_covering_device::config_t windowCoveringConfig;
     if (esp_matter::endpoint::window_covering_device::add(m_endpoint, &windowCoveringConfig) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to add window covering configuration");
+        DM_LOGE(TAG, "Failed to add window covering configuration");
         return;
     }
 
     esp_matter::cluster_t * windowCoveringCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::WindowCovering::Id);
     if (windowCoveringCluster == nullptr)
     {
-        ESP_LOGE(TAG, "WindowCovering cluster is null");
+        DM_LOGE(TAG, "WindowCovering cluster is null");
         return;
     }
 
@@ -107,29 +123,21 @@ void WindowDevice::setupWindowCovering()
     esp_matter::cluster::window_covering::feature::position_aware_lift::add(windowCoveringCluster, &positionAwareLiftConfig);
     esp_matter::cluster::window_covering::feature::absolute_position::add(windowCoveringCluster, &absolutePositionConfig);
 
-    setDeferredPersistenceForAttributes(windowCoveringCluster);
+    resolveAttributeHandles(windowCoveringCluster);
+    setDeferredPersistenceForAttributes();
 
     // Set the initial position of the accessory
     esp_matter_attr_val_t attrVal = esp_matter_nullable_uint8(0);
-    if (esp_matter::attribute::get_val(
-            esp_matter::attribute::get(windowCoveringCluster,
-                                       chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercentage::Id),
-            &attrVal) != ESP_OK)
+    if (esp_matter::attribute::get_val(m_currentPositionPercentageAttribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to get initial position lift percentage");
+        DM_LOGE(TAG, "Failed to get initial position lift percentage");
         return;
     }
 
     esp_matter_attr_val_t targetAttrVal = esp_matter_nullable_uint16(attrVal.val.u8 * 100);
-    esp_matter::attribute::set_val(
-        esp_matter::attribute::get(windowCoveringCluster,
-                                   chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercent100ths::Id),
-        &targetAttrVal);
-    esp_matter::attribute::set_val(
-        esp_matter::attribute::get(windowCoveringCluster,
-                                   chip::app::Clusters::WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id),
-        &targetAttrVal);
-    ESP_LOGI(TAG, "Window covering setup complete, initial position: %d", attrVal.val.u8);
+    esp_matter::attribute::set_val(m_currentPosition100thsAttribute, &targetAttrVal);
+    esp_matter::attribute::set_val(m_targetPosition100thsAttribute, &targetAttrVal);
+    DM_LOGI(TAG, "Window covering setup complete, initial position: %d", attrVal.val.u8);
 }
 
 esp_err_t WindowDevice::updateAccessory(uint32_t attributeId)
@@ -139,190 +147,173 @@ esp_err_t WindowDevice::updateAccessory(uint32_t attributeId)
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "Updating accessory state");
+    esp_matter_attr_val_t attrVal = esp_matter_nullable_uint16(getAttributeUint16Value(m_targetPosition100thsAttribute));
+    return updateAccessory(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id, attributeId,
+                           &attrVal);
+}
+
+esp_err_t WindowDevice::updateAccessory(uint16_t endpointId, uint32_t clusterId, uint32_t attributeId, esp_matter_attr_val_t * val)
+{
+    static constexpr AttributeHandler<WindowDevice> handlers[] = {
+        { chip::app::Clusters::WindowCovering::Id,
+          chip::app::Clusters::WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
+          &WindowDevice::updateTargetPosition },
+    };
+    static constexpr AttributeDispatchTable<WindowDevice, 1> table(handlers);
+    static_assert(table.isValid(), "Duplicate attribute handler");
+
+    return table.dispatch(*this, endpointId, clusterId, attributeId, val);
+}
+
+esp_err_t WindowDevice::updateTargetPosition(uint16_t endpointId, esp_matter_attr_val_t * val)
+{
+    DM_LOGD(TAG, "Updating accessory state");
     if (m_accessory != nullptr)
     {
-        updateAccessoryPosition();
+        updateAccessoryPosition(val->val.u16);
     }
     else
     {
-        ESP_LOGE(TAG, "BlindAccessory is null during update");
+        DM_LOGE(TAG, "BlindAccessory is null during update");
     }
     return ESP_OK;
 }
 
-void WindowDevice::updateAccessoryPosition()
+void WindowDevice::updateAccessoryPosition(uint16_t targetPosition100ths)
 {
     if (m_accessory == nullptr)
     {
-        ESP_LOGE(TAG, "BlindAccessory is null during position update");
+        DM_LOGE(TAG, "BlindAccessory is null during position update");
         return;
     }
 
-    uint16_t targetPosition = 100 - getEndpointTargetPosition();
+    uint16_t targetPosition = 100 - targetPosition100ths / 100;
     m_accessory->moveBlindTo(targetPosition);
-    ESP_LOGD(TAG, "Moved blind to target position: %d", targetPosition);
+    DM_LOGD(TAG, "Moved blind to target position: %d", targetPosition);
 }
 
 esp_err_t WindowDevice::reportEndpoint(bool onlySave)
+{
+    return reportEndpoint(onlySave, CHANGED_ALL);
+}
+
+esp_err_t WindowDevice::reportEndpoint(bool onlySave, uint32_t changeMask)
 {
     if (m_accessory != nullptr)
     {
-        updateCurrentAndTargetPositions(onlySave);
+        updateCurrentAndTargetPositions(onlySave, changeMask);
     }
     else
     {
-        ESP_LOGE(TAG, "BlindAccessory is null during report");
+        DM_LOGE(TAG, "BlindAccessory is null during report");
     }
     return ESP_OK;
 }
 
-void WindowDevice::updateCurrentAndTargetPositions(bool onlySave)
+void WindowDevice::updateCurrentAndTargetPositions(bool onlySave, uint32_t changeMask)
 {
     if (m_accessory == nullptr)
     {
-        ESP_LOGE(TAG, "BlindAccessory is null during update of current and target positions");
+        DM_LOGE(TAG, "BlindAccessory is null during update of current and target positions");
         return;
     }
 
-    setEndpointCurrentPosition(100 - m_accessory->getCurrentPosition(), onlySave);
-    setEndpointTargetPosition(100 - m_accessory->getTargetPosition(), onlySave);
-    setEndpointOperationalStatus(m_accessory->getTargetPosition() > m_accessory->getCurrentPosition() ? 5 : 10, onlySave);
-    ESP_LOGD(TAG, "Reported endpoint target position: %d", 100 - m_accessory->getTargetPosition());
+    AttributeBatch batch(&getStats());
+    if (changeMask & CURRENT_POSITION)
+    {
+        setEndpointCurrentPosition(batch, 100 - m_accessory->getCurrentPosition());
+    }
+    if (changeMask & TARGET_POSITION)
+    {
+        setEndpointTargetPosition(batch, 100 - m_accessory->getTargetPosition());
+    }
+    if (changeMask & (CURRENT_POSITION | TARGET_POSITION))
+    {
+        // The operational status follows from both positions
+        setEndpointOperationalStatus(batch, m_accessory->getTargetPosition() > m_accessory->getCurrentPosition() ? 5 : 10);
+    }
+    if (batch.commit(onlySave) != ESP_OK)
+    {
+        DM_LOGE(TAG, "Failed to commit current and target positions");
+    }
+    DM_LOGD(TAG, "Reported endpoint target position: %d", 100 - m_accessory->getTargetPosition());
 }
 
 esp_err_t WindowDevice::identify()
 {
-    ESP_LOGI(TAG, "Identifying device");
+    DM_LOGI(TAG, "Identifying device");
     if (m_accessory != nullptr)
     {
         m_accessory->identify();
-        ESP_LOGD(TAG, "Identified accessory");
+        DM_LOGD(TAG, "Identified accessory");
     }
     else
     {
-        ESP_LOGE(TAG, "BlindAccessory is null during identify");
+        DM_LOGE(TAG, "BlindAccessory is null during identify");
     }
     return ESP_OK;
 }
 
-uint16_t WindowDevice::getEndpointTargetPosition() const
+uint32_t WindowDevice::captureState() const
 {
-    return getAttributeUint16Value(chip::app::Clusters::WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id) / 100;
+    return m_accessory != nullptr ? m_accessory->getCurrentPosition() : 0;
 }
 
-uint16_t WindowDevice::getAttributeUint16Value(uint32_t attributeId) const
+uint16_t WindowDevice::getAttributeUint16Value(esp_matter::attribute_t * attribute) const
 {
-    if (m_endpoint == nullptr)
-    {
-        ESP_LOGE(TAG, "Endpoint is null");
-        return 0;
-    }
-
-    esp_matter::cluster_t * windowCoveringCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::WindowCovering::Id);
-    if (windowCoveringCluster == nullptr)
-    {
-        ESP_LOGE(TAG, "WindowCovering cluster is null");
-        return 0;
-    }
-
-    esp_matter::attribute_t * attribute = esp_matter::attribute::get(windowCoveringCluster, attributeId);
     if (attribute == nullptr)
     {
-        ESP_LOGE(TAG, "Attribute is null");
+        DM_LOGE(TAG, "Attribute is null");
         return 0;
     }
 
     esp_matter_attr_val_t attrVal;
     if (esp_matter::attribute::get_val(attribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to get attribute value for ID %d", (int) attributeId);
+        DM_LOGE(TAG, "Failed to get attribute value for ID %d", (int) esp_matter::attribute::get_id(attribute));
         return 0;
     }
 
     return attrVal.val.u16;
 }
 
-void WindowDevice::setEndpointTargetPosition(uint16_t position, bool onlySave)
-{
-    reportAttribute(chip::app::Clusters::WindowCovering::Attributes::TargetPositionLiftPercent100ths::Id,
-                    esp_matter_nullable_uint16(position * 100), onlySave);
-}
-
-void WindowDevice::setEndpointCurrentPosition(uint16_t position, bool onlySave)
+void WindowDevice::setEndpointTargetPosition(AttributeBatch & batch, uint16_t position)
 {
-    reportAttribute(chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercent100ths::Id,
-                    esp_matter_nullable_uint16(position * 100), onlySave);
-    reportAttribute(chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercentage::Id,
-                    esp_matter_nullable_uint8(position), onlySave);
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id,
+                m_targetPosition100thsAttribute, esp_matter_nullable_uint16(position * 100));
 }
 
-void WindowDevice::setEndpointOperationalStatus(uint8_t status, bool onlySave)
+void WindowDevice::setEndpointCurrentPosition(AttributeBatch & batch, uint16_t position)
 {
-    reportAttribute(chip::app::Clusters::WindowCovering::Attributes::OperationalStatus::Id, esp_matter_bitmap8(status), onlySave);
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id,
+                m_currentPosition100thsAttribute, esp_matter_nullable_uint16(position * 100));
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id,
+                m_currentPositionPercentageAttribute, esp_matter_nullable_uint8(position));
 }
 
-void WindowDevice::reportAttribute(uint32_t attributeId, esp_matter_attr_val_t value, bool onlySave)
+void WindowDevice::setEndpointOperationalStatus(AttributeBatch & batch, uint8_t status)
 {
-    if (m_accessory == nullptr)
-    {
-        ESP_LOGE(TAG, "BlindAccessory is null during report attribute");
-        return;
-    }
-    if (onlySave)
-    {
-        if (esp_matter::lock::chip_stack_lock(portMAX_DELAY) != esp_matter::lock::status::FAILED)
-        {
-            esp_matter::attribute::set_val(
-                esp_matter::attribute::get(esp_matter::cluster::get(m_endpoint, chip::app::Clusters::WindowCovering::Id),
-                                           attributeId),
-                &value);
-            esp_matter::lock::chip_stack_unlock();
-        }
-        else
-        {
-            ESP_LOGE(TAG, "Failed to lock chip stack");
-        }
-    }
-    else
-    {
-        ESP_LOGI(TAG, "Reporting endpoint state");
-        esp_matter::attribute::report(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id,
-                                      attributeId, &value);
-    }
+    batch.stage(esp_matter::endpoint::get_id(m_endpoint), chip::app::Clusters::WindowCovering::Id, m_operationalStatusAttribute,
+                esp_matter_bitmap8(status));
 }
 
 uint8_t WindowDevice::getEndpointCurrentPosition() const
 {
-    return getAttributeUint8Value(chip::app::Clusters::WindowCovering::Attributes::CurrentPositionLiftPercentage::Id);
+    return getAttributeUint8Value(m_currentPositionPercentageAttribute);
 }
 
-uint8_t WindowDevice::getAttributeUint8Value(uint32_t attributeId) const
+uint8_t WindowDevice::getAttributeUint8Value(esp_matter::attribute_t * attribute) const
 {
-    if (m_endpoint == nullptr)
-    {
-        ESP_LOGE(TAG, "Endpoint is null");
-        return 0;
-    }
-
-    esp_matter::cluster_t * windowCoveringCluster = esp_matter::cluster::get(m_endpoint, chip::app::Clusters::WindowCovering::Id);
-    if (windowCoveringCluster == nullptr)
-    {
-        ESP_LOGE(TAG, "WindowCovering cluster is null");
-        return 0;
-    }
-
-    esp_matter::attribute_t * attribute = esp_matter::attribute::get(windowCoveringCluster, attributeId);
     if (attribute == nullptr)
     {
-        ESP_LOGE(TAG, "Attribute is null");
+        DM_LOGE(TAG, "Attribute is null");
         return 0;
     }
 
     esp_matter_attr_val_t attrVal;
     if (esp_matter::attribute::get_val(attribute, &attrVal) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to get attribute value for ID %d", (int) attributeId);
+        DM_LOGE(TAG, "Failed to get attribute value for ID %d", (int) esp_matter::attribute::get_id(attribute));
         return 0;
     }
 
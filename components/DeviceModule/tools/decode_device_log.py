@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Decodes the tokenized log ring of the DeviceModule.
+
+With CONFIG_D_M_LOG_TOKENIZED the module stores info, debug and verbose messages as a hash of
+"<source file name>:<format string>" and up to four 32-bit arguments. `matter device log` prints them
+as lines of the form
+
+    DMLOG <timestamp us> <level> <token> [<argument> ...]
+
+with token and arguments in hex. This script rebuilds the token table from the DM_LOGx calls of the
+sources the firmware was built from and prints the messages as text.
+
+Usage: decode_device_log.py [--source DIR ...] [LOG_FILE]
+
+Sources default to the src and include directories of the component.
+
+LOG_FILE is a console capture, - or nothing for stdin; lines without DMLOG are ignored.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+LEVEL_LETTERS = {1: "E", 2: "W", 3: "I", 4: "D", 5: "V"}
+
+LOG_CALL = re.compile(r'\bDM_LOG[EWIDV]\s*\(\s*[^,]+,\s*((?:"(?:\\.|[^"\\])*"\s*)+)')
+STRING_LITERAL = re.compile(r'"((?:\\.|[^"\\])*)"')
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "\\": "\\", '"': '"', "'": "'", "0": "\0"}
+
+
+def fnv1a(data, value=2166136261):
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    return re.sub(r"\\(.)", lambda match: ESCAPES.get(match.group(1), match.group(1)), literal)
+
+
+def token_table(source_dirs):
+    """Maps every token to (file name, format string)."""
+    table = {}
+    for source_dir in source_dirs:
+        for root, _, files in os.walk(source_dir):
+            for name in files:
+                if not name.endswith((".c", ".cpp", ".h", ".hpp")):
+                    continue
+                with open(os.path.join(root, name), encoding="utf-8", errors="replace") as source:
+                    text = source.read()
+                for call in LOG_CALL.finditer(text):
+                    log_format = "".join(unescape(part) for part in STRING_LITERAL.findall(call.group(1)))
+                    token = fnv1a(log_format.encode(), fnv1a((name + ":").encode()))
+                    table[token] = (name, log_format)
+    return table
+
+
+def format_message(log_format, args):
+    """Applies 32-bit arguments to a printf format string."""
+    remaining = list(args)
+
+    def convert(match):
+        flags, width, precision, kind = match.groups()
+        if kind == "%":
+            return "%"
+        if not remaining:
+            return match.group(0)
+        value = remaining.pop(0)
+        if kind in "di":
+            value = value - (1 << 32) if value & 0x80000000 else value
+            kind = "d"
+        elif kind == "s":
+            return "<string 0x%08x>" % value
+        elif kind == "p":
+            return "0x%08x" % value
+        spec = "%" + flags + width + ("." + precision if precision else "") + kind
+        return spec % (chr(value & 0xFF) if kind == "c" else value)
+
+    return CONVERSION.sub(convert, log_format)
+
+
+def main():
+    component_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+    default_sources = [os.path.join(component_dir, "src"), os.path.join(component_dir, "include")]
+    parser = argparse.ArgumentParser(description="Decode DeviceModule tokenized log lines.")
+    parser.add_argument("--source", action="append", help="source directory of the firmware, repeatable")
+    parser.add_argument("log", nargs="?", default="-", help="console capture, - for stdin")
+    options = parser.parse_args()
+
+    table = token_table(options.source or default_sources)
+    stream = sys.stdin if options.log == "-" else open(options.log, encoding="utf-8", errors="replace")
+    for line in stream:
+        fields = line[line.find("DMLOG "):].split() if "DMLOG " in line else []
+        if len(fields) < 4:
+            continue
+        timestamp, level, token = int(fields[1]), int(fields[2]), int(fields[3], 16)
+        args = [int(field, 16) for field in fields[4:]]
+        letter = LEVEL_LETTERS.get(level, "?")
+        if token not in table:
+            print("%s (%d) <unknown token %08x> %s" % (letter, timestamp // 1000, token, " ".join(fields[4:])))
+            continue
+        name, log_format = table[token]
+        print("%s (%d) %s: %s" % (letter, timestamp // 1000, name, format_message(log_format, args)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
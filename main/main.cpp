@@ -3,13 +3,36 @@
 #include <esp_err.h>
 #include <esp_log.h>
 #include <esp_matter.h>
+#include <esp_timer.h>
 #include <nvs_flash.h>
+#include <sdkconfig.h>
+
+#if CONFIG_ENABLE_CHIP_SHELL
+#include <esp_matter_console.h>
+#endif
 
 #include <ButtonModule.hpp>
 #include <RelayModule.hpp>
 
+#include "ActuationExecutor.hpp"
+#include "BootProfiler.hpp"
+#include "DeviceRegistry.hpp"
+#include "DeviceShell.hpp"
+#include "DeviceSnapshot.hpp"
+#include "ObjectPool.hpp"
+#include "ReportDispatcher.hpp"
 #include "TVLifterAccessory.hpp"
-#include "TVLifterDevice.hpp"
+
+/* Accessories and devices live in static pools, so their RAM is reserved at link time instead of on the heap */
+static ObjectPool<ButtonModule, 3> s_buttonModules;
+static ObjectPool<RelayModule, 3> s_relayModules;
+static ObjectPool<TVLifterAccessory, 1> s_tvLifterAccessories;
+
+/* Runs accessory actuation off the Matter task */
+static ActuationExecutor s_actuationExecutor;
+
+/* Reports accessory changes to Matter from one task, so accessory tasks never wait for the chip stack lock */
+static ReportDispatcher s_reportDispatcher;
 
 esp_err_t app_identification_cb(esp_matter::identification::callback_type type, uint16_t endpoint_id, uint8_t effect_id,
                                 uint8_t effect_variant, void * priv_data)
@@ -38,9 +61,17 @@ esp_err_t app_attribute_cb(esp_matter::attribute::callback_type type, uint16_t e
             BaseDeviceInterface * device = static_cast<BaseDeviceInterface *>(priv_data);
             if (device != nullptr)
             {
-                // log
-                ESP_LOGI(__FILENAME__, "app_attribute_cb app_attribute_cb app_attribute_cb");
-                device->updateAccessory(attribute_id, endpoint_id);
+                // Hand the write to the actuation task; run it here whenever it is not queued, so no write is lost
+                esp_err_t err = s_actuationExecutor.submit(device, endpoint_id, cluster_id, attribute_id, val);
+                if (err != ESP_OK)
+                {
+                    if (err == ESP_ERR_NO_MEM)
+                    {
+                        device->getStats().recordActuationOverflow();
+                    }
+                    device->getStats().markCommand(DeviceStats::now());
+                    device->updateAccessory(endpoint_id, cluster_id, attribute_id, val);
+                }
             }
         }
         return ESP_OK;
@@ -52,6 +83,13 @@ void app_event_cb(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg
 {
     switch (event->Type)
     {
+    case chip::DeviceLayer::DeviceEventType::kServerReady:
+        BootProfiler::mark(BootProfiler::SERVER_READY);
+        BootProfiler::print();
+        break;
+    case chip::DeviceLayer::DeviceEventType::kCommissioningWindowOpened:
+        BootProfiler::mark(BootProfiler::COMMISSIONABLE);
+        break;
     case chip::DeviceLayer::DeviceEventType::kFabricRemoved: {
         ESP_LOGW(__FILENAME__, "Fabric removed successfully");
         ESP_LOGW(__FILENAME__, "---------------------------------");
@@ -78,6 +116,14 @@ void app_event_cb(const chip::DeviceLayer::ChipDeviceEvent * event, intptr_t arg
     }
 }
 
+#if CONFIG_D_M_BOOT_SNAPSHOT
+/* Runs on the esp_timer task; writes the snapshot blob only when a device state changed */
+static void snapshotTimerCallback(void * arg)
+{
+    static_cast<DeviceRegistry *>(arg)->saveSnapshot();
+}
+#endif
+
 uint8_t GetButtonPin(uint8_t pin)
 {
     // uint8_t buttonPins[] = {14, 27, 26, 25, 33, 32, 35, 34};
@@ -93,32 +139,82 @@ uint8_t GetRelayPin(uint8_t pin)
 
 extern "C" void app_main()
 {
+    BootProfiler::begin();
+    BootProfiler::mark(BootProfiler::APP_START);
+
     /* Initialize NVS */
     nvs_flash_init();
+    BootProfiler::mark(BootProfiler::NVS_INIT);
+
+    ButtonModule * buttonUp   = s_buttonModules.create(GetButtonPin(1));
+    ButtonModule * buttonDown = s_buttonModules.create(GetButtonPin(2));
+    ButtonModule * buttonStop = s_buttonModules.create(GetButtonPin(3));
+
+    RelayModule * relayUp   = s_relayModules.create(GetRelayPin(1));
+    RelayModule * relayDown = s_relayModules.create(GetRelayPin(2));
+    RelayModule * relayStop = s_relayModules.create(GetRelayPin(3));
+
+    /* Initialize the TVLifterAccessory */
+    TVLifterAccessory * accessory =
+        s_tvLifterAccessories.create(relayUp, relayDown, relayStop, buttonUp, buttonDown, buttonStop);
 
-    ButtonModule * buttonUp   = new ButtonModule(GetButtonPin(1));
-    ButtonModule * buttonDown = new ButtonModule(GetButtonPin(2));
-    ButtonModule * buttonStop = new ButtonModule(GetButtonPin(3));
+    /* Every bridged device, created in one pass once the Matter stack is started */
+    const DeviceDescriptor devices[] = {
+        { 1, DeviceType::TV_LIFTER, "TV Lifter", accessory, nullptr, 0 },
+    };
+    const size_t deviceCount = sizeof(devices) / sizeof(devices[0]);
 
-    RelayModule * relayUp   = new RelayModule(GetRelayPin(1));
-    RelayModule * relayDown = new RelayModule(GetRelayPin(2));
-    RelayModule * relayStop = new RelayModule(GetRelayPin(3));
+#if CONFIG_D_M_BOOT_SNAPSHOT
+    /* Put the accessories back in their last state before the data model is built; the devices confirm it */
+    DeviceSnapshot::restore(devices, deviceCount);
+    BootProfiler::mark(BootProfiler::SNAPSHOT_RESTORED);
+#endif
 
     /* Initialize the Matter stack */
     esp_matter::node::config_t node_config;
     esp_matter::node_t * node = esp_matter::node::create(&node_config, app_attribute_cb, app_identification_cb);
+    BootProfiler::mark(BootProfiler::NODE_CREATED);
 
     // /* Initialize the Aggregator */
     esp_matter::endpoint::aggregator::config_t aggregator_config;
     esp_matter::endpoint_t * aggregator1 =
         esp_matter::endpoint::aggregator::create(node, &aggregator_config, esp_matter::endpoint_flags::ENDPOINT_FLAG_NONE,
         nullptr);
+    BootProfiler::mark(BootProfiler::AGGREGATOR_CREATED);
 
-    /* Initialize the TVLifterDevice */
-    TVLifterAccessory * accessory = new TVLifterAccessory(relayUp, relayDown, relayStop, buttonUp, buttonDown, buttonStop);
+    // start the actuation task, then the Matter stack
+    s_actuationExecutor.start();
+    esp_matter::start(app_event_cb);
+    BootProfiler::mark(BootProfiler::MATTER_STARTED);
 
-    TVLifterDevice * device = new TVLifterDevice("TV Lifter", accessory, aggregator1);
+    /* Created on the started stack, which has loaded the endpoint ids the devices are resumed with */
+    static DeviceRegistry registry(aggregator1);
+    s_reportDispatcher.start();
+    registry.setReportDispatcher(&s_reportDispatcher);
+    registry.setActuationExecutor(&s_actuationExecutor);
+    registry.createDevices(devices, deviceCount);
+    BootProfiler::mark(BootProfiler::DEVICES_CREATED);
+    registry.logPoolUsage();
+    ESP_LOGI(__FILENAME__, "Devices created %lld us after boot, snapshot restored at %lld us", esp_timer_get_time(),
+             DeviceSnapshot::restoredAtUs());
 
-    // start the Matter stack
-    esp_matter::start(app_event_cb);
+#if CONFIG_D_M_BOOT_SNAPSHOT
+    const esp_timer_create_args_t snapshotTimerArgs = {
+        .callback = &snapshotTimerCallback,
+        .arg      = &registry,
+        .name     = "dm_snapshot",
+    };
+    esp_timer_handle_t snapshotTimer = nullptr;
+    if (esp_timer_create(&snapshotTimerArgs, &snapshotTimer) == ESP_OK)
+    {
+        esp_timer_start_periodic(snapshotTimer, CONFIG_D_M_SNAPSHOT_SAVE_INTERVAL_MS * 1000ULL);
+    }
+#endif
+
+#if CONFIG_ENABLE_CHIP_SHELL
+    /* `matter device stats`, `lock-stats` and `reset-stats` */
+    DeviceShell::registerCommands(&registry);
+    esp_matter::console::diagnostics_register_commands();
+    esp_matter::console::init();
+#endif
 }
\ No newline at end of file